@@ -0,0 +1,418 @@
+/**
+  ******************************************************************************
+  * @file    adc_alarm.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides threshold and alarm detection on ADC blocks:
+  *           - High / low limits with hysteresis
+  *           - Rate of change limits
+  *           - Alarm callbacks from the block that crossed the limit
+  *           - IIO hardware threshold events
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Alarm Engine
+  *          ===================================================================
+  *
+  *          Software Limits
+  *          =====================
+  *          - Every sample of every block is compared, not one value per
+  *            poll interval: a spike between two polls is not missed
+  *          - HIGH is raised above the high limit and cleared below
+  *            high - hysteresis; LOW is raised below the low limit and
+  *            cleared above low + hysteresis, so a noisy value near a limit
+  *            does not chatter
+  *          - RATE compares |x[n] - x[n-1]| * sample rate with the limit and
+  *            is cleared once the change is back under it
+  *          - Raise and clear are both reported through the callback, with
+  *            the timestamp of the sample that caused them
+  *
+  *          Latency
+  *          =======================
+  *          - ADCAlarmCheck() runs on each block right after it is read, so
+  *            the alarm latency is at most one block period plus the
+  *            callback time; pick the block size (buffer watermark) for the
+  *            latency the interlock needs
+  *          - Without IIO timestamps the last scan of a block is taken as
+  *            "now" and earlier scans are spaced by the sample period
+  *
+  *          Hardware Events
+  *          =======================
+  *          - ADCs with window comparators expose
+  *            events/in_voltageN_thresh_{rising,falling}_{value,en}
+  *          - ADCAlarmHwThreshold() programs one in raw counts,
+  *            ADCAlarmEventsOpen() gets the IIO event fd, and
+  *            ADCAlarmEventsRead() turns pending events into callbacks
+  *          - The event fd can be polled next to the buffer fd; hardware
+  *            events only report raising, not clearing
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "adc_alarm.h" in your application
+  *            - Init with the scan channels and sample rate, set limits
+  *            - Call ADCAlarmCheck() on every converted (and filtered) block
+  *            - Compile with: gcc -O2 iio_adc.c iio_buffer.c adc_convert.c
+  *                            adc_dsp.c adc_alarm.c your_app.c -lm
+  *
+  *          Example Usage:
+  *            static void interlock(const ADC_AlarmEvent *ev, void *arg)
+  *            {
+  *                if (ev->active && ADC_ALARM_HIGH == ev->type)
+  *                    GPIOWrite(1, 4, LOW);   // cut the heater
+  *            }
+  *
+  *            ADC_Alarm alarm;
+  *            int ch[2] = { 0, 3 };
+  *            ADCAlarmInit(&alarm, ch, 2, 10000, interlock, NULL);
+  *            ADCAlarmSetHigh(&alarm, 0, 2800.0f, 50.0f);   // mV
+  *            ADCAlarmSetRate(&alarm, 1, 1000.0f);         // mV/s
+  *
+  *            n = IIOBufferRead(adc, raw, ts, 64, -1);
+  *            ADCConvert(&conv, raw, mv, n * 2);
+  *            ADCAlarmCheck(&alarm, mv, n, ts);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/iio/events.h>
+#include <linux/iio/types.h>
+#include "adc_alarm.h"
+
+#define EVENTS_MAX	16
+
+static int64_t
+ADCAlarmNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+/**
+  * @brief  Sets up an alarm engine.
+  * @param  a: alarm state
+  * @param  channels: N of in_voltageN of each scan position, NULL = position
+  * @param  num: channels per scan
+  * @param  sample_rate: scans per second, for rate limits and timestamps
+  * @param  callback: called on every raise and clear
+  * @retval 0 on success, -1 on invalid arguments
+  */
+int
+ADCAlarmInit(ADC_Alarm *a, const int *channels, int num, double sample_rate,
+	     ADC_AlarmCallback callback, void *arg)
+{
+	int i;
+
+	if (num < 1 || num > ADC_DSP_CHANNELS || sample_rate <= 0 || NULL == callback) {
+		fprintf(stderr, "Invalid alarm setup!\n");
+		return(-1);
+	}
+
+	memset(a, 0, sizeof(*a));
+	a->num_channels = num;
+	a->sample_rate = sample_rate;
+	a->period_ns = (int64_t)(1e9 / sample_rate);
+	a->callback = callback;
+	a->arg = arg;
+	a->event_fd = -1;
+	for (i = 0; i < num; i++)
+		a->channel[i] = channels ? channels[i] : i;
+
+	return(0);
+}
+
+static ADC_AlarmLimits *
+ADCAlarmLimits(ADC_Alarm *a, int slot)
+{
+	if (slot < 0 || slot >= a->num_channels) {
+		fprintf(stderr, "Invalid alarm channel %d!\n", slot);
+		return(NULL);
+	}
+
+	return(&a->limits[slot]);
+}
+
+int
+ADCAlarmSetHigh(ADC_Alarm *a, int slot, float level, float hysteresis)
+{
+	ADC_AlarmLimits *l = ADCAlarmLimits(a, slot);
+
+	if (NULL == l)
+		return(-1);
+
+	l->high = level;
+	l->high_clear = level - fabsf(hysteresis);
+	l->enabled |= ADC_ALARM_HIGH;
+	return(0);
+}
+
+int
+ADCAlarmSetLow(ADC_Alarm *a, int slot, float level, float hysteresis)
+{
+	ADC_AlarmLimits *l = ADCAlarmLimits(a, slot);
+
+	if (NULL == l)
+		return(-1);
+
+	l->low = level;
+	l->low_clear = level + fabsf(hysteresis);
+	l->enabled |= ADC_ALARM_LOW;
+	return(0);
+}
+
+/**
+  * @brief  Limits the change per second; 0 disables the limit.
+  */
+int
+ADCAlarmSetRate(ADC_Alarm *a, int slot, float per_second)
+{
+	ADC_AlarmLimits *l = ADCAlarmLimits(a, slot);
+
+	if (NULL == l)
+		return(-1);
+
+	l->rate = fabsf(per_second);
+	if (per_second != 0.0f)
+		l->enabled |= ADC_ALARM_RATE;
+	else
+		l->enabled &= ~ADC_ALARM_RATE;
+	return(0);
+}
+
+static void
+ADCAlarmRaise(ADC_Alarm *a, int slot, int type, int active, float value, int64_t ts)
+{
+	ADC_AlarmEvent ev;
+
+	if (active)
+		a->active[slot] |= type;
+	else
+		a->active[slot] &= ~type;
+
+	ev.slot = slot;
+	ev.channel = a->channel[slot];
+	ev.type = type;
+	ev.active = active;
+	ev.value = value;
+	ev.timestamp_ns = ts;
+	ev.hardware = 0;
+	a->events++;
+	a->callback(&ev, a->arg);
+}
+
+/**
+  * @brief  Checks every sample of a block against the limits.
+  * @param  a: alarm state
+  * @param  buf: interleaved samples, num_channels per scan
+  * @param  scans: number of scans
+  * @param  timestamps: per-scan timestamps, NULL to derive them from now
+  * @retval Number of raise / clear events reported
+  */
+int
+ADCAlarmCheck(ADC_Alarm *a, const float *buf, int scans, const int64_t *timestamps)
+{
+	const ADC_AlarmLimits *l;
+	uint64_t before = a->events;
+	int num = a->num_channels;
+	int64_t last = 0;
+	int64_t ts;
+	float rate;
+	float x;
+	int act;
+	int i;
+	int c;
+
+	if (NULL == timestamps && scans > 0)
+		last = ADCAlarmNow();
+
+	for (i = 0; i < scans; i++) {
+		for (c = 0; c < num; c++) {
+			l = &a->limits[c];
+			if (0 == l->enabled)
+				continue;
+
+			x = buf[i * num + c];
+			act = a->active[c];
+			ts = timestamps ? timestamps[i] : last - (int64_t)(scans - 1 - i) * a->period_ns;
+
+			if (l->enabled & ADC_ALARM_HIGH) {
+				if (!(act & ADC_ALARM_HIGH) && x > l->high)
+					ADCAlarmRaise(a, c, ADC_ALARM_HIGH, 1, x, ts);
+				else if ((act & ADC_ALARM_HIGH) && x < l->high_clear)
+					ADCAlarmRaise(a, c, ADC_ALARM_HIGH, 0, x, ts);
+			}
+
+			if (l->enabled & ADC_ALARM_LOW) {
+				if (!(act & ADC_ALARM_LOW) && x < l->low)
+					ADCAlarmRaise(a, c, ADC_ALARM_LOW, 1, x, ts);
+				else if ((act & ADC_ALARM_LOW) && x > l->low_clear)
+					ADCAlarmRaise(a, c, ADC_ALARM_LOW, 0, x, ts);
+			}
+
+			if ((l->enabled & ADC_ALARM_RATE) && a->have_prev) {
+				rate = fabsf(x - a->prev[c]) * (float)a->sample_rate;
+				if (!(act & ADC_ALARM_RATE) && rate > l->rate)
+					ADCAlarmRaise(a, c, ADC_ALARM_RATE, 1, rate, ts);
+				else if ((act & ADC_ALARM_RATE) && rate <= l->rate)
+					ADCAlarmRaise(a, c, ADC_ALARM_RATE, 0, rate, ts);
+			}
+		}
+
+		memcpy(a->prev, &buf[i * num], num * sizeof(float));
+		a->have_prev = 1;
+	}
+
+	return((int)(a->events - before));
+}
+
+/**
+  * @brief  Gets the IIO event fd of a device.
+  * @param  a: alarm state
+  * @param  device: N of iio:deviceN
+  * @param  dev_fd: the open /dev/iio:deviceN (e.g. IIO_Buffer fd), -1 to
+  *         open it here; the node allows one opener at a time
+  * @retval Event fd for poll(), -1 on error
+  */
+int
+ADCAlarmEventsOpen(ADC_Alarm *a, int device, int dev_fd)
+{
+	char path[IIO_PATH_MAX];
+	int fd = dev_fd;
+	int ret;
+
+	if (-1 == fd) {
+		if (IIODeviceNode(path, device))
+			return(-1);
+		fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (-1 == fd) {
+			fprintf(stderr, "Failed to open %s for reading!\n", path);
+			return(-1);
+		}
+	}
+
+	ret = ioctl(fd, IIO_GET_EVENT_FD_IOCTL, &a->event_fd);
+	if (-1 == dev_fd)
+		close(fd);
+	if (-1 == ret) {
+		fprintf(stderr, "Failed to get iio:device%d event fd!\n", device);
+		a->event_fd = -1;
+		return(-1);
+	}
+
+	fcntl(a->event_fd, F_SETFL, fcntl(a->event_fd, F_GETFL) | O_NONBLOCK);
+	return(a->event_fd);
+}
+
+/**
+  * @brief  Programs and enables a hardware threshold.
+  * @param  device: N of iio:deviceN
+  * @param  channel: N of in_voltageN
+  * @param  type: ADC_ALARM_HIGH (rising) or ADC_ALARM_LOW (falling)
+  * @param  raw: threshold in raw counts
+  * @param  hysteresis: raw counts, 0 leaves the driver default
+  * @retval 0 on success, -1 if the driver has no such event
+  */
+int
+ADCAlarmHwThreshold(int device, int channel, int type, int raw, int hysteresis)
+{
+	const char *dir = (ADC_ALARM_LOW == type) ? "falling" : "rising";
+	char path[IIO_PATH_MAX];
+
+	if (IIODevicePath(path, device, "events/in_voltage%d_thresh_%s_value", channel, dir) ||
+	    IIOWriteInt(path, raw))
+		return(-1);
+
+	if (hysteresis > 0 &&
+	    0 == IIODevicePath(path, device, "events/in_voltage%d_thresh_%s_hysteresis", channel, dir) &&
+	    0 == access(path, W_OK))
+		IIOWriteInt(path, hysteresis);
+
+	if (IIODevicePath(path, device, "events/in_voltage%d_thresh_%s_en", channel, dir) ||
+	    IIOWriteInt(path, 1))
+		return(-1);
+
+	return(0);
+}
+
+/**
+  * @brief  Reports pending hardware events through the callback.
+  * @retval Number of events reported, -1 on error
+  */
+int
+ADCAlarmEventsRead(ADC_Alarm *a)
+{
+	struct iio_event_data ev[EVENTS_MAX];
+	ADC_AlarmEvent alarm;
+	int reported = 0;
+	ssize_t len;
+	int chan;
+	int i;
+	int j;
+
+	if (-1 == a->event_fd)
+		return(-1);
+
+	while (1) {
+		len = read(a->event_fd, ev, sizeof(ev));
+		if (-1 == len) {
+			if (EINTR == errno)
+				continue;
+			if (EAGAIN == errno)
+				break;
+			fprintf(stderr, "Failed to read IIO events!\n");
+			return(-1);
+		}
+
+		for (i = 0; i < (int)(len / sizeof(ev[0])); i++) {
+			if (IIO_EV_TYPE_THRESH != IIO_EVENT_CODE_EXTRACT_TYPE(ev[i].id))
+				continue;
+
+			chan = IIO_EVENT_CODE_EXTRACT_CHAN(ev[i].id);
+			memset(&alarm, 0, sizeof(alarm));
+			alarm.slot = -1;
+			for (j = 0; j < a->num_channels; j++) {
+				if (chan == a->channel[j])
+					alarm.slot = j;
+			}
+			alarm.channel = chan;
+			alarm.type = (IIO_EV_DIR_FALLING == IIO_EVENT_CODE_EXTRACT_DIR(ev[i].id)) ?
+				     ADC_ALARM_LOW : ADC_ALARM_HIGH;
+			alarm.active = 1;
+			alarm.value = NAN;
+			alarm.timestamp_ns = ev[i].timestamp;
+			alarm.hardware = 1;
+			a->events++;
+			reported++;
+			a->callback(&alarm, a->arg);
+		}
+	}
+
+	return(reported);
+}
+
+void
+ADCAlarmClose(ADC_Alarm *a)
+{
+	if (-1 != a->event_fd)
+		close(a->event_fd);
+	a->event_fd = -1;
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
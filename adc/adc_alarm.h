@@ -0,0 +1,81 @@
+/**
+  ******************************************************************************
+  * @file    adc_alarm.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the ADC
+  *          threshold and alarm engine.
+  *
+  * @details Provides the following functionality:
+  *          - Over / under range alarms with hysteresis
+  *          - Rate of change limits
+  *          - Evaluation of every sample of a block
+  *          - Hardware threshold events of IIO drivers
+  ******************************************************************************
+  * @defgroup ADC_Alarm ADC Alarms
+  * @brief Per-channel limits and alarm state
+  * @{
+  */
+
+#ifndef __ADC_ALARM_H
+#define __ADC_ALARM_H
+
+#include <stdint.h>
+#include "adc_dsp.h"
+
+#define ADC_ALARM_HIGH		0x01	/* value above the high limit */
+#define ADC_ALARM_LOW		0x02	/* value below the low limit */
+#define ADC_ALARM_RATE		0x04	/* change per second above the rate limit */
+
+typedef struct {
+	int slot;		/* position in the scan, -1 for unknown hardware events */
+	int channel;		/* N of in_voltageN */
+	int type;		/* ADC_ALARM_* */
+	int active;		/* 1 raised, 0 cleared */
+	float value;		/* sample or rate that changed the state */
+	int64_t timestamp_ns;	/* CLOCK_MONOTONIC or the IIO timestamp clock */
+	int hardware;		/* 1 if reported by the driver */
+} ADC_AlarmEvent;
+
+typedef void (*ADC_AlarmCallback)(const ADC_AlarmEvent *event, void *arg);
+
+typedef struct {
+	int enabled;		/* ADC_ALARM_* mask */
+	float high;
+	float high_clear;	/* high - hysteresis */
+	float low;
+	float low_clear;	/* low + hysteresis */
+	float rate;		/* per second */
+} ADC_AlarmLimits;
+
+typedef struct {
+	int num_channels;
+	int channel[ADC_DSP_CHANNELS];
+	double sample_rate;	/* scans per second */
+	int64_t period_ns;
+	ADC_AlarmLimits limits[ADC_DSP_CHANNELS];
+	int active[ADC_DSP_CHANNELS];	/* ADC_ALARM_* mask */
+	float prev[ADC_DSP_CHANNELS];
+	int have_prev;
+	uint64_t events;
+	ADC_AlarmCallback callback;
+	void *arg;
+	int event_fd;		/* IIO event fd, -1 if unused */
+} ADC_Alarm;
+
+/** @} */
+
+extern int ADCAlarmInit(ADC_Alarm *a, const int *channels, int num, double sample_rate,
+			ADC_AlarmCallback callback, void *arg);
+extern int ADCAlarmSetHigh(ADC_Alarm *a, int slot, float level, float hysteresis);
+extern int ADCAlarmSetLow(ADC_Alarm *a, int slot, float level, float hysteresis);
+extern int ADCAlarmSetRate(ADC_Alarm *a, int slot, float per_second);
+extern int ADCAlarmCheck(ADC_Alarm *a, const float *buf, int scans, const int64_t *timestamps);
+extern int ADCAlarmEventsOpen(ADC_Alarm *a, int device, int dev_fd);
+extern int ADCAlarmHwThreshold(int device, int channel, int type, int raw, int hysteresis);
+extern int ADCAlarmEventsRead(ADC_Alarm *a);
+extern void ADCAlarmClose(ADC_Alarm *a);
+
+
+#endif /*__ADC_ALARM_H */
@@ -0,0 +1,305 @@
+/**
+  ******************************************************************************
+  * @file    adc_convert.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides block conversion of raw ADC counts to millivolts:
+  *           - Scale and offset read once per channel from IIO
+  *           - Interleaved multichannel blocks from scans or buffered capture
+  *           - SSE / AVX kernels on x86, NEON on ARM, scalar fallback
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Conversion
+  *          ===================================================================
+  *
+  *          Scaling
+  *          =====================
+  *          - IIO defines a voltage as (raw + offset) * scale millivolts
+  *          - scale and offset come from in_voltageN_scale/_offset or the
+  *            shared in_voltage_scale/_offset, read once at init
+  *
+  *          Interleaved Blocks
+  *          =======================
+  *          - Sample k of a block belongs to channel k % num_channels, the
+  *            layout of IIOBufferRead() and ADC_Scan()
+  *          - Scale and offset are laid out once as a repeating pattern of
+  *            num_channels * 8 floats, so every vector lane finds its own
+  *            factor at the same position on every pass, whatever the
+  *            channel count
+  *          - Per 4 (SSE, NEON) or 8 (AVX) samples: convert int32 to float,
+  *            add offset, multiply by scale, store
+  *          - The rest of the block is done in scalar code
+  *
+  *          Kernel Selection
+  *          =======================
+  *          - x86: AVX if the CPU has it, else SSE2, checked at run time
+  *          - ARM: NEON if the compiler targets it (always on AArch64, with
+  *            -mfpu=neon-vfpv4 on the Cortex-A7 parts)
+  *          - Anything else: scalar loop
+  *          - Results are identical in all kernels (float mul/add, no FMA)
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "adc_convert.h" in your application
+  *            - Init once from the capture buffer, the device channels or
+  *              explicit factors
+  *            - Call ADCConvert() on each block
+  *            - Compile with: gcc -O2 iio_adc.c iio_buffer.c adc_convert.c your_app.c
+  *              (Cortex-A7: add -mfpu=neon-vfpv4 -mfloat-abi=hard)
+  *
+  *          Example Usage:
+  *            ADC_Convert conv;
+  *            int32_t raw[256 * 4];
+  *            float mv[256 * 4];
+  *
+  *            ADCConvertInitBuffer(&conv, adc);
+  *            n = IIOBufferRead(adc, raw, NULL, 256, -1);
+  *            ADCConvert(&conv, raw, mv, n * 4);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <string.h>
+#include "adc_convert.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ADC_CONVERT_X86
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+typedef void (*ADC_ConvertKernel)(const ADC_Convert *conv, const int32_t *raw,
+				  float *mv, int count);
+
+static ADC_ConvertKernel s_kernel;
+static const char *s_kernel_name = "none";
+
+/* converts raw[start..count), start being a multiple of the pattern period */
+static void
+ADCConvertScalar(const ADC_Convert *conv, const int32_t *raw, float *mv,
+		 int start, int count)
+{
+	int j = 0;
+	int i;
+
+	for (i = start; i < count; i++) {
+		mv[i] = ((float)raw[i] + conv->offset[j]) * conv->scale[j];
+		if (++j == conv->period)
+			j = 0;
+	}
+}
+
+static void
+ADCConvertC(const ADC_Convert *conv, const int32_t *raw, float *mv, int count)
+{
+	ADCConvertScalar(conv, raw, mv, 0, count);
+}
+
+#ifdef ADC_CONVERT_X86
+__attribute__((target("sse2")))
+static void
+ADCConvertSSE(const ADC_Convert *conv, const int32_t *raw, float *mv, int count)
+{
+	int period = conv->period;
+	__m128 v;
+	int i;
+	int j;
+
+	for (i = 0; i + period <= count; i += period) {
+		for (j = 0; j < period; j += 4) {
+			v = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(raw + i + j)));
+			v = _mm_add_ps(v, _mm_loadu_ps(conv->offset + j));
+			v = _mm_mul_ps(v, _mm_loadu_ps(conv->scale + j));
+			_mm_storeu_ps(mv + i + j, v);
+		}
+	}
+
+	ADCConvertScalar(conv, raw, mv, i, count);
+}
+
+__attribute__((target("avx")))
+static void
+ADCConvertAVX(const ADC_Convert *conv, const int32_t *raw, float *mv, int count)
+{
+	int period = conv->period;
+	__m256 v;
+	int i;
+	int j;
+
+	for (i = 0; i + period <= count; i += period) {
+		for (j = 0; j < period; j += 8) {
+			v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(raw + i + j)));
+			v = _mm256_add_ps(v, _mm256_loadu_ps(conv->offset + j));
+			v = _mm256_mul_ps(v, _mm256_loadu_ps(conv->scale + j));
+			_mm256_storeu_ps(mv + i + j, v);
+		}
+	}
+
+	ADCConvertScalar(conv, raw, mv, i, count);
+}
+#endif
+
+#ifdef __ARM_NEON
+static void
+ADCConvertNEON(const ADC_Convert *conv, const int32_t *raw, float *mv, int count)
+{
+	int period = conv->period;
+	float32x4_t v;
+	int i;
+	int j;
+
+	for (i = 0; i + period <= count; i += period) {
+		for (j = 0; j < period; j += 4) {
+			v = vcvtq_f32_s32(vld1q_s32(raw + i + j));
+			v = vaddq_f32(v, vld1q_f32(conv->offset + j));
+			v = vmulq_f32(v, vld1q_f32(conv->scale + j));
+			vst1q_f32(mv + i + j, v);
+		}
+	}
+
+	ADCConvertScalar(conv, raw, mv, i, count);
+}
+#endif
+
+static void
+ADCConvertSelect(void)
+{
+	if (NULL != s_kernel)
+		return;
+
+#ifdef ADC_CONVERT_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx")) {
+		s_kernel_name = "avx";
+		s_kernel = ADCConvertAVX;
+		return;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		s_kernel_name = "sse2";
+		s_kernel = ADCConvertSSE;
+		return;
+	}
+#elif defined(__ARM_NEON)
+	s_kernel_name = "neon";
+	s_kernel = ADCConvertNEON;
+	return;
+#endif
+
+	s_kernel_name = "scalar";
+	s_kernel = ADCConvertC;
+}
+
+/**
+  * @brief  Sets up the conversion from explicit factors.
+  * @param  conv: conversion state
+  * @param  num: channels per scan
+  * @param  scale: mV per count of each channel
+  * @param  offset: counts added before scaling, NULL for none
+  * @retval 0 on success, -1 on invalid arguments
+  */
+int
+ADCConvertInit(ADC_Convert *conv, int num, const double *scale, const double *offset)
+{
+	int i;
+
+	if (NULL == conv || NULL == scale || num < 1 || num > ADC_CONVERT_MAX) {
+		fprintf(stderr, "Invalid ADC conversion setup!\n");
+		return(-1);
+	}
+
+	memset(conv, 0, sizeof(*conv));
+	conv->num_channels = num;
+	conv->period = num * ADC_CONVERT_LANES;
+	for (i = 0; i < conv->period; i++) {
+		conv->scale[i] = (float)scale[i % num];
+		conv->offset[i] = offset ? (float)offset[i % num] : 0.0f;
+	}
+
+	ADCConvertSelect();
+	return(0);
+}
+
+/**
+  * @brief  Sets up the conversion from the IIO attributes of the channels.
+  * @param  conv: conversion state
+  * @param  device: N of iio:deviceN
+  * @param  channels: N of each in_voltageN, in sample order
+  * @param  num: channels per scan
+  * @retval 0 on success, -1 on error
+  */
+int
+ADCConvertInitDevice(ADC_Convert *conv, int device, const int *channels, int num)
+{
+	double scale[ADC_CONVERT_MAX];
+	double offset[ADC_CONVERT_MAX];
+	char path[IIO_PATH_MAX];
+	int i;
+
+	if (NULL == channels || num < 1 || num > ADC_CONVERT_MAX)
+		return(ADCConvertInit(conv, 0, NULL, NULL));
+
+	for (i = 0; i < num; i++) {
+		if (IIOChannelAttr(device, channels[i], "scale", path))
+			fprintf(stderr, "No scale for in_voltage%d, using raw counts!\n", channels[i]);
+		scale[i] = IIOReadDouble(path, 1.0);
+
+		IIOChannelAttr(device, channels[i], "offset", path);
+		offset[i] = IIOReadDouble(path, 0.0);
+	}
+
+	return(ADCConvertInit(conv, num, scale, offset));
+}
+
+/**
+  * @brief  Sets up the conversion for the samples of IIOBufferRead().
+  */
+int
+ADCConvertInitBuffer(ADC_Convert *conv, const IIO_Buffer *buf)
+{
+	int channels[ADC_CONVERT_MAX];
+	int i;
+
+	if (NULL == buf)
+		return(-1);
+
+	for (i = 0; i < buf->num_channels; i++)
+		channels[buf->channels[i].slot] = buf->channels[i].channel;
+
+	return(ADCConvertInitDevice(conv, buf->device, channels, buf->num_channels));
+}
+
+/**
+  * @brief  Converts an interleaved block of raw counts to millivolts.
+  * @param  conv: conversion state
+  * @param  raw: raw counts, channel k % num_channels at position k
+  * @param  mv: output, may not overlap raw
+  * @param  count: number of samples (scans * num_channels)
+  */
+void
+ADCConvert(const ADC_Convert *conv, const int32_t *raw, float *mv, int count)
+{
+	s_kernel(conv, raw, mv, count);
+}
+
+/**
+  * @brief  Name of the selected kernel: "avx", "sse2", "neon" or "scalar".
+  */
+const char *
+ADCConvertKernel(void)
+{
+	ADCConvertSelect();
+	return(s_kernel_name);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
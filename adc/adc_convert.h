@@ -0,0 +1,46 @@
+/**
+  ******************************************************************************
+  * @file    adc_convert.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the block
+  *          raw-to-voltage conversion.
+  *
+  * @details Provides the following functionality:
+  *          - Per-channel scale and offset read once from IIO
+  *          - Conversion of interleaved raw blocks to millivolts
+  *          - SSE / AVX / NEON kernels with a scalar fallback
+  ******************************************************************************
+  * @defgroup ADC_Convert ADC Conversion
+  * @brief Per-channel factors expanded for vector lanes
+  * @{
+  */
+
+#ifndef __ADC_CONVERT_H
+#define __ADC_CONVERT_H
+
+#include <stdint.h>
+#include "iio_buffer.h"
+
+#define ADC_CONVERT_MAX		IIO_SCAN_MAX	/* channels per scan */
+#define ADC_CONVERT_LANES	8		/* widest vector, floats */
+
+typedef struct {
+	int num_channels;
+	int period;		/* num_channels * ADC_CONVERT_LANES */
+	/* scale and offset of sample k at [k % period] */
+	float scale[ADC_CONVERT_MAX * ADC_CONVERT_LANES] __attribute__((aligned(32)));
+	float offset[ADC_CONVERT_MAX * ADC_CONVERT_LANES] __attribute__((aligned(32)));
+} ADC_Convert;
+
+/** @} */
+
+extern int ADCConvertInit(ADC_Convert *conv, int num, const double *scale, const double *offset);
+extern int ADCConvertInitDevice(ADC_Convert *conv, int device, const int *channels, int num);
+extern int ADCConvertInitBuffer(ADC_Convert *conv, const IIO_Buffer *buf);
+extern void ADCConvert(const ADC_Convert *conv, const int32_t *raw, float *mv, int count);
+extern const char *ADCConvertKernel(void);
+
+
+#endif /*__ADC_CONVERT_H */
@@ -0,0 +1,559 @@
+/**
+  ******************************************************************************
+  * @file    adc_dsp.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides streaming filter stages for ADC blocks:
+  *           - Decimation with boxcar or CIC response
+  *           - Moving average
+  *           - Biquad IIR low pass, high pass and notch
+  *           - Min / max / mean / RMS per window
+  *           - In-place stage chaining
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Filter Stages
+  *          ===================================================================
+  *
+  *          Blocks
+  *          =====================
+  *          - Every stage works in place on an interleaved float block, as
+  *            ADCConvert() writes it: scan s, channel c at [s * num + c]
+  *          - A stage returns the number of scans it leaves in the block;
+  *            only decimation reduces it
+  *          - All state lives in the stage struct, filled at init: nothing
+  *            is allocated, copied or resized per block, and filters run
+  *            seamlessly across block boundaries
+  *
+  *          Decimation
+  *          =======================
+  *          - Order 1 averages every R input scans into one (boxcar)
+  *          - Order N has the response of an N stage CIC decimator, a
+  *            boxcar convolved N times with itself, normalized to unity
+  *            gain; it is evaluated as a decimating FIR on the last
+  *            N * (R - 1) + 1 scans, which has no integrator growth or drift
+  *            on float data, at about N multiply-adds per input sample
+  *          - The first output waits for a full history
+  *
+  *          Filters
+  *          =======================
+  *          - Moving average: running sum over the last L scans
+  *          - Biquad: transposed direct form II, coefficients from the
+  *            RBJ audio EQ cookbook; cascade stages for higher orders
+  *          - Statistics: min, max, mean and RMS per window of W scans,
+  *            delivered by callback and kept in result[]; data passes
+  *            through unchanged
+  *
+  *          SIMD
+  *          =======================
+  *          - Decimator and biquad process four channels per operation
+  *            with GCC vector types, which compile to SSE on x86, NEON on
+  *            ARM and plain code elsewhere
+  *          - The filter state is padded to ADC_DSP_CHANNELS so every group
+  *            of four is a full, aligned vector
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "adc_dsp.h" in your application
+  *            - Init the stages once, chain them with ADCPipelineAdd()
+  *            - Run each converted block through ADCPipelineRun()
+  *            - Compile with: gcc -O2 iio_adc.c iio_buffer.c adc_convert.c
+  *                            adc_dsp.c your_app.c -lm
+  *
+  *          Example Usage:
+  *            // 4 channels at 10 kHz: 50 Hz notch, decimate by 10 (CIC 3),
+  *            // 1 s statistics at the reduced rate
+  *            static ADC_Biquad notch;
+  *            static ADC_Decim decim;
+  *            static ADC_Stats stats;
+  *            ADC_Pipeline p = { 0 };
+  *
+  *            ADCBiquadNotch(&notch, 4, 10000, 50, 5);
+  *            ADCDecimInit(&decim, 4, 10, 3);
+  *            ADCStatsInit(&stats, 4, 1000, report, NULL);
+  *            ADCPipelineAdd(&p, ADC_STAGE_BIQUAD, &notch);
+  *            ADCPipelineAdd(&p, ADC_STAGE_DECIM, &decim);
+  *            ADCPipelineAdd(&p, ADC_STAGE_STATS, &stats);
+  *
+  *            n = IIOBufferRead(adc, raw, NULL, 256, -1);
+  *            ADCConvert(&conv, raw, mv, n * 4);
+  *            n = ADCPipelineRun(&p, mv, n);  // n scans at 1 kHz in mv
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "adc_dsp.h"
+
+#define LANES	4
+
+typedef float ADC_v4f __attribute__((vector_size(16)));
+
+static int
+ADCCheckChannels(int num)
+{
+	if (num < 1 || num > ADC_DSP_CHANNELS) {
+		fprintf(stderr, "Invalid ADC filter channel count %d!\n", num);
+		return(-1);
+	}
+
+	return(0);
+}
+
+/* loads up to four channels of a scan, missing lanes read as 0 */
+static inline ADC_v4f
+ADCLoad(const float *p, int lanes)
+{
+	ADC_v4f v = { 0, 0, 0, 0 };
+
+	memcpy(&v, p, lanes * sizeof(float));
+	return(v);
+}
+
+static inline void
+ADCStore(float *p, ADC_v4f v, int lanes)
+{
+	memcpy(p, &v, lanes * sizeof(float));
+}
+
+/**
+  * @brief  Sets up a decimator.
+  * @param  d: decimator state
+  * @param  num: channels per scan
+  * @param  factor: R, input scans per output scan
+  * @param  order: N, 1 = boxcar average, up to ADC_DSP_ORDER_MAX
+  * @retval 0 on success, -1 on invalid arguments
+  */
+int
+ADCDecimInit(ADC_Decim *d, int num, int factor, int order)
+{
+	float tmp[ADC_DSP_TAPS_MAX];
+	double gain;
+	int len;
+	int n;
+	int i;
+	int j;
+
+	if (ADCCheckChannels(num) || factor < 1 || order < 1 || order > ADC_DSP_ORDER_MAX ||
+	    (order > 1 && order * (factor - 1) + 1 > ADC_DSP_TAPS_MAX)) {
+		fprintf(stderr, "Invalid decimator setup!\n");
+		return(-1);
+	}
+
+	memset(d, 0, sizeof(*d));
+	d->num_channels = num;
+	d->factor = factor;
+	d->order = order;
+	if (1 == order)
+		return(0);
+
+	/* boxcar of R convolved with itself N - 1 times */
+	d->taps = order * (factor - 1) + 1;
+	for (i = 0; i < factor; i++)
+		d->coeff[i] = 1.0f;
+	len = factor;
+	for (n = 1; n < order; n++) {
+		memset(tmp, 0, sizeof(tmp));
+		for (i = 0; i < len; i++) {
+			for (j = 0; j < factor; j++)
+				tmp[i + j] += d->coeff[i];
+		}
+		len += factor - 1;
+		memcpy(d->coeff, tmp, len * sizeof(float));
+	}
+
+	gain = pow(factor, order);
+	for (i = 0; i < d->taps; i++)
+		d->coeff[i] = (float)(d->coeff[i] / gain);
+
+	return(0);
+}
+
+static int
+ADCDecimBoxcar(ADC_Decim *d, float *buf, int scans)
+{
+	int num = d->num_channels;
+	int out = 0;
+	int i;
+	int c;
+
+	for (i = 0; i < scans; i++) {
+		for (c = 0; c < num; c++)
+			d->sum[c] += buf[i * num + c];
+
+		if (++d->phase < d->factor)
+			continue;
+
+		d->phase = 0;
+		for (c = 0; c < num; c++) {
+			buf[out * num + c] = (float)(d->sum[c] / d->factor);
+			d->sum[c] = 0.0;
+		}
+		out++;
+	}
+
+	return(out);
+}
+
+/**
+  * @brief  Decimates a block in place.
+  * @retval Number of output scans at the start of buf
+  */
+int
+ADCDecim(ADC_Decim *d, float *buf, int scans)
+{
+	int num = d->num_channels;
+	const float *row;
+	ADC_v4f acc;
+	int out = 0;
+	int lanes;
+	int i;
+	int c;
+	int k;
+
+	if (1 == d->factor)
+		return(scans);
+	if (1 == d->order)
+		return(ADCDecimBoxcar(d, buf, scans));
+
+	for (i = 0; i < scans; i++) {
+		memcpy(d->hist[d->pos], &buf[i * num], num * sizeof(float));
+		memcpy(d->hist[d->pos + d->taps], &buf[i * num], num * sizeof(float));
+		if (++d->pos == d->taps)
+			d->pos = 0;
+		if (d->filled < d->taps)
+			d->filled++;
+
+		if (++d->phase < d->factor)
+			continue;
+		d->phase = 0;
+		if (d->filled < d->taps)
+			continue;
+
+		/* the last taps scans are hist[pos .. pos + taps - 1] */
+		for (c = 0; c < num; c += LANES) {
+			acc = (ADC_v4f){ 0, 0, 0, 0 };
+			for (k = 0; k < d->taps; k++) {
+				row = d->hist[d->pos + k];
+				acc += d->coeff[k] * *(const ADC_v4f *)&row[c];
+			}
+			lanes = (num - c < LANES) ? num - c : LANES;
+			ADCStore(&buf[out * num + c], acc, lanes);
+		}
+		out++;
+	}
+
+	return(out);
+}
+
+/**
+  * @brief  Sets up a moving average over length scans.
+  */
+int
+ADCMovAvgInit(ADC_MovAvg *m, int num, int length)
+{
+	if (ADCCheckChannels(num) || length < 1 || length > ADC_DSP_WINDOW_MAX) {
+		fprintf(stderr, "Invalid moving average setup!\n");
+		return(-1);
+	}
+
+	memset(m, 0, sizeof(*m));
+	m->num_channels = num;
+	m->length = length;
+	return(0);
+}
+
+/**
+  * @brief  Replaces every sample with the average of its last length scans.
+  * @note   Until length scans have passed, the average covers those seen.
+  * @retval scans
+  */
+int
+ADCMovAvg(ADC_MovAvg *m, float *buf, int scans)
+{
+	int num = m->num_channels;
+	float x;
+	int i;
+	int c;
+
+	for (i = 0; i < scans; i++) {
+		if (m->filled < m->length)
+			m->filled++;
+
+		for (c = 0; c < num; c++) {
+			x = buf[i * num + c];
+			m->sum[c] += (double)x - m->hist[m->pos][c];
+			m->hist[m->pos][c] = x;
+			buf[i * num + c] = (float)(m->sum[c] / m->filled);
+		}
+
+		if (++m->pos == m->length)
+			m->pos = 0;
+	}
+
+	return(scans);
+}
+
+/**
+  * @brief  Sets up a biquad from normalized coefficients (a0 = 1).
+  */
+int
+ADCBiquadInit(ADC_Biquad *b, int num, double b0, double b1, double b2, double a1, double a2)
+{
+	if (ADCCheckChannels(num))
+		return(-1);
+
+	memset(b, 0, sizeof(*b));
+	b->num_channels = num;
+	b->b0 = (float)b0;
+	b->b1 = (float)b1;
+	b->b2 = (float)b2;
+	b->a1 = (float)a1;
+	b->a2 = (float)a2;
+	return(0);
+}
+
+/* RBJ cookbook section: b = {b0, b1, b2} for the given type, a from w0 / q */
+static int
+ADCBiquadDesign(ADC_Biquad *b, int num, double fs, double fc, double q, int type)
+{
+	double w0;
+	double cw;
+	double alpha;
+	double a0;
+	double b0;
+	double b1;
+	double b2;
+
+	if (fs <= 0 || fc <= 0 || fc >= fs / 2 || q <= 0) {
+		fprintf(stderr, "Invalid biquad frequency or Q!\n");
+		return(-1);
+	}
+
+	w0 = 2.0 * M_PI * fc / fs;
+	cw = cos(w0);
+	alpha = sin(w0) / (2.0 * q);
+	a0 = 1.0 + alpha;
+
+	switch (type) {
+	case 0:		/* low pass */
+		b0 = (1.0 - cw) / 2.0;
+		b1 = 1.0 - cw;
+		b2 = b0;
+		break;
+	case 1:		/* high pass */
+		b0 = (1.0 + cw) / 2.0;
+		b1 = -(1.0 + cw);
+		b2 = b0;
+		break;
+	default:	/* notch */
+		b0 = 1.0;
+		b1 = -2.0 * cw;
+		b2 = 1.0;
+		break;
+	}
+
+	return(ADCBiquadInit(b, num, b0 / a0, b1 / a0, b2 / a0, -2.0 * cw / a0, (1.0 - alpha) / a0));
+}
+
+/**
+  * @brief  Second order low pass.
+  * @param  fs: sample rate of the scans in Hz
+  * @param  fc: cutoff in Hz
+  * @param  q: quality factor, 0.7071 for Butterworth
+  */
+int
+ADCBiquadLowPass(ADC_Biquad *b, int num, double fs, double fc, double q)
+{
+	return(ADCBiquadDesign(b, num, fs, fc, q, 0));
+}
+
+int
+ADCBiquadHighPass(ADC_Biquad *b, int num, double fs, double fc, double q)
+{
+	return(ADCBiquadDesign(b, num, fs, fc, q, 1));
+}
+
+/**
+  * @brief  Notch at fc, e.g. mains hum; higher q = narrower notch.
+  */
+int
+ADCBiquadNotch(ADC_Biquad *b, int num, double fs, double fc, double q)
+{
+	return(ADCBiquadDesign(b, num, fs, fc, q, 2));
+}
+
+/**
+  * @brief  Filters a block in place.
+  * @retval scans
+  */
+int
+ADCBiquad(ADC_Biquad *b, float *buf, int scans)
+{
+	int num = b->num_channels;
+	ADC_v4f x;
+	ADC_v4f y;
+	ADC_v4f z1;
+	ADC_v4f z2;
+	int lanes;
+	int i;
+	int c;
+
+	/* channels outer: each group keeps its state in registers for the block */
+	for (c = 0; c < num; c += LANES) {
+		lanes = (num - c < LANES) ? num - c : LANES;
+		z1 = *(ADC_v4f *)&b->z1[c];
+		z2 = *(ADC_v4f *)&b->z2[c];
+
+		for (i = 0; i < scans; i++) {
+			x = ADCLoad(&buf[i * num + c], lanes);
+			y = b->b0 * x + z1;
+			z1 = b->b1 * x - b->a1 * y + z2;
+			z2 = b->b2 * x - b->a2 * y;
+			ADCStore(&buf[i * num + c], y, lanes);
+		}
+
+		*(ADC_v4f *)&b->z1[c] = z1;
+		*(ADC_v4f *)&b->z2[c] = z2;
+	}
+
+	return(scans);
+}
+
+static void
+ADCStatsReset(ADC_Stats *s)
+{
+	int c;
+
+	s->count = 0;
+	for (c = 0; c < s->num_channels; c++) {
+		s->min[c] = INFINITY;
+		s->max[c] = -INFINITY;
+		s->sum[c] = 0.0;
+		s->sum_sq[c] = 0.0;
+	}
+}
+
+/**
+  * @brief  Sets up window statistics.
+  * @param  window: scans per result
+  * @param  callback: called with num results after every window, may be NULL
+  */
+int
+ADCStatsInit(ADC_Stats *s, int num, int window, ADC_StatsCallback callback, void *arg)
+{
+	if (ADCCheckChannels(num) || window < 1) {
+		fprintf(stderr, "Invalid statistics setup!\n");
+		return(-1);
+	}
+
+	memset(s, 0, sizeof(*s));
+	s->num_channels = num;
+	s->window = window;
+	s->callback = callback;
+	s->arg = arg;
+	ADCStatsReset(s);
+	return(0);
+}
+
+/**
+  * @brief  Accumulates a block, closing a window every s->window scans.
+  * @retval scans, the block is not modified
+  */
+int
+ADCStats(ADC_Stats *s, float *buf, int scans)
+{
+	int num = s->num_channels;
+	float x;
+	int i;
+	int c;
+
+	for (i = 0; i < scans; i++) {
+		for (c = 0; c < num; c++) {
+			x = buf[i * num + c];
+			if (x < s->min[c])
+				s->min[c] = x;
+			if (x > s->max[c])
+				s->max[c] = x;
+			s->sum[c] += x;
+			s->sum_sq[c] += (double)x * x;
+		}
+
+		if (++s->count < s->window)
+			continue;
+
+		for (c = 0; c < num; c++) {
+			s->result[c].min = s->min[c];
+			s->result[c].max = s->max[c];
+			s->result[c].mean = (float)(s->sum[c] / s->window);
+			s->result[c].rms = (float)sqrt(s->sum_sq[c] / s->window);
+		}
+		s->windows++;
+		if (s->callback)
+			s->callback(s->result, num, s->arg);
+		ADCStatsReset(s);
+	}
+
+	return(scans);
+}
+
+/**
+  * @brief  Appends a stage to a pipeline.
+  * @param  type: ADC_STAGE_*
+  * @param  stage: initialized stage of that type
+  */
+int
+ADCPipelineAdd(ADC_Pipeline *p, int type, void *stage)
+{
+	if (p->num_stages >= ADC_DSP_STAGES_MAX || NULL == stage ||
+	    type < ADC_STAGE_DECIM || type > ADC_STAGE_STATS) {
+		fprintf(stderr, "Failed to add filter stage!\n");
+		return(-1);
+	}
+
+	p->type[p->num_stages] = type;
+	p->stage[p->num_stages] = stage;
+	p->num_stages++;
+	return(0);
+}
+
+/**
+  * @brief  Runs a block through all stages in place.
+  * @retval Number of scans left in buf
+  */
+int
+ADCPipelineRun(ADC_Pipeline *p, float *buf, int scans)
+{
+	int i;
+
+	for (i = 0; i < p->num_stages && scans > 0; i++) {
+		switch (p->type[i]) {
+		case ADC_STAGE_DECIM:
+			scans = ADCDecim(p->stage[i], buf, scans);
+			break;
+		case ADC_STAGE_MOVAVG:
+			scans = ADCMovAvg(p->stage[i], buf, scans);
+			break;
+		case ADC_STAGE_BIQUAD:
+			scans = ADCBiquad(p->stage[i], buf, scans);
+			break;
+		default:
+			scans = ADCStats(p->stage[i], buf, scans);
+			break;
+		}
+	}
+
+	return(scans);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,117 @@
+/**
+  ******************************************************************************
+  * @file    adc_dsp.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the streaming
+  *          ADC filter stages.
+  *
+  * @details Provides the following functionality:
+  *          - Boxcar / CIC response decimation
+  *          - Moving average
+  *          - Biquad IIR filters (low pass, high pass, notch)
+  *          - Min / max / mean / RMS per window
+  *          - Stage chaining on interleaved blocks, in place
+  ******************************************************************************
+  * @defgroup ADC_DSP ADC Filter Stages
+  * @brief Preallocated per-channel filter state
+  * @{
+  */
+
+#ifndef __ADC_DSP_H
+#define __ADC_DSP_H
+
+#include <stdint.h>
+#include "adc_convert.h"
+
+#define ADC_DSP_CHANNELS	ADC_CONVERT_MAX	/* per-scan stride of the filter state */
+#define ADC_DSP_TAPS_MAX	128	/* decimator response length, order * (R - 1) + 1 */
+#define ADC_DSP_WINDOW_MAX	256	/* moving average length in scans */
+#define ADC_DSP_ORDER_MAX	4
+#define ADC_DSP_STAGES_MAX	8
+
+typedef struct {
+	int num_channels;
+	int factor;		/* R: input scans per output scan */
+	int order;		/* N: 1 = boxcar */
+	int taps;		/* N * (R - 1) + 1 */
+	int phase;		/* input scans since the last output */
+	int pos;		/* next slot of the history */
+	int filled;		/* history slots holding input */
+	float coeff[ADC_DSP_TAPS_MAX];	/* newest sample first, sums to 1 */
+	/* history twice over, so a window is contiguous at any position */
+	float hist[2 * ADC_DSP_TAPS_MAX][ADC_DSP_CHANNELS] __attribute__((aligned(16)));
+	double sum[ADC_DSP_CHANNELS];	/* boxcar accumulators */
+} ADC_Decim;
+
+typedef struct {
+	int num_channels;
+	int length;		/* scans averaged */
+	int pos;
+	int filled;
+	double sum[ADC_DSP_CHANNELS];
+	float hist[ADC_DSP_WINDOW_MAX][ADC_DSP_CHANNELS];
+} ADC_MovAvg;
+
+typedef struct {
+	int num_channels;
+	float b0, b1, b2, a1, a2;	/* a0 normalized to 1 */
+	/* transposed direct form II state */
+	float z1[ADC_DSP_CHANNELS] __attribute__((aligned(16)));
+	float z2[ADC_DSP_CHANNELS] __attribute__((aligned(16)));
+} ADC_Biquad;
+
+typedef struct {
+	float min;
+	float max;
+	float mean;
+	float rms;
+} ADC_StatsResult;
+
+typedef void (*ADC_StatsCallback)(const ADC_StatsResult *result, int num_channels, void *arg);
+
+typedef struct {
+	int num_channels;
+	int window;		/* scans per result */
+	int count;
+	float min[ADC_DSP_CHANNELS];
+	float max[ADC_DSP_CHANNELS];
+	double sum[ADC_DSP_CHANNELS];
+	double sum_sq[ADC_DSP_CHANNELS];
+	ADC_StatsResult result[ADC_DSP_CHANNELS];	/* last completed window */
+	uint64_t windows;
+	ADC_StatsCallback callback;
+	void *arg;
+} ADC_Stats;
+
+#define ADC_STAGE_DECIM		0
+#define ADC_STAGE_MOVAVG	1
+#define ADC_STAGE_BIQUAD	2
+#define ADC_STAGE_STATS		3
+
+typedef struct {
+	int num_stages;
+	int type[ADC_DSP_STAGES_MAX];
+	void *stage[ADC_DSP_STAGES_MAX];
+} ADC_Pipeline;
+
+/** @} */
+
+extern int ADCDecimInit(ADC_Decim *d, int num, int factor, int order);
+extern int ADCDecim(ADC_Decim *d, float *buf, int scans);
+extern int ADCMovAvgInit(ADC_MovAvg *m, int num, int length);
+extern int ADCMovAvg(ADC_MovAvg *m, float *buf, int scans);
+extern int ADCBiquadInit(ADC_Biquad *b, int num, double b0, double b1, double b2,
+			 double a1, double a2);
+extern int ADCBiquadLowPass(ADC_Biquad *b, int num, double fs, double fc, double q);
+extern int ADCBiquadHighPass(ADC_Biquad *b, int num, double fs, double fc, double q);
+extern int ADCBiquadNotch(ADC_Biquad *b, int num, double fs, double fc, double q);
+extern int ADCBiquad(ADC_Biquad *b, float *buf, int scans);
+extern int ADCStatsInit(ADC_Stats *s, int num, int window, ADC_StatsCallback callback, void *arg);
+extern int ADCStats(ADC_Stats *s, float *buf, int scans);
+extern int ADCPipelineAdd(ADC_Pipeline *p, int type, void *stage);
+extern int ADCPipelineRun(ADC_Pipeline *p, float *buf, int scans);
+
+
+#endif /*__ADC_DSP_H */
@@ -0,0 +1,754 @@
+/**
+  ******************************************************************************
+  * @file    adc_record.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides recording and replay of ADC and GPIO streams:
+  *           - Preallocated, memory mapped, append-only binary file
+  *           - Timestamped blocks stored column by column per channel
+  *           - Index of block offsets and time ranges
+  *           - Replay through IIOBufferRead() and GPIOEventWait()
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Recorder
+  *          ===================================================================
+  *
+  *          File Layout
+  *          =====================
+  *          - Header (4 KiB): channels, scale / offset, sample rate, index
+  *            and data positions, block and sample counts
+  *          - Index: one entry per block with its offset, type, count and
+  *            first / last timestamp, reserved at create time
+  *          - Blocks, back to back: an int64 timestamp column, then one int32
+  *            column per channel for ADC scans, or bank, gpio and edge
+  *            columns for GPIO events
+  *          - Columns let an analysis tool map one channel of a block
+  *            without touching the others
+  *
+  *          Recording
+  *          =======================
+  *          - The whole file is allocated with posix_fallocate() and mapped
+  *            once; a full disk is reported at create time instead of as
+  *            SIGBUS in the middle of a capture
+  *          - Appending a block is a transposing copy into the mapping:
+  *            no write() call, no printf() formatting
+  *          - The block is written first, then its index entry, then
+  *            num_blocks is published; a reader of a file still being
+  *            recorded, or of one cut short by a crash, sees only complete
+  *            blocks
+  *          - GPIO events are staged and written as one block every
+  *            ADC_RECORD_EDGES events, or on ADCRecordSync()
+  *          - The kernel writes the dirty pages back in the background;
+  *            ADCRecordSync() starts that early, ADCRecordClose() waits for
+  *            it and trims the file to the recorded size
+  *
+  *          Replay
+  *          =======================
+  *          - ADCReplayBuffer() returns an IIO_Buffer that reads the
+  *            recorded scans and timestamps through IIOBufferRead()
+  *          - ADCReplayGPIO() makes GPIOEventWait() on a set return the
+  *            recorded events
+  *          - speed 0 returns blocks as fast as they are read; speed 1
+  *            paces them by their timestamps like the live device, a read
+  *            returning once its last scan is due or the timeout expires
+  *          - Scan and event timestamps are both CLOCK_MONOTONIC (the
+  *            IIO clock is switched by IIOBufferOpen()), so the two streams
+  *            are paced from one common start
+  *          - At the end of the recording reads fail with errno ENODATA;
+  *            on a file still being recorded, blocks published after the
+  *            open are picked up once the cursor reaches them
+  *          - ADCReplayConvert() sets up the conversion with the recorded
+  *            scale and offset, the device may not be present
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "adc_record.h" in your application
+  *            - Create the recorder with the capture channels and feed it
+  *              every block read, and every GPIO event if wanted
+  *            - Replay the file later through the same read calls
+  *            - Compile with: gcc -O2 -I../gpio iio_adc.c iio_buffer.c
+  *                            adc_convert.c adc_record.c your_app.c
+  *
+  *          Example Usage:
+  *            ADC_Recorder *rec;
+  *            ADC_Convert conv;
+  *
+  *            ADCConvertInitDevice(&conv, 0, ch, 4);
+  *            rec = ADCRecordCreate("/data/run1.rec", 1ULL << 30, ch, 4, &conv, 10000);
+  *            while (running) {
+  *                n = IIOBufferRead(adc, raw, ts, 256, -1);
+  *                ADCRecordScans(rec, raw, ts, n);
+  *            }
+  *            ADCRecordClose(rec);
+  *
+  *            // later, without hardware
+  *            ADC_Replay *rp = ADCReplayOpen("/data/run1.rec", 1.0);
+  *            IIO_Buffer *adc = ADCReplayBuffer(rp);
+  *            ADCReplayConvert(rp, &conv);
+  *            while ((n = IIOBufferRead(adc, raw, ts, 256, -1)) >= 0)
+  *                process(raw, ts, n);
+  *            IIOBufferClose(adc);
+  *            ADCReplayClose(rp);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "adc_record.h"
+
+_Static_assert(sizeof(ADC_RecordHeader) <= ADC_RECORD_HEADER, "record header too large");
+
+#define ADC_RECORD_PAGE		4096
+
+static int64_t
+ADCRecordNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+/* bytes of a block of count scans or events, kept 8 byte aligned */
+static uint64_t
+ADCRecordBlockSize(uint32_t type, uint32_t count, uint32_t num_channels)
+{
+	uint64_t columns = (ADC_RECORD_SCANS == type) ? num_channels : 3;
+	uint64_t len = (uint64_t)count * (sizeof(int64_t) + columns * sizeof(int32_t));
+
+	return((len + 7) & ~7ULL);
+}
+
+/* room for the next block, NULL once the file or its index is full */
+static uint8_t *
+ADCRecordAlloc(ADC_Recorder *rec, uint32_t type, uint32_t count)
+{
+	ADC_RecordHeader *hdr = rec->hdr;
+	uint64_t len = ADCRecordBlockSize(type, count, hdr->num_channels);
+
+	if (hdr->num_blocks >= hdr->index_max || hdr->data_end + len > hdr->capacity) {
+		if (!rec->full)
+			fprintf(stderr, "Recording file full, dropping blocks!\n");
+		rec->full = 1;
+		return(NULL);
+	}
+
+	return(rec->map + hdr->data_end);
+}
+
+/* adds the index entry of the block just written and publishes it */
+static void
+ADCRecordCommit(ADC_Recorder *rec, uint32_t type, uint32_t count, const int64_t *ts)
+{
+	ADC_RecordHeader *hdr = rec->hdr;
+	ADC_RecordIndex *ix = &rec->index[hdr->num_blocks];
+
+	ix->offset = hdr->data_end;
+	ix->type = type;
+	ix->count = count;
+	ix->first_ns = ts[0];
+	ix->last_ns = ts[count - 1];
+
+	hdr->data_end += ADCRecordBlockSize(type, count, hdr->num_channels);
+	if (ADC_RECORD_SCANS == type)
+		hdr->scans += count;
+	else
+		hdr->events += count;
+	__atomic_store_n(&hdr->num_blocks, hdr->num_blocks + 1, __ATOMIC_RELEASE);
+}
+
+static int
+ADCRecordFlushEvents(ADC_Recorder *rec)
+{
+	uint32_t count = rec->num_events;
+	int64_t *ts;
+	int32_t *col;
+	uint8_t *block;
+	uint32_t i;
+
+	if (0 == count)
+		return(0);
+
+	rec->num_events = 0;
+	block = ADCRecordAlloc(rec, ADC_RECORD_GPIO, count);
+	if (NULL == block)
+		return(-1);
+
+	ts = (int64_t *)block;
+	col = (int32_t *)(ts + count);
+	for (i = 0; i < count; i++) {
+		ts[i] = (int64_t)rec->events[i].timestamp_ns;
+		col[i] = rec->events[i].bank;
+		col[count + i] = rec->events[i].gpio;
+		col[2 * count + i] = rec->events[i].edge;
+	}
+
+	ADCRecordCommit(rec, ADC_RECORD_GPIO, count, ts);
+	return(0);
+}
+
+/**
+  * @brief  Creates a recording file and maps it.
+  * @param  path: file to create, truncated if it exists
+  * @param  capacity: file size reserved for the recording, in bytes
+  * @param  channels: N of each in_voltageN, in sample order
+  * @param  num: channels per scan
+  * @param  conv: conversion of the channels, NULL to record raw counts only
+  * @param  sample_rate: scans per second, used for blocks without timestamps
+  * @retval Recorder, NULL on error
+  */
+ADC_Recorder *
+ADCRecordCreate(const char *path, uint64_t capacity, const int *channels, int num,
+		const ADC_Convert *conv, double sample_rate)
+{
+	ADC_Recorder *rec;
+	ADC_RecordHeader *hdr;
+	uint64_t index_max;
+	uint64_t data_offset;
+	int ret;
+	int i;
+
+	if (NULL == path || NULL == channels || num < 1 || num > IIO_SCAN_MAX ||
+	    (NULL != conv && conv->num_channels != num)) {
+		fprintf(stderr, "Invalid recording setup!\n");
+		return(NULL);
+	}
+
+	/* one index entry per 4 KiB of data, the smallest useful block */
+	index_max = capacity / ADC_RECORD_PAGE;
+	if (index_max < 256)
+		index_max = 256;
+	data_offset = ADC_RECORD_HEADER + index_max * sizeof(ADC_RecordIndex);
+	data_offset = (data_offset + ADC_RECORD_PAGE - 1) & ~(uint64_t)(ADC_RECORD_PAGE - 1);
+	if (capacity <= data_offset || capacity > (uint64_t)SIZE_MAX) {
+		fprintf(stderr, "Invalid recording capacity!\n");
+		return(NULL);
+	}
+
+	rec = calloc(1, sizeof(*rec));
+	if (NULL == rec)
+		return(NULL);
+
+	rec->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (-1 == rec->fd) {
+		fprintf(stderr, "Failed to create %s!\n", path);
+		free(rec);
+		return(NULL);
+	}
+
+	ret = posix_fallocate(rec->fd, 0, (off_t)capacity);
+	if (EOPNOTSUPP == ret || EINVAL == ret)
+		ret = ftruncate(rec->fd, (off_t)capacity) ? errno : 0;
+	if (ret) {
+		fprintf(stderr, "Failed to allocate %llu bytes for %s!\n",
+			(unsigned long long)capacity, path);
+		goto fail;
+	}
+
+	rec->map = mmap(NULL, (size_t)capacity, PROT_READ | PROT_WRITE, MAP_SHARED, rec->fd, 0);
+	if (MAP_FAILED == rec->map) {
+		fprintf(stderr, "Failed to map %s!\n", path);
+		goto fail;
+	}
+	madvise(rec->map, (size_t)capacity, MADV_SEQUENTIAL);
+
+	hdr = (ADC_RecordHeader *)rec->map;
+	rec->hdr = hdr;
+	rec->index = (ADC_RecordIndex *)(rec->map + ADC_RECORD_HEADER);
+	rec->period_ns = (sample_rate > 0.0) ? (int64_t)(1e9 / sample_rate) : 0;
+
+	hdr->version = ADC_RECORD_VERSION;
+	hdr->num_channels = num;
+	hdr->index_max = (uint32_t)index_max;
+	for (i = 0; i < num; i++) {
+		hdr->channel[i] = channels[i];
+		hdr->scale[i] = conv ? conv->scale[i] : 1.0;
+		hdr->offset[i] = conv ? conv->offset[i] : 0.0;
+	}
+	hdr->sample_rate = sample_rate;
+	hdr->index_offset = ADC_RECORD_HEADER;
+	hdr->data_offset = data_offset;
+	hdr->capacity = capacity;
+	hdr->data_end = data_offset;
+	__atomic_store_n(&hdr->magic, ADC_RECORD_MAGIC, __ATOMIC_RELEASE);
+
+	return(rec);
+
+fail:
+	close(rec->fd);
+	unlink(path);
+	free(rec);
+	return(NULL);
+}
+
+/**
+  * @brief  Appends a block of scans.
+  * @param  rec: recorder
+  * @param  samples: interleaved samples as from IIOBufferRead()
+  * @param  timestamps: one per scan, NULL to stamp the block on arrival
+  * @param  scans: number of scans
+  * @retval 0 on success, -1 if the file is full or on invalid arguments
+  */
+int
+ADCRecordScans(ADC_Recorder *rec, const int32_t *samples, const int64_t *timestamps, int scans)
+{
+	uint32_t num;
+	int64_t *ts;
+	int32_t *col;
+	uint8_t *block;
+	int64_t now;
+	uint32_t c;
+	int i;
+
+	if (NULL == rec || NULL == samples || scans < 1)
+		return(-1);
+
+	block = ADCRecordAlloc(rec, ADC_RECORD_SCANS, scans);
+	if (NULL == block)
+		return(-1);
+
+	num = rec->hdr->num_channels;
+	ts = (int64_t *)block;
+	if (NULL != timestamps) {
+		memcpy(ts, timestamps, (size_t)scans * sizeof(*ts));
+	} else {
+		/* the last scan arrived just now, earlier ones one period apart */
+		now = ADCRecordNow();
+		for (i = 0; i < scans; i++)
+			ts[i] = now - (int64_t)(scans - 1 - i) * rec->period_ns;
+	}
+
+	col = (int32_t *)(ts + scans);
+	for (c = 0; c < num; c++, col += scans) {
+		for (i = 0; i < scans; i++)
+			col[i] = samples[(size_t)i * num + c];
+	}
+
+	ADCRecordCommit(rec, ADC_RECORD_SCANS, scans, ts);
+	return(0);
+}
+
+/**
+  * @brief  Adds GPIO events, e.g. as returned by GPIOEventWait().
+  * @retval 0 on success, -1 if the file is full or on invalid arguments
+  */
+int
+ADCRecordEvents(ADC_Recorder *rec, const GPIO_Event *events, int num)
+{
+	int ret = 0;
+	int i;
+
+	if (NULL == rec || NULL == events || num < 0)
+		return(-1);
+
+	for (i = 0; i < num; i++) {
+		rec->events[rec->num_events++] = events[i];
+		if (ADC_RECORD_EDGES == rec->num_events && ADCRecordFlushEvents(rec))
+			ret = -1;
+	}
+
+	return(ret);
+}
+
+/**
+  * @brief  Writes staged GPIO events and starts write-back of the file.
+  * @retval 0 on success, -1 on error
+  */
+int
+ADCRecordSync(ADC_Recorder *rec)
+{
+	int ret;
+
+	if (NULL == rec)
+		return(-1);
+
+	ret = ADCRecordFlushEvents(rec);
+	if (msync(rec->map, rec->hdr->data_end, MS_ASYNC)) {
+		fprintf(stderr, "Failed to sync recording!\n");
+		ret = -1;
+	}
+
+	return(ret);
+}
+
+void
+ADCRecordClose(ADC_Recorder *rec)
+{
+	uint64_t capacity;
+	uint64_t size;
+
+	if (NULL == rec)
+		return;
+
+	ADCRecordFlushEvents(rec);
+	rec->hdr->closed = 1;
+	size = rec->hdr->data_end;
+	capacity = rec->hdr->capacity;
+	if (msync(rec->map, size, MS_SYNC))
+		fprintf(stderr, "Failed to sync recording!\n");
+	munmap(rec->map, (size_t)capacity);
+
+	/* give back the preallocated space that was not used */
+	if (ftruncate(rec->fd, (off_t)size))
+		fprintf(stderr, "Failed to trim recording!\n");
+	close(rec->fd);
+	free(rec);
+}
+
+/* takes in the blocks published since the last call, -1 at an invalid one */
+static int
+ADCReplayLoad(ADC_Replay *rp)
+{
+	const ADC_RecordHeader *hdr = rp->hdr;
+	const ADC_RecordIndex *ix;
+	uint32_t num;
+
+	num = __atomic_load_n(&hdr->num_blocks, __ATOMIC_ACQUIRE);
+	if (num > hdr->index_max)
+		return(-1);
+
+	for (; rp->num_blocks < num; rp->num_blocks++) {
+		ix = &rp->index[rp->num_blocks];
+		if (ix->count < 1 || ix->offset < hdr->data_offset || (ix->offset & 7) ||
+		    ix->offset + ADCRecordBlockSize(ix->type, ix->count, hdr->num_channels) > rp->size ||
+		    (ADC_RECORD_SCANS != ix->type && ADC_RECORD_GPIO != ix->type))
+			return(-1);
+
+		/* once paced replay has started its time base stays put */
+		if (0 == rp->wall_ns && (0 == rp->num_blocks || ix->first_ns < rp->start_ns))
+			rp->start_ns = ix->first_ns;
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Opens a recording for replay.
+  * @param  path: recording file, complete or still being written
+  * @param  speed: 0 as fast as read, 1 real time, 2 twice as fast...
+  * @retval Replay state, NULL on error
+  */
+ADC_Replay *
+ADCReplayOpen(const char *path, double speed)
+{
+	const ADC_RecordHeader *hdr;
+	ADC_Replay *rp;
+	struct stat st;
+
+	rp = calloc(1, sizeof(*rp));
+	if (NULL == rp)
+		return(NULL);
+
+	rp->fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (-1 == rp->fd) {
+		fprintf(stderr, "Failed to open %s!\n", path);
+		free(rp);
+		return(NULL);
+	}
+
+	if (fstat(rp->fd, &st) || st.st_size < ADC_RECORD_HEADER)
+		goto invalid;
+
+	rp->size = (size_t)st.st_size;
+	rp->map = mmap(NULL, rp->size, PROT_READ, MAP_SHARED, rp->fd, 0);
+	if (MAP_FAILED == rp->map) {
+		fprintf(stderr, "Failed to map %s!\n", path);
+		close(rp->fd);
+		free(rp);
+		return(NULL);
+	}
+	madvise((void *)rp->map, rp->size, MADV_SEQUENTIAL);
+
+	hdr = (const ADC_RecordHeader *)rp->map;
+	rp->hdr = hdr;
+	rp->index = (const ADC_RecordIndex *)(rp->map + hdr->index_offset);
+	rp->speed = speed;
+
+	if (ADC_RECORD_MAGIC != hdr->magic || ADC_RECORD_VERSION != hdr->version ||
+	    hdr->num_channels < 1 || hdr->num_channels > IIO_SCAN_MAX ||
+	    hdr->index_offset + (uint64_t)hdr->index_max * sizeof(*rp->index) > rp->size ||
+	    ADCReplayLoad(rp))
+		goto invalid;
+
+	return(rp);
+
+invalid:
+	fprintf(stderr, "%s is not a valid recording!\n", path);
+	ADCReplayClose(rp);
+	return(NULL);
+}
+
+static int64_t
+ADCReplayWall(const ADC_Replay *rp, int64_t ts)
+{
+	return(rp->wall_ns + (int64_t)((ts - rp->start_ns) / rp->speed));
+}
+
+/* paced replay: sleeps until ts is due, 0 if it is not due within timeout_ms */
+static int
+ADCReplayDue(ADC_Replay *rp, int64_t ts, int timeout_ms)
+{
+	struct timespec t;
+	int64_t due;
+	int64_t now;
+	int ret = 1;
+
+	if (rp->speed <= 0.0)
+		return(1);
+
+	now = ADCRecordNow();
+	if (0 == rp->wall_ns)
+		rp->wall_ns = now;
+
+	due = ADCReplayWall(rp, ts);
+	if (due <= now)
+		return(1);
+
+	if (timeout_ms >= 0 && due - now > (int64_t)timeout_ms * 1000000LL) {
+		due = now + (int64_t)timeout_ms * 1000000LL;
+		ret = 0;
+	}
+
+	t.tv_sec = due / 1000000000LL;
+	t.tv_nsec = due % 1000000000LL;
+	while (EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL))
+		;
+
+	return(ret);
+}
+
+/* block of the type with data left at the cursor, NULL at the end */
+static const ADC_RecordIndex *
+ADCReplayNext(ADC_Replay *rp, uint32_t type, uint32_t *block, uint32_t *pos)
+{
+	for (;;) {
+		/* a file still being recorded may have published more blocks */
+		if (*block >= rp->num_blocks) {
+			ADCReplayLoad(rp);
+			if (*block >= rp->num_blocks)
+				return(NULL);
+		}
+
+		if (type == rp->index[*block].type && *pos < rp->index[*block].count)
+			return(&rp->index[*block]);
+		(*block)++;
+		*pos = 0;
+	}
+}
+
+/* number of the n timestamps due by now, all of them unless paced */
+static int
+ADCReplayAvailable(ADC_Replay *rp, const int64_t *ts, int n, int timeout_ms)
+{
+	int64_t now;
+	int i;
+
+	if (ADCReplayDue(rp, ts[n - 1], timeout_ms))
+		return(n);
+
+	now = ADCRecordNow();
+	for (i = 0; i < n && ADCReplayWall(rp, ts[i]) <= now; i++)
+		;
+
+	return(i);
+}
+
+/**
+  * @brief  Reads recorded scans, as IIOBufferRead() does.
+  * @param  rp: replay state
+  * @param  samples: room for max_scans * num_channels values
+  * @param  timestamps: room for max_scans values, NULL if not wanted
+  * @param  max_scans: scans wanted, 0 for the rest of the block
+  * @param  timeout_ms: paced replay only, -1 waits until the scans are due
+  * @retval Number of scans, 0 on timeout, -1 with errno ENODATA at the end
+  */
+int
+ADCReplayScans(ADC_Replay *rp, int32_t *samples, int64_t *timestamps,
+	       int max_scans, int timeout_ms)
+{
+	const ADC_RecordIndex *ix;
+	const int64_t *ts;
+	const int32_t *col;
+	uint32_t count;
+	uint32_t num;
+	uint32_t c;
+	int n;
+	int i;
+
+	if (NULL == rp || NULL == samples)
+		return(-1);
+
+	ix = ADCReplayNext(rp, ADC_RECORD_SCANS, &rp->scan_block, &rp->scan_pos);
+	if (NULL == ix) {
+		errno = ENODATA;
+		return(-1);
+	}
+
+	count = ix->count;
+	num = rp->hdr->num_channels;
+	ts = (const int64_t *)(rp->map + ix->offset) + rp->scan_pos;
+	n = count - rp->scan_pos;
+	if (max_scans > 0 && n > max_scans)
+		n = max_scans;
+
+	n = ADCReplayAvailable(rp, ts, n, timeout_ms);
+
+	col = (const int32_t *)((const int64_t *)(rp->map + ix->offset) + count) + rp->scan_pos;
+	for (c = 0; c < num; c++, col += count) {
+		for (i = 0; i < n; i++)
+			samples[(size_t)i * num + c] = col[i];
+	}
+	if (NULL != timestamps)
+		memcpy(timestamps, ts, (size_t)n * sizeof(*ts));
+
+	rp->scan_pos += n;
+	return(n);
+}
+
+/**
+  * @brief  Reads recorded GPIO events, as GPIOEventWait() does.
+  * @retval Number of events, 0 on timeout, -1 with errno ENODATA at the end
+  */
+int
+ADCReplayEvents(ADC_Replay *rp, GPIO_Event *events, int max, int timeout_ms)
+{
+	const ADC_RecordIndex *ix;
+	const int64_t *ts;
+	const int32_t *col;
+	uint32_t count;
+	int n;
+	int i;
+
+	if (NULL == rp || NULL == events || max < 1)
+		return(-1);
+
+	ix = ADCReplayNext(rp, ADC_RECORD_GPIO, &rp->event_block, &rp->event_pos);
+	if (NULL == ix) {
+		errno = ENODATA;
+		return(-1);
+	}
+
+	count = ix->count;
+	ts = (const int64_t *)(rp->map + ix->offset) + rp->event_pos;
+	n = count - rp->event_pos;
+	if (n > max)
+		n = max;
+
+	n = ADCReplayAvailable(rp, ts, n, timeout_ms);
+
+	col = (const int32_t *)((const int64_t *)(rp->map + ix->offset) + count) + rp->event_pos;
+	for (i = 0; i < n; i++) {
+		events[i].bank = col[i];
+		events[i].gpio = col[count + i];
+		events[i].edge = col[2 * count + i];
+		events[i].timestamp_ns = (uint64_t)ts[i];
+	}
+
+	rp->event_pos += n;
+	return(n);
+}
+
+static int
+ADCReplayBufferRead(void *arg, int32_t *samples, int64_t *timestamps, int max_scans, int timeout_ms)
+{
+	return(ADCReplayScans(arg, samples, timestamps, max_scans, timeout_ms));
+}
+
+static int
+ADCReplayEventWait(void *arg, GPIO_Event *events, int max, int timeout_ms)
+{
+	return(ADCReplayEvents(arg, events, max, timeout_ms));
+}
+
+/**
+  * @brief  Capture buffer that reads the recording through IIOBufferRead().
+  * @param  rp: replay state, must outlive the buffer
+  * @retval Buffer to release with IIOBufferClose(), NULL on error
+  */
+IIO_Buffer *
+ADCReplayBuffer(ADC_Replay *rp)
+{
+	IIO_Buffer *buf;
+	uint32_t i;
+
+	if (NULL == rp)
+		return(NULL);
+
+	buf = calloc(1, sizeof(*buf));
+	if (NULL == buf)
+		return(NULL);
+
+	buf->device = -1;
+	buf->fd = -1;
+	buf->num_channels = rp->hdr->num_channels;
+	for (i = 0; i < rp->hdr->num_channels; i++) {
+		buf->channels[i].channel = rp->hdr->channel[i];
+		buf->channels[i].slot = i;
+		buf->channels[i].index = i;
+	}
+	buf->timestamp.channel = 0;	/* every recorded scan has one */
+	buf->block_scans = IIO_BUFFER_LENGTH / 4;
+	buf->replay = ADCReplayBufferRead;
+	buf->replay_arg = rp;
+
+	return(buf);
+}
+
+/**
+  * @brief  Makes GPIOEventWait() on the set return the recorded events.
+  * @param  rp: replay state, must outlive the set
+  * @param  set: event set, e.g. a new one with no pins added
+  */
+int
+ADCReplayGPIO(ADC_Replay *rp, GPIO_EventSet *set)
+{
+	if (NULL == rp || NULL == set)
+		return(-1);
+
+	set->replay = ADCReplayEventWait;
+	set->replay_arg = rp;
+	return(0);
+}
+
+/**
+  * @brief  Sets up the conversion with the scale and offset of the recording.
+  */
+int
+ADCReplayConvert(ADC_Replay *rp, ADC_Convert *conv)
+{
+	if (NULL == rp)
+		return(-1);
+
+	return(ADCConvertInit(conv, rp->hdr->num_channels, rp->hdr->scale, rp->hdr->offset));
+}
+
+void
+ADCReplayClose(ADC_Replay *rp)
+{
+	if (NULL == rp)
+		return;
+
+	if (NULL != rp->map && MAP_FAILED != rp->map)
+		munmap((void *)rp->map, rp->size);
+	close(rp->fd);
+	free(rp);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
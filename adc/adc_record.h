@@ -0,0 +1,116 @@
+/**
+  ******************************************************************************
+  * @file    adc_record.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the ADC and
+  *          GPIO stream recorder.
+  *
+  * @details Provides the following functionality:
+  *          - Preallocated, memory mapped, append-only recording file
+  *          - Timestamped blocks of ADC scans, stored per channel
+  *          - GPIO edge events in the same file
+  *          - Block index for offline analysis
+  *          - Replay through IIOBufferRead() and GPIOEventWait()
+  ******************************************************************************
+  * @defgroup ADC_Record ADC Stream Recorder
+  * @brief File layout, recorder and replay state
+  * @{
+  */
+
+#ifndef __ADC_RECORD_H
+#define __ADC_RECORD_H
+
+#include <stdint.h>
+#include "iio_buffer.h"
+#include "adc_convert.h"
+#include "gpio_event.h"
+
+#define ADC_RECORD_MAGIC	0x31524358	/* "XCR1" */
+#define ADC_RECORD_VERSION	1
+#define ADC_RECORD_HEADER	4096	/* bytes reserved for the file header */
+#define ADC_RECORD_EDGES	256	/* GPIO events staged per block */
+
+#define ADC_RECORD_SCANS	1	/* block of ADC scans */
+#define ADC_RECORD_GPIO		2	/* block of GPIO events */
+
+/*
+ * File: header | index | blocks. Every block starts with an int64
+ * timestamp column of count entries, followed by one int32 column per
+ * channel (ADC) or the bank, gpio and edge columns (GPIO).
+ */
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t num_channels;
+	uint32_t index_max;	/* entries reserved for the index */
+	int32_t channel[IIO_SCAN_MAX];	/* N of in_voltageN, in sample order */
+	double scale[IIO_SCAN_MAX];	/* mV per count */
+	double offset[IIO_SCAN_MAX];	/* counts added before scaling */
+	double sample_rate;	/* scans per second, 0 if unknown */
+	uint64_t index_offset;
+	uint64_t data_offset;
+	uint64_t capacity;	/* preallocated file size */
+	uint64_t data_end;	/* end of the last complete block */
+	uint32_t num_blocks;	/* published once the block and its entry are written */
+	uint32_t closed;	/* 1 after ADCRecordClose() */
+	uint64_t scans;
+	uint64_t events;
+} ADC_RecordHeader;
+
+typedef struct {
+	uint64_t offset;	/* from the start of the file */
+	uint32_t type;		/* ADC_RECORD_SCANS or ADC_RECORD_GPIO */
+	uint32_t count;		/* scans or events */
+	int64_t first_ns;
+	int64_t last_ns;
+} ADC_RecordIndex;
+
+typedef struct {
+	int fd;
+	uint8_t *map;
+	ADC_RecordHeader *hdr;
+	ADC_RecordIndex *index;
+	int64_t period_ns;	/* spacing of scans recorded without timestamps */
+	int full;
+	int num_events;
+	GPIO_Event events[ADC_RECORD_EDGES];	/* staged until a block is full */
+} ADC_Recorder;
+
+typedef struct {
+	int fd;
+	const uint8_t *map;
+	size_t size;
+	const ADC_RecordHeader *hdr;
+	const ADC_RecordIndex *index;
+	uint32_t num_blocks;
+	double speed;		/* 0 as fast as possible, 1 real time */
+	int64_t start_ns;	/* recording time at the start of the replay */
+	int64_t wall_ns;	/* CLOCK_MONOTONIC at the start of the replay */
+	uint32_t scan_block;	/* ADC cursor */
+	uint32_t scan_pos;
+	uint32_t event_block;	/* GPIO cursor */
+	uint32_t event_pos;
+} ADC_Replay;
+
+/** @} */
+
+extern ADC_Recorder *ADCRecordCreate(const char *path, uint64_t capacity, const int *channels,
+				     int num, const ADC_Convert *conv, double sample_rate);
+extern int ADCRecordScans(ADC_Recorder *rec, const int32_t *samples,
+			  const int64_t *timestamps, int scans);
+extern int ADCRecordEvents(ADC_Recorder *rec, const GPIO_Event *events, int num);
+extern int ADCRecordSync(ADC_Recorder *rec);
+extern void ADCRecordClose(ADC_Recorder *rec);
+extern ADC_Replay *ADCReplayOpen(const char *path, double speed);
+extern int ADCReplayScans(ADC_Replay *rp, int32_t *samples, int64_t *timestamps,
+			  int max_scans, int timeout_ms);
+extern int ADCReplayEvents(ADC_Replay *rp, GPIO_Event *events, int max, int timeout_ms);
+extern IIO_Buffer *ADCReplayBuffer(ADC_Replay *rp);
+extern int ADCReplayGPIO(ADC_Replay *rp, GPIO_EventSet *set);
+extern int ADCReplayConvert(ADC_Replay *rp, ADC_Convert *conv);
+extern void ADCReplayClose(ADC_Replay *rp);
+
+
+#endif /*__ADC_RECORD_H */
@@ -1,94 +1,159 @@
 /**
   ******************************************************************************
   * @file    adc_test.c
-  * @author  Name, Calixto Firmware Team 
+  * @author  Name, Calixto Firmware Team
   * @version V1.0.0
   * @date    4-June-2025
-  * @brief   This file provides functions to manage ADC reading through Linux IIO:
+  * @brief   This file demonstrates ADC reading through Linux IIO:
   *           - Single channel ADC reading
-  *           - Sysfs interface for IIO devices     
+  *           - Buffered multichannel capture
+  *           - Recording and replay of a capture
   *           - Continuous monitoring capability
   *
   *  @verbatim
-  *    
+  *
   *          ===================================================================
-  *                             Working of IIO ADC Interface
+  *                             Working of the ADC Example
   *          ===================================================================
-  *          
-  *          IIO Subsystem Architecture
-  *          =====================  
-  *          - Uses Linux Industrial I/O subsystem (IIO)
-  *          - Reads raw ADC values through sysfs interface
-  *          - Path format: /sys/bus/iio/devices/iio:deviceX/in_voltageY_raw
-  *          - Returns raw integer values that need scaling to voltage
   *
-  *          ADC Conversion Process
-  *          =======================  
-  *          1. Opens the channel-specific sysfs file
-  *          2. Reads the raw ADC value (0-4095 typical)
-  *          3. Converts string value to integer
-  *          4. Returns raw ADC count or -1 on error
-  *  
-  *          ===================================================================      
-  *                              How to use this driver
-  *          ===================================================================          
-  *            - Include necessary headers (stdio.h, stdlib.h, fcntl.h etc.)
-  *            - Call ADC_Read(channel) to get raw ADC value
-  *            - Channel numbers are hardware dependent (check device tree)
-  *            - Compile with: gcc adc.c -o adc_app
+  *          - Without arguments channel 5 is read once a second through
+  *            ADC_Read()
+  *          - With -b the channels given on the command line are captured
+  *            through the IIO buffer; the first scan of every block and the
+  *            scan rate are printed once a second
+  *          - With -r the capture is written to a recording file through
+  *            adc_record.c instead, only the scan rate is printed
+  *          - With -p a recording is played back in real time through the
+  *            same capture loop, no ADC is needed
+  *
+  *          ===================================================================
+  *                              How to use this example
+  *          ===================================================================
+  *            - Compile with: gcc -I../gpio iio_adc.c iio_buffer.c adc_convert.c
+  *                            adc_record.c adc_test.c -o adc_app
   *            - Run with: sudo ./adc_app
+  *            - Run with: sudo ./adc_app -b [trigger] 0 1 2 3
+  *              (trigger as listed in /sys/bus/iio/devices/triggerN/name,
+  *              "-" for ADCs that sample without one)
+  *            - Run with: sudo ./adc_app -r capture.rec [trigger] 0 1 2 3
+  *            - Run with: ./adc_app -p capture.rec
   *            - Ensure IIO device is enabled in kernel
-  * 
-  *          Example Usage:
-  *            // Read channel 5 continuously
-  *            while(1) {
-  *                int val = ADC_Read(5);
-  *                printf("ADC Value: %d\n", val);
-  *                sleep(1);
-  *            }
   *
   *  @endverbatim
-  *    
+  *
   ******************************************************************************
-  * 
+  *
   * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
-  ******************************************************************************  
+  ******************************************************************************
   */
 
-#include <sys/stat.h>
-#include <sys/types.h>
-#include <fcntl.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include "iio_adc.h"
+#include "iio_buffer.h"
+#include "adc_convert.h"
+#include "adc_record.h"
+
+#define BLOCK_SCANS	256
+#define RECORD_SIZE	(256ULL << 20)	/* bytes reserved for a recording */
 
-int
-ADC_Read(int channel)
+static int
+OpenCapture(int argc, char *argv[], int first, IIO_Buffer **adc, ADC_Recorder **rec,
+	    const char *record)
 {
-#define VALUE_MAX 30
-	char path[VALUE_MAX];
-	char value_str[4];
-	int fd;
- 
-	snprintf(path, VALUE_MAX, "/sys/bus/iio/devices/iio\\:device0/in_voltage%d_raw", channel);
-	fd = open(path, O_RDONLY);
-	if (-1 == fd) {
-		fprintf(stderr, "Failed to open %s for reading!\n",path);
+	const char *trigger = NULL;
+	int channels[IIO_SCAN_MAX];
+	ADC_Convert conv;
+	int num = 0;
+	int i;
+
+	if (argc > first && strcmp(argv[first], "-"))
+		trigger = argv[first];
+	for (i = first + 1; i < argc && num < IIO_SCAN_MAX; i++)
+		channels[num++] = atoi(argv[i]);
+	if (0 == num)
+		channels[num++] = 5;
+
+	*adc = IIOBufferOpen(0, channels, num, trigger, 4 * BLOCK_SCANS, 0);
+	if (NULL == *adc)
 		return(-1);
+
+	if (NULL != record) {
+		ADCConvertInitDevice(&conv, 0, channels, num);
+		*rec = ADCRecordCreate(record, RECORD_SIZE, channels, num, &conv, 0);
+		if (NULL == *rec) {
+			IIOBufferClose(*adc);
+			return(-1);
+		}
 	}
- 
-	if (-1 == read(fd, value_str, 4)) {
-		fprintf(stderr, "Failed to read value!\n");
-		return(-1);
+
+	return(0);
+}
+
+static int
+BufferedCapture(IIO_Buffer *adc, ADC_Recorder *rec)
+{
+	static int32_t samples[BLOCK_SCANS * IIO_SCAN_MAX];
+	static int64_t stamps[BLOCK_SCANS];
+	int64_t *timestamps = (adc->timestamp.channel >= 0) ? stamps : NULL;
+	time_t last = time(NULL);
+	uint64_t scans = 0;
+	int n;
+	int i;
+
+	while (1) {
+		n = IIOBufferRead(adc, samples, timestamps, BLOCK_SCANS, 1000);
+		if (n < 0)
+			break;
+		scans += n;
+		if (NULL != rec && n > 0)
+			ADCRecordScans(rec, samples, timestamps, n);
+
+		if (time(NULL) != last) {
+			last = time(NULL);
+			printf("\r\n %llu scans/s:", (unsigned long long)scans);
+			for (i = 0; i < adc->num_channels && n > 0 && NULL == rec; i++)
+				printf(" ch%d=%d", adc->channels[i].channel, samples[adc->channels[i].slot]);
+			fflush(stdout);
+			scans = 0;
+		}
 	}
- 
-	close(fd);
- 
-	return(atoi(value_str));
+
+	/* a replay ends with ENODATA once the recording is played */
+	return((ENODATA == errno) ? 0 : 1);
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+	ADC_Recorder *rec = NULL;
+	ADC_Replay *rp = NULL;
+	IIO_Buffer *adc = NULL;
+	int ret;
+
+	if (argc > 1 && 0 == strcmp(argv[1], "-b")) {
+		if (OpenCapture(argc, argv, 2, &adc, &rec, NULL))
+			return 1;
+	} else if (argc > 2 && 0 == strcmp(argv[1], "-r")) {
+		if (OpenCapture(argc, argv, 3, &adc, &rec, argv[2]))
+			return 1;
+	} else if (argc > 2 && 0 == strcmp(argv[1], "-p")) {
+		rp = ADCReplayOpen(argv[2], 1.0);
+		adc = ADCReplayBuffer(rp);
+		if (NULL == adc)
+			return 1;
+	}
+
+	if (NULL != adc) {
+		ret = BufferedCapture(adc, rec);
+		ADCRecordClose(rec);
+		IIOBufferClose(adc);
+		ADCReplayClose(rp);
+		return ret;
+	}
 
     while(1)
 	{
@@ -0,0 +1,331 @@
+/**
+  ******************************************************************************
+  * @file    adc_trigger.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides ADC capture triggered by GPIO edges:
+  *           - Immediate scan of the channels on every edge
+  *           - Buffered burst of scans from the edge on
+  *           - Edge and sample timestamps on CLOCK_MONOTONIC, so the skew
+  *             between the event and the samples is known
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Trigger
+  *          ===================================================================
+  *
+  *          Scan Mode
+  *          =====================
+  *          - ADCTriggerWait() sleeps in GPIOEventWait() on the trigger
+  *            pins and reads the channels with ADC_Scan() as soon as it
+  *            wakes: no polling loop, no sleep() between checks
+  *          - The channel files are opened at setup, a trigger costs one
+  *            pread() per channel
+  *          - sample_ns is taken right before the first read, read_ns is
+  *            the time all channels took
+  *          - Edges that arrived together are served once, for the newest
+  *            edge; the others are counted in missed
+  *
+  *          Burst Mode
+  *          =======================
+  *          - The IIO buffer runs continuously with per-scan timestamps;
+  *            IIOBufferOpen() puts them on CLOCK_MONOTONIC, the clock of
+  *            the GPIO events, and the burst setup checks it still is
+  *          - On an edge, scans stamped before the edge are dropped and the
+  *            next burst scans are handed out, so the first sample is the
+  *            first conversion after the edge whatever the wake-up latency
+  *          - Edges are served in order, one burst per call; edges that
+  *            fall inside a burst already handed out are counted in missed
+  *
+  *          Skew
+  *          =======================
+  *          - skew_ns = sample_ns - edge_ns
+  *          - With the chardev GPIO backend edge_ns is the kernel interrupt
+  *            time, so the skew includes the wake-up latency; with sysfs it
+  *            is taken on wake-up and the latency is hidden
+  *          - Run the waiting thread SCHED_FIFO with locked memory to keep
+  *            the scan mode skew in the tens of microseconds
+  *          - For skew below one conversion use an IIO interrupt trigger on
+  *            the pin (iio-trig-interrupt) as the trigger of IIOBufferOpen():
+  *            the kernel then starts one scan per edge itself
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "adc_trigger.h" in your application
+  *            - Create a GPIO event set with the trigger pins
+  *            - Scan mode: ADCTriggerScan() with the channels
+  *            - Burst mode: open the capture with timestamps, then
+  *              ADCTriggerBurst()
+  *            - Call ADCTriggerWait() in a loop
+  *            - Compile with: gcc -O2 -I../gpio iio_adc.c iio_buffer.c adc_trigger.c
+  *                            ../gpio/sysfs_gpio.c ../gpio/gpio_chardev.c
+  *                            ../gpio/gpio_mmap.c ../gpio/gpio_event.c
+  *                            ../gpio/gpio_thread.c your_app.c
+  *                            -lpthread
+  *
+  *          Example Usage:
+  *            GPIO_EventSet *set = GPIOEventSetCreate();
+  *            ADC_TriggerEvent ev;
+  *            ADC_Trigger *trig;
+  *            int ch[2] = { 0, 1 };
+  *
+  *            GPIOInit(2, 24, IN);
+  *            GPIOEventSetAdd(set, 2, 24, GPIO_EDGE_RISING);   // encoder index
+  *            trig = ADCTriggerScan(set, ch, 2);
+  *            while (ADCTriggerWait(trig, &ev, -1) >= 0)
+  *                printf("ch0=%d ch1=%d, %lld ns after the edge\n",
+  *                       ev.samples[0], ev.samples[1], (long long)ev.skew_ns);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "adc_trigger.h"
+
+static int64_t
+ADCTriggerNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+static ADC_Trigger *
+ADCTriggerAlloc(GPIO_EventSet *set, int mode, int num, int burst)
+{
+	ADC_Trigger *trig;
+
+	trig = calloc(1, sizeof(*trig));
+	if (NULL == trig)
+		return(NULL);
+
+	trig->mode = mode;
+	trig->set = set;
+	trig->num_channels = num;
+	trig->burst = burst;
+	trig->samples = malloc((size_t)burst * num * sizeof(*trig->samples));
+	trig->timestamps = malloc((size_t)burst * sizeof(*trig->timestamps));
+	if (NULL == trig->samples || NULL == trig->timestamps) {
+		ADCTriggerClose(trig);
+		return(NULL);
+	}
+
+	return(trig);
+}
+
+/**
+  * @brief  Sets up a scan of the channels on every edge of the set.
+  * @param  set: GPIO event set holding the trigger pins
+  * @param  channels: N of each in_voltageN, in sample order
+  * @param  num: number of channels
+  * @retval Trigger, NULL on error
+  */
+ADC_Trigger *
+ADCTriggerScan(GPIO_EventSet *set, const int *channels, int num)
+{
+	int values[IIO_SCAN_MAX];
+	ADC_Trigger *trig;
+
+	if (NULL == set || NULL == channels || num < 1 || num > IIO_SCAN_MAX) {
+		fprintf(stderr, "Invalid ADC trigger setup!\n");
+		return(NULL);
+	}
+
+	trig = ADCTriggerAlloc(set, ADC_TRIGGER_SCAN, num, 1);
+	if (NULL == trig)
+		return(NULL);
+
+	memcpy(trig->channel, channels, num * sizeof(*channels));
+
+	/* opens the channel files now rather than on the first edge */
+	if (ADC_Scan(trig->channel, num, values))
+		fprintf(stderr, "ADC channels not readable yet!\n");
+
+	return(trig);
+}
+
+/**
+  * @brief  Sets up a burst of buffered scans on every edge of the set.
+  * @param  set: GPIO event set holding the trigger pins
+  * @param  buf: capture opened with timestamps, kept running by the caller
+  * @param  scans: scans per burst
+  * @retval Trigger, NULL on error
+  */
+ADC_Trigger *
+ADCTriggerBurst(GPIO_EventSet *set, IIO_Buffer *buf, int scans)
+{
+	ADC_Trigger *trig;
+
+	if (NULL == set || NULL == buf || scans < 1) {
+		fprintf(stderr, "Invalid ADC trigger setup!\n");
+		return(NULL);
+	}
+
+	if (-1 == buf->timestamp.channel) {
+		fprintf(stderr, "Burst trigger needs a capture opened with timestamps!\n");
+		return(NULL);
+	}
+
+	trig = ADCTriggerAlloc(set, ADC_TRIGGER_BURST, buf->num_channels, scans);
+	if (NULL == trig)
+		return(NULL);
+
+	trig->buf = buf;
+	if (IIOBufferClock(buf->device)) {
+		ADCTriggerClose(trig);
+		return(NULL);
+	}
+	return(trig);
+}
+
+static int
+ADCTriggerScanRead(ADC_Trigger *trig, ADC_TriggerEvent *ev)
+{
+	int values[IIO_SCAN_MAX];
+	int64_t start;
+	int i;
+
+	start = ADCTriggerNow();
+	if (ADC_Scan(trig->channel, trig->num_channels, values))
+		return(-1);
+	ev->read_ns = ADCTriggerNow() - start;
+
+	for (i = 0; i < trig->num_channels; i++)
+		trig->samples[i] = values[i];
+	trig->timestamps[0] = start;
+	ev->scans = 1;
+	return(0);
+}
+
+static int
+ADCTriggerBurstRead(ADC_Trigger *trig, const GPIO_Event *edge, int timeout_ms)
+{
+	int num = trig->num_channels;
+	int64_t edge_ns = (int64_t)edge->timestamp_ns;
+	int got = 0;
+	int n;
+	int i;
+
+	while (got < trig->burst) {
+		n = IIOBufferRead(trig->buf, trig->samples + (size_t)got * num,
+				  trig->timestamps + got, trig->burst - got, timeout_ms);
+		if (n <= 0)
+			break;
+
+		/* drop the backlog converted before the edge */
+		for (i = 0; i < n && trig->timestamps[got + i] < edge_ns; i++)
+			;
+		if (i > 0) {
+			memmove(trig->samples + (size_t)got * num,
+				trig->samples + (size_t)(got + i) * num,
+				(size_t)(n - i) * num * sizeof(*trig->samples));
+			memmove(trig->timestamps + got, trig->timestamps + got + i,
+				(size_t)(n - i) * sizeof(*trig->timestamps));
+		}
+		got += n - i;
+	}
+
+	if (got > 0)
+		trig->last_ns = trig->timestamps[got - 1];
+	return(got);
+}
+
+/**
+  * @brief  Waits for a trigger edge and captures the samples that go with it.
+  * @param  trig: trigger
+  * @param  ev: triggered capture, samples valid until the next call
+  * @param  timeout_ms: -1 waits forever, otherwise for the edge and for each
+  *                     buffered read of a burst
+  * @retval 1 on a capture, 0 on timeout or if every pending edge was missed,
+  *         -1 on error
+  */
+int
+ADCTriggerWait(ADC_Trigger *trig, ADC_TriggerEvent *ev, int timeout_ms)
+{
+	const GPIO_Event *edge = NULL;
+	int n;
+
+	if (NULL == trig || NULL == ev)
+		return(-1);
+
+	if (ADC_TRIGGER_SCAN == trig->mode) {
+		n = GPIOEventWait(trig->set, trig->events, ADC_TRIGGER_EVENTS, timeout_ms);
+		if (n <= 0)
+			return(n);
+
+		/* the samples are taken now, they belong to the newest edge */
+		edge = &trig->events[n - 1];
+		trig->missed += n - 1;
+	} else {
+		if (trig->next_event == trig->num_events) {
+			n = GPIOEventWait(trig->set, trig->events, ADC_TRIGGER_EVENTS, timeout_ms);
+			if (n <= 0)
+				return(n);
+			trig->num_events = n;
+			trig->next_event = 0;
+		}
+
+		/* the oldest edge after the last burst, later ones wait for the next call */
+		while (trig->next_event < trig->num_events) {
+			edge = &trig->events[trig->next_event++];
+			if ((int64_t)edge->timestamp_ns > trig->last_ns)
+				break;
+			trig->missed++;
+			edge = NULL;
+		}
+		if (NULL == edge)
+			return(0);
+	}
+
+	memset(ev, 0, sizeof(*ev));
+	ev->bank = edge->bank;
+	ev->gpio = edge->gpio;
+	ev->edge = edge->edge;
+	ev->edge_ns = (int64_t)edge->timestamp_ns;
+	ev->samples = trig->samples;
+	ev->timestamps = trig->timestamps;
+
+	if (ADC_TRIGGER_SCAN == trig->mode) {
+		if (ADCTriggerScanRead(trig, ev)) {
+			fprintf(stderr, "Failed to read triggered ADC scan!\n");
+			return(-1);
+		}
+	} else {
+		ev->scans = ADCTriggerBurstRead(trig, edge, timeout_ms);
+		if (0 == ev->scans) {
+			fprintf(stderr, "No ADC scans after the trigger edge!\n");
+			return(-1);
+		}
+	}
+
+	ev->sample_ns = trig->timestamps[0];
+	ev->skew_ns = ev->sample_ns - ev->edge_ns;
+	trig->triggers++;
+	return(1);
+}
+
+void
+ADCTriggerClose(ADC_Trigger *trig)
+{
+	if (NULL == trig)
+		return;
+
+	free(trig->samples);
+	free(trig->timestamps);
+	free(trig);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    adc_trigger.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for GPIO
+  *          triggered ADC capture.
+  *
+  * @details Provides the following functionality:
+  *          - One ADC scan per GPIO edge
+  *          - Buffered burst of scans starting at a GPIO edge
+  *          - Edge and sample timestamps on the same clock
+  *          - Count of edges that could not be served
+  ******************************************************************************
+  * @defgroup ADC_Trigger ADC GPIO Trigger
+  * @brief Trigger state and triggered capture record
+  * @{
+  */
+
+#ifndef __ADC_TRIGGER_H
+#define __ADC_TRIGGER_H
+
+#include <stdint.h>
+#include "iio_buffer.h"
+#include "gpio_event.h"
+
+#define ADC_TRIGGER_SCAN	0	/* ADC_Scan() on every edge */
+#define ADC_TRIGGER_BURST	1	/* buffered scans from the edge on */
+#define ADC_TRIGGER_EVENTS	16	/* GPIO events fetched per wait */
+
+typedef struct {
+	int bank;		/* pin that triggered */
+	int gpio;
+	int edge;		/* GPIO_EDGE_RISING or GPIO_EDGE_FALLING */
+	int64_t edge_ns;	/* GPIO event time, CLOCK_MONOTONIC */
+	int64_t sample_ns;	/* time of the first scan */
+	int64_t skew_ns;	/* sample_ns - edge_ns */
+	int64_t read_ns;	/* duration of the scan (scan mode) */
+	int scans;		/* scans in samples, short if the ADC stalled */
+	const int32_t *samples;	/* scans * num_channels, valid until the next wait */
+	const int64_t *timestamps;	/* one per scan */
+} ADC_TriggerEvent;
+
+typedef struct {
+	int mode;		/* ADC_TRIGGER_SCAN or ADC_TRIGGER_BURST */
+	GPIO_EventSet *set;	/* trigger pins, owned by the caller */
+	int num_channels;
+	int channel[IIO_SCAN_MAX];	/* scan mode: N of each in_voltageN */
+	IIO_Buffer *buf;	/* burst mode: running capture, owned by the caller */
+	int burst;		/* scans per trigger */
+	int32_t *samples;	/* burst * num_channels */
+	int64_t *timestamps;	/* burst */
+	int64_t last_ns;	/* last scan handed out */
+	uint64_t triggers;	/* edges served */
+	uint64_t missed;	/* edges not served: queued behind another or inside a burst */
+	int num_events;		/* edges fetched, burst mode serves them one by one */
+	int next_event;
+	GPIO_Event events[ADC_TRIGGER_EVENTS];
+} ADC_Trigger;
+
+/** @} */
+
+extern ADC_Trigger *ADCTriggerScan(GPIO_EventSet *set, const int *channels, int num);
+extern ADC_Trigger *ADCTriggerBurst(GPIO_EventSet *set, IIO_Buffer *buf, int scans);
+extern int ADCTriggerWait(ADC_Trigger *trig, ADC_TriggerEvent *ev, int timeout_ms);
+extern void ADCTriggerClose(ADC_Trigger *trig);
+
+
+#endif /*__ADC_TRIGGER_H */
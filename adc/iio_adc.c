@@ -0,0 +1,407 @@
+/**
+  ******************************************************************************
+  * @file    iio_adc.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides functions to manage ADC reading through Linux IIO:
+  *           - Single channel ADC reading
+  *           - Multi-channel scans on cached channel files
+  *           - Sysfs interface for IIO devices
+  *           - Attribute helpers for the buffered capture
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of IIO ADC Interface
+  *          ===================================================================
+  *
+  *          IIO Subsystem Architecture
+  *          =====================
+  *          - Uses Linux Industrial I/O subsystem (IIO)
+  *          - Reads raw ADC values through sysfs interface
+  *          - Path format: /sys/bus/iio/devices/iio:deviceX/in_voltageY_raw
+  *          - Returns raw integer values that need scaling to voltage
+  *
+  *          ADC Conversion Process
+  *          =======================
+  *          1. Opens the channel-specific sysfs file on first use and keeps
+  *             the fd
+  *          2. Reads the raw ADC value (0-4095 typical) with one pread() at
+  *             offset 0, which makes sysfs sample the channel again
+  *          3. Converts the string value to integer, stopping at the newline
+  *          4. Returns raw ADC count or -1 on error
+  *
+  *          Channel Scans
+  *          =======================
+  *          - ADC_Scan() reads a list of channels, one pread() per channel
+  *            and no path formatting or open() after the first scan
+  *          - Each sysfs read is a separate conversion; for simultaneous
+  *            samples or kHz rates use the buffered capture in iio_buffer.c
+  *          - The fd cache is not locked: scan from one thread, or give
+  *            every thread its own channels
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "iio_adc.h" in your application
+  *            - Call ADC_Read(channel) to get raw ADC value
+  *            - Call ADC_Scan(channels, n, out) to read several channels
+  *            - Call ADC_SetDevice(n) first if the ADC is not iio:device0
+  *            - Channel numbers are hardware dependent (check device tree)
+  *            - Find the device and channels by name, see iio_discover.c
+  *            - Capture many samples per syscall, see iio_buffer.c
+  *            - Compile with: gcc iio_adc.c your_app.c -o adc_app
+  *            - Run with: sudo ./adc_app
+  *            - Ensure IIO device is enabled in kernel
+  *
+  *          Example Usage:
+  *            // Read channel 5 continuously
+  *            while(1) {
+  *                int val = ADC_Read(5);
+  *                printf("ADC Value: %d\n", val);
+  *                sleep(1);
+  *            }
+  *
+  *            // Read 8 channels per cycle
+  *            int ch[8] = { 0, 1, 2, 3, 4, 5, 6, 7 }, raw[8];
+  *            if (0 == ADC_Scan(ch, 8, raw))
+  *                process(raw);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "iio_adc.h"
+
+static char s_sys_root[IIO_ROOT_MAX] = IIO_ROOT;
+static char s_dev_root[IIO_ROOT_MAX] = IIO_DEV_ROOT;
+
+/**
+  * @brief  Moves the IIO tree, e.g. to a fake tree for tests.
+  * @param  sys_root: replaces /sys/bus/iio/devices, NULL keeps it
+  * @param  dev_root: directory of the iio:deviceN nodes, NULL keeps it
+  * @retval 0 on success, -1 if a path is too long
+  */
+int
+IIOSetRoot(const char *sys_root, const char *dev_root)
+{
+	if ((sys_root && strlen(sys_root) >= IIO_ROOT_MAX) ||
+	    (dev_root && strlen(dev_root) >= IIO_ROOT_MAX)) {
+		fprintf(stderr, "IIO root path too long!\n");
+		return(-1);
+	}
+
+	if (sys_root)
+		strcpy(s_sys_root, sys_root);
+	if (dev_root)
+		strcpy(s_dev_root, dev_root);
+	return(0);
+}
+
+/**
+  * @brief  Formats the path of a device attribute, e.g.
+  *         IIODevicePath(path, 0, "scan_elements/in_voltage%d_en", 5).
+  * @param  path: destination of IIO_PATH_MAX bytes
+  * @param  device: N of iio:deviceN
+  * @param  fmt: attribute relative to the device directory
+  * @retval 0 on success, -1 if the path does not fit
+  */
+int
+IIODevicePath(char *path, int device, const char *fmt, ...)
+{
+	va_list ap;
+	int len;
+	int ret;
+
+	len = snprintf(path, IIO_PATH_MAX, "%s/iio:device%d/", s_sys_root, device);
+	if (len >= IIO_PATH_MAX)
+		return(-1);
+
+	va_start(ap, fmt);
+	ret = vsnprintf(path + len, IIO_PATH_MAX - len, fmt, ap);
+	va_end(ap);
+
+	return((ret < 0 || ret >= IIO_PATH_MAX - len) ? -1 : 0);
+}
+
+const char *
+IIOSysRoot(void)
+{
+	return(s_sys_root);
+}
+
+int
+IIODeviceNode(char *path, int device)
+{
+	int len;
+
+	len = snprintf(path, IIO_PATH_MAX, "%s/iio:device%d", s_dev_root, device);
+	return((len >= IIO_PATH_MAX) ? -1 : 0);
+}
+
+/**
+  * @brief  Reads a sysfs attribute as a string without the trailing newline.
+  * @param  path: attribute path
+  * @param  buf: destination
+  * @param  size: size of buf
+  * @retval Length of the string, -1 on error
+  */
+int
+IIOReadAttr(const char *path, char *buf, size_t size)
+{
+	ssize_t len;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (-1 == fd)
+		return(-1);
+
+	len = read(fd, buf, size - 1);
+	close(fd);
+	if (len < 0)
+		return(-1);
+
+	while (len > 0 && ('\n' == buf[len - 1] || ' ' == buf[len - 1]))
+		len--;
+	buf[len] = '\0';
+
+	return((int)len);
+}
+
+/**
+  * @brief  Writes a string to a sysfs attribute.
+  * @retval 0 on success, -1 on error
+  */
+int
+IIOWriteAttr(const char *path, const char *value)
+{
+	ssize_t len;
+	int fd;
+
+	fd = open(path, O_WRONLY | O_CLOEXEC);
+	if (-1 == fd) {
+		fprintf(stderr, "Failed to open %s for writing!\n", path);
+		return(-1);
+	}
+
+	len = write(fd, value, strlen(value));
+	close(fd);
+	if (len != (ssize_t)strlen(value)) {
+		fprintf(stderr, "Failed to write %s!\n", path);
+		return(-1);
+	}
+
+	return(0);
+}
+
+int
+IIOWriteInt(const char *path, long value)
+{
+	char buf[24];
+
+	snprintf(buf, sizeof(buf), "%ld\n", value);
+	return(IIOWriteAttr(path, buf));
+}
+
+/**
+  * @brief  Finds a voltage channel attribute, per channel or shared.
+  * @param  attr: e.g. "scale" for in_voltageN_scale, else in_voltage_scale
+  * @param  path: destination of IIO_PATH_MAX bytes, "" if neither exists
+  * @retval 0 if found, -1 otherwise
+  */
+int
+IIOChannelAttr(int device, int channel, const char *attr, char *path)
+{
+	if (0 == IIODevicePath(path, device, "in_voltage%d_%s", channel, attr) &&
+	    0 == access(path, R_OK))
+		return(0);
+
+	if (0 == IIODevicePath(path, device, "in_voltage_%s", attr) &&
+	    0 == access(path, R_OK))
+		return(0);
+
+	path[0] = '\0';
+	return(-1);
+}
+
+/**
+  * @brief  Reads a decimal attribute such as in_voltage_scale.
+  * @retval The value, fallback if path is "" or unreadable
+  */
+double
+IIOReadDouble(const char *path, double fallback)
+{
+	char value[ADC_VALUE_MAX * 2];
+
+	if ('\0' == path[0] || IIOReadAttr(path, value, sizeof(value)) < 1)
+		return(fallback);
+
+	return(strtod(value, NULL));
+}
+
+static int s_adc_device;
+static int s_raw_fd[ADC_MAX_CHANNELS];
+static int s_raw_init;
+
+/**
+  * @brief  Parses a decimal sysfs value, stops at the newline.
+  * @retval 0 on success, -1 if buf holds no number
+  */
+static int
+ADCParseInt(const char *buf, int len, int *value)
+{
+	int negative = 0;
+	int digits = 0;
+	int v = 0;
+	int i = 0;
+
+	if (len > 0 && '-' == buf[0]) {
+		negative = 1;
+		i++;
+	}
+
+	for (; i < len && buf[i] >= '0' && buf[i] <= '9'; i++, digits++)
+		v = v * 10 + (buf[i] - '0');
+
+	if (0 == digits)
+		return(-1);
+
+	*value = negative ? -v : v;
+	return(0);
+}
+
+/* returns the cached in_voltageN_raw fd, opening it on first use */
+static int
+ADCRawFd(int channel)
+{
+	char path[IIO_PATH_MAX];
+	int i;
+
+	if (channel < 0 || channel >= ADC_MAX_CHANNELS) {
+		fprintf(stderr, "Invalid ADC channel %d!\n", channel);
+		return(-1);
+	}
+
+	if (!s_raw_init) {
+		for (i = 0; i < ADC_MAX_CHANNELS; i++)
+			s_raw_fd[i] = -1;
+		s_raw_init = 1;
+	}
+
+	if (-1 != s_raw_fd[channel])
+		return(s_raw_fd[channel]);
+
+	if (IIODevicePath(path, s_adc_device, "in_voltage%d_raw", channel))
+		return(-1);
+
+	s_raw_fd[channel] = open(path, O_RDONLY | O_CLOEXEC);
+	if (-1 == s_raw_fd[channel])
+		fprintf(stderr, "Failed to open %s for reading!\n", path);
+
+	return(s_raw_fd[channel]);
+}
+
+/**
+  * @brief  Reads a raw value from an open sysfs attribute.
+  * @note   One pread() at offset 0, sysfs regenerates the value on every one.
+  * @retval 0 on success, -1 on error
+  */
+int
+IIOReadFd(int fd, int *value)
+{
+	char buf[ADC_VALUE_MAX];
+	ssize_t len;
+
+	len = pread(fd, buf, sizeof(buf), 0);
+	if (len <= 0)
+		return(-1);
+
+	return(ADCParseInt(buf, (int)len, value));
+}
+
+/**
+  * @brief  Selects the iio:deviceN read by ADC_Read() and ADC_Scan().
+  * @param  device: N of iio:deviceN, 0 by default
+  */
+void
+ADC_SetDevice(int device)
+{
+	ADC_Close();
+	s_adc_device = device;
+}
+
+int
+ADC_Read(int channel)
+{
+	int value;
+	int fd;
+
+	fd = ADCRawFd(channel);
+	if (-1 == fd)
+		return(-1);
+
+	if (IIOReadFd(fd, &value)) {
+		fprintf(stderr, "Failed to read value!\n");
+		return(-1);
+	}
+
+	return(value);
+}
+
+/**
+  * @brief  Reads several channels, one pread() each on cached fds.
+  * @param  channels: N of each in_voltageN
+  * @param  n: number of channels
+  * @param  out: raw values in the order of channels, -1 for a failed channel
+  * @retval 0 on success, -1 if any channel failed
+  */
+int
+ADC_Scan(const int *channels, int n, int *out)
+{
+	int ret = 0;
+	int fd;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		fd = ADCRawFd(channels[i]);
+		if (-1 == fd || IIOReadFd(fd, &out[i])) {
+			out[i] = -1;
+			ret = -1;
+		}
+	}
+
+	return(ret);
+}
+
+/**
+  * @brief  Closes the cached channel files.
+  */
+void
+ADC_Close(void)
+{
+	int i;
+
+	if (!s_raw_init)
+		return;
+
+	for (i = 0; i < ADC_MAX_CHANNELS; i++) {
+		if (-1 != s_raw_fd[i])
+			close(s_raw_fd[i]);
+		s_raw_fd[i] = -1;
+	}
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
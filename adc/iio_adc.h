@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    iio_adc.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the IIO
+  *          ADC driver.
+  *
+  * @details Provides the following functionality:
+  *          - Single channel ADC reading
+  *          - Multi-channel scans on cached channel files
+  *          - IIO sysfs path and attribute access shared by the ADC modules
+  ******************************************************************************
+  * @defgroup IIO_ADC IIO ADC
+  * @brief IIO sysfs paths and attribute helpers
+  * @{
+  */
+
+#ifndef __IIO_ADC_H
+#define __IIO_ADC_H
+
+#include <stddef.h>
+
+#define IIO_ROOT	"/sys/bus/iio/devices"
+#define IIO_DEV_ROOT	"/dev"
+#define IIO_PATH_MAX	128
+#define IIO_NAME_MAX	32
+#define IIO_ROOT_MAX	64	/* IIOSetRoot() path length incl. NUL */
+
+/* Channels covered by the fd cache, override with -DADC_MAX_CHANNELS=n */
+#ifndef ADC_MAX_CHANNELS
+#define ADC_MAX_CHANNELS	32
+#endif
+#define ADC_VALUE_MAX		16	/* longest raw value string */
+
+/** @} */
+
+extern void ADC_SetDevice(int device);
+extern int ADC_Read(int channel);
+extern int ADC_Scan(const int *channels, int n, int *out);
+extern void ADC_Close(void);
+extern int IIOSetRoot(const char *sys_root, const char *dev_root);
+extern int IIODevicePath(char *path, int device, const char *fmt, ...);
+extern const char *IIOSysRoot(void);
+extern int IIODeviceNode(char *path, int device);
+extern int IIOReadFd(int fd, int *value);
+extern int IIOReadAttr(const char *path, char *buf, size_t size);
+extern int IIOWriteAttr(const char *path, const char *value);
+extern int IIOWriteInt(const char *path, long value);
+extern int IIOChannelAttr(int device, int channel, const char *attr, char *path);
+extern double IIOReadDouble(const char *path, double fallback);
+
+
+#endif /*__IIO_ADC_H */
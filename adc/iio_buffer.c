@@ -0,0 +1,554 @@
+/**
+  ******************************************************************************
+  * @file    iio_buffer.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides buffered ADC capture through the IIO buffer
+  *          interface:
+  *           - Scan element selection and trigger setup
+  *           - Kernel buffer length and watermark
+  *           - Block reads of packed scans from /dev/iio:deviceN
+  *           - Decoding of the samples per channel type descriptor
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Buffered Capture
+  *          ===================================================================
+  *
+  *          Setup
+  *          =====================
+  *          - Only the requested channels are enabled in scan_elements/,
+  *            every other scan element is switched off
+  *          - The trigger, if given, is written to trigger/current_trigger;
+  *            ADCs sampling continuously on their own (e.g. the AM335x
+  *            TSC/ADC) need none
+  *          - buffer/length sets the kernel FIFO size, buffer/watermark the
+  *            number of scans that wakes a reader
+  *          - With timestamps, current_timestamp_clock is switched to
+  *            monotonic, the clock of the GPIO events and timerfds; the
+  *            kernel default is CLOCK_REALTIME
+  *          - buffer/enable starts the capture
+  *
+  *          Scan Layout
+  *          =======================
+  *          - The kernel packs one scan per trigger: the enabled elements in
+  *            scan index order, each aligned to its own storage size, the
+  *            whole scan padded to the largest element
+  *          - Each element is described by scan_elements/<name>_type, e.g.
+  *            "le:u12/16>>0": endianness, sign, valid bits / storage bits
+  *            and the shift of the valid bits
+  *          - The layout is computed once at open, decoding is a loop over
+  *            precomputed offsets
+  *
+  *          Reading
+  *          =======================
+  *          - One read() fetches up to a whole block of scans; a blocking
+  *            read returns once the watermark is reached, so a block costs a
+  *            single syscall
+  *          - With a timeout, poll() guards the read instead
+  *          - IIOBufferReadRaw() leaves the packed scans in buf->block for
+  *            callers that store or forward them without decoding
+  *
+  *          Replay
+  *          =======================
+  *          - A buffer with a replay hook (e.g. from ADCReplayBuffer() of
+  *            adc_record.c) has no device; IIOBufferRead() returns the
+  *            recorded samples and timestamps instead
+  *          - There are no packed scans to fetch, IIOBufferReadRaw() fails
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "iio_buffer.h" in your application
+  *            - Create a trigger if the ADC needs one (hrtimer through
+  *              configfs, or the sysfs trigger) and set its rate
+  *            - Open the buffer with the channels to capture
+  *            - Call IIOBufferRead() in a loop
+  *            - Compile with: gcc iio_adc.c iio_buffer.c your_app.c -o adc_app
+  *
+  *          Example Usage:
+  *            // channels 0..3 of iio:device0, 1024 scan FIFO, no trigger
+  *            int ch[4] = { 0, 1, 2, 3 };
+  *            int32_t samples[256 * 4];
+  *            IIO_Buffer *adc = IIOBufferOpen(0, ch, 4, NULL, 1024, 0);
+  *
+  *            while (1) {
+  *                int n = IIOBufferRead(adc, samples, NULL, 256, -1);
+  *                for (i = 0; i < n; i++)
+  *                    process(&samples[i * 4]);   // one scan: 4 channels
+  *            }
+  *            IIOBufferClose(adc);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <dirent.h>
+#include <endian.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "iio_buffer.h"
+
+#define TYPE_MAX	32
+
+/**
+  * @brief  Parses a scan element type such as "le:s12/16>>4" or "be:u10/16X2>>0".
+  * @retval 0 on success, -1 on a malformed descriptor
+  */
+static int
+IIOParseType(const char *type, IIO_ScanElement *e)
+{
+	char endian;
+	char sign;
+	int repeat = 1;
+	int storage;
+	int n;
+
+	if (strchr(type, 'X'))
+		n = sscanf(type, "%ce:%c%d/%dX%d>>%d", &endian, &sign, &e->bits,
+			   &storage, &repeat, &e->shift);
+	else
+		n = sscanf(type, "%ce:%c%d/%d>>%d", &endian, &sign, &e->bits,
+			   &storage, &e->shift) + 1;
+
+	if (6 != n || (8 != storage && 16 != storage && 32 != storage && 64 != storage) ||
+	    e->bits < 1 || e->bits > storage || 1 != repeat) {
+		fprintf(stderr, "Unsupported scan element type %s!\n", type);
+		return(-1);
+	}
+
+	e->big_endian = ('b' == endian);
+	e->is_signed = ('s' == sign);
+	e->storage = storage / 8;
+	return(0);
+}
+
+/**
+  * @brief  Enables one scan element and reads its index and type.
+  * @param  name: element name without suffix, e.g. "in_voltage5"
+  */
+static int
+IIOScanElement(int device, const char *name, IIO_ScanElement *e)
+{
+	char path[IIO_PATH_MAX];
+	char value[TYPE_MAX];
+
+	if (IIODevicePath(path, device, "scan_elements/%s_en", name) ||
+	    IIOWriteAttr(path, "1\n"))
+		return(-1);
+
+	if (IIODevicePath(path, device, "scan_elements/%s_index", name) ||
+	    IIOReadAttr(path, value, sizeof(value)) < 1) {
+		fprintf(stderr, "Failed to read scan index of %s!\n", name);
+		return(-1);
+	}
+	e->index = atoi(value);
+
+	if (IIODevicePath(path, device, "scan_elements/%s_type", name) ||
+	    IIOReadAttr(path, value, sizeof(value)) < 1) {
+		fprintf(stderr, "Failed to read scan type of %s!\n", name);
+		return(-1);
+	}
+
+	return(IIOParseType(value, e));
+}
+
+/* switches every scan element off so that only requested ones end up in a scan */
+static int
+IIOScanDisableAll(int device)
+{
+	char path[IIO_PATH_MAX];
+	struct dirent *de;
+	size_t len;
+	DIR *dir;
+
+	if (IIODevicePath(path, device, "scan_elements"))
+		return(-1);
+
+	dir = opendir(path);
+	if (NULL == dir) {
+		fprintf(stderr, "Failed to open %s, device has no buffer support!\n", path);
+		return(-1);
+	}
+
+	while (NULL != (de = readdir(dir))) {
+		len = strlen(de->d_name);
+		if (len < 4 || strcmp(de->d_name + len - 3, "_en"))
+			continue;
+		if (0 == IIODevicePath(path, device, "scan_elements/%s", de->d_name))
+			IIOWriteAttr(path, "0\n");
+	}
+
+	closedir(dir);
+	return(0);
+}
+
+/* orders the elements by scan index and assigns their byte offsets */
+static int
+IIOScanLayout(IIO_Buffer *buf)
+{
+	IIO_ScanElement tmp;
+	int largest = 1;
+	int offset = 0;
+	int i;
+	int j;
+
+	for (i = 1; i < buf->num_channels; i++) {
+		tmp = buf->channels[i];
+		for (j = i; j > 0 && buf->channels[j - 1].index > tmp.index; j--)
+			buf->channels[j] = buf->channels[j - 1];
+		buf->channels[j] = tmp;
+	}
+
+	for (i = 0; i < buf->num_channels; i++) {
+		offset = (offset + buf->channels[i].storage - 1) & ~(buf->channels[i].storage - 1);
+		buf->channels[i].offset = offset;
+		offset += buf->channels[i].storage;
+		if (buf->channels[i].storage > largest)
+			largest = buf->channels[i].storage;
+	}
+
+	/* the timestamp normally has the highest index; anything else is unusual */
+	if (-1 != buf->timestamp.channel) {
+		if (buf->num_channels > 0 &&
+		    buf->timestamp.index < buf->channels[buf->num_channels - 1].index) {
+			fprintf(stderr, "Timestamp is not the last scan element!\n");
+			return(-1);
+		}
+		offset = (offset + buf->timestamp.storage - 1) & ~(buf->timestamp.storage - 1);
+		buf->timestamp.offset = offset;
+		offset += buf->timestamp.storage;
+		if (buf->timestamp.storage > largest)
+			largest = buf->timestamp.storage;
+	}
+
+	buf->scan_size = (offset + largest - 1) & ~(largest - 1);
+	return(0);
+}
+
+static int
+IIOBufferEnable(int device, int enable)
+{
+	char path[IIO_PATH_MAX];
+
+	if (IIODevicePath(path, device, "buffer/enable"))
+		return(-1);
+
+	return(IIOWriteInt(path, enable));
+}
+
+/**
+  * @brief  Switches the scan timestamps of a device to CLOCK_MONOTONIC.
+  * @note   IIO timestamps default to CLOCK_REALTIME and the clock can only
+  *         change while the buffer is stopped; a running buffer is stopped
+  *         and restarted around the switch
+  * @param  device: N of iio:deviceN
+  * @retval 0 on success or if already monotonic, -1 if the buffer could not
+  *         be stopped or restarted
+  */
+int
+IIOBufferClock(int device)
+{
+	char clock[IIO_NAME_MAX];
+	char path[IIO_PATH_MAX];
+	char enabled[4];
+	int running;
+	int ret = 0;
+
+	if (device < 0 || IIODevicePath(path, device, "current_timestamp_clock"))
+		return(0);
+
+	if (IIOReadAttr(path, clock, sizeof(clock)) > 0 && 0 == strcmp(clock, "monotonic"))
+		return(0);
+
+	IIODevicePath(path, device, "buffer/enable");
+	running = (IIOReadAttr(path, enabled, sizeof(enabled)) > 0 && '0' != enabled[0]);
+	if (running && IIOBufferEnable(device, 0)) {
+		fprintf(stderr, "Failed to stop iio:device%d for the timestamp clock!\n", device);
+		return(-1);
+	}
+
+	IIODevicePath(path, device, "current_timestamp_clock");
+	if (IIOWriteAttr(path, "monotonic"))
+		fprintf(stderr, "Failed to set the iio:device%d timestamp clock!\n", device);
+
+	if (running && IIOBufferEnable(device, 1)) {
+		fprintf(stderr, "Failed to restart iio:device%d!\n", device);
+		ret = -1;
+	}
+
+	return(ret);
+}
+
+/**
+  * @brief  Sets up and starts buffered capture on an IIO device.
+  * @param  device: N of iio:deviceN
+  * @param  channels: N of each in_voltageN to capture
+  * @param  num: number of channels, up to IIO_SCAN_MAX
+  * @param  trigger: trigger name for current_trigger, NULL to leave it alone
+  * @param  length: kernel buffer length in scans, 0 = IIO_BUFFER_LENGTH
+  * @param  timestamp: 1 to capture the kernel timestamp with every scan,
+  *         on CLOCK_MONOTONIC
+  * @retval Buffer object, NULL on error
+  */
+IIO_Buffer *
+IIOBufferOpen(int device, const int *channels, int num, const char *trigger,
+	      int length, int timestamp)
+{
+	char path[IIO_PATH_MAX];
+	char name[IIO_NAME_MAX];
+	IIO_Buffer *buf;
+	int i;
+
+	if (NULL == channels || num < 1 || num > IIO_SCAN_MAX) {
+		fprintf(stderr, "Invalid IIO channel list!\n");
+		return(NULL);
+	}
+
+	buf = calloc(1, sizeof(*buf));
+	if (NULL == buf)
+		return(NULL);
+
+	buf->device = device;
+	buf->fd = -1;
+	buf->num_channels = num;
+	buf->timestamp.channel = -1;
+	if (length <= 0)
+		length = IIO_BUFFER_LENGTH;
+
+	/* the layout can only change while the buffer is stopped */
+	IIOBufferEnable(device, 0);
+	if (IIOScanDisableAll(device))
+		goto fail;
+
+	for (i = 0; i < num; i++) {
+		buf->channels[i].channel = channels[i];
+		buf->channels[i].slot = i;
+		snprintf(name, sizeof(name), "in_voltage%d", channels[i]);
+		if (IIOScanElement(device, name, &buf->channels[i]))
+			goto fail;
+	}
+
+	if (timestamp) {
+		if (IIOScanElement(device, "in_timestamp", &buf->timestamp) ||
+		    IIOBufferClock(device))
+			goto fail;
+		buf->timestamp.channel = 0;
+	}
+
+	if (IIOScanLayout(buf))
+		goto fail;
+
+	if (trigger) {
+		if (IIODevicePath(path, device, "trigger/current_trigger") ||
+		    IIOWriteAttr(path, trigger))
+			goto fail;
+	}
+
+	if (IIODevicePath(path, device, "buffer/length") || IIOWriteInt(path, length))
+		goto fail;
+
+	/* wake the reader once per quarter buffer, older kernels have no watermark */
+	buf->block_scans = (length >= 4) ? length / 4 : 1;
+	if (0 == IIODevicePath(path, device, "buffer/watermark") && 0 == access(path, W_OK))
+		IIOWriteInt(path, buf->block_scans);
+
+	buf->block = malloc((size_t)buf->block_scans * buf->scan_size);
+	if (NULL == buf->block)
+		goto fail;
+
+	if (IIODeviceNode(path, device))
+		goto fail;
+	buf->fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (-1 == buf->fd) {
+		fprintf(stderr, "Failed to open %s for reading!\n", path);
+		goto fail;
+	}
+
+	if (IIOBufferEnable(device, 1))
+		goto fail;
+
+	return(buf);
+
+fail:
+	fprintf(stderr, "Failed to set up buffered capture on iio:device%d!\n", device);
+	if (-1 != buf->fd)
+		close(buf->fd);
+	free(buf->block);
+	free(buf);
+	return(NULL);
+}
+
+/**
+  * @brief  Reads packed scans into buf->block with a single read().
+  * @param  buf: capture buffer
+  * @param  max_scans: scans wanted, 0 or more than block_scans = one block
+  * @param  timeout_ms: -1 blocks until the watermark, otherwise poll timeout
+  * @retval Number of scans in buf->block, 0 on timeout, -1 on error
+  */
+int
+IIOBufferReadRaw(IIO_Buffer *buf, int max_scans, int timeout_ms)
+{
+	struct pollfd pfd;
+	ssize_t len;
+	int ret;
+
+	if (NULL == buf || -1 == buf->fd)
+		return(-1);
+
+	if (max_scans <= 0 || max_scans > buf->block_scans)
+		max_scans = buf->block_scans;
+
+	if (timeout_ms >= 0) {
+		pfd.fd = buf->fd;
+		pfd.events = POLLIN;
+		do {
+			ret = poll(&pfd, 1, timeout_ms);
+		} while (-1 == ret && EINTR == errno);
+
+		if (ret <= 0)
+			return(ret);
+	}
+
+	do {
+		len = read(buf->fd, buf->block, (size_t)max_scans * buf->scan_size);
+	} while (-1 == len && EINTR == errno);
+
+	if (-1 == len) {
+		if (EAGAIN == errno)
+			return(0);
+		fprintf(stderr, "Failed to read iio:device%d buffer!\n", buf->device);
+		return(-1);
+	}
+
+	buf->scans += len / buf->scan_size;
+	return((int)(len / buf->scan_size));
+}
+
+static inline uint64_t
+IIOLoad(const uint8_t *p, const IIO_ScanElement *e)
+{
+	uint16_t v16;
+	uint32_t v32;
+	uint64_t v64;
+
+	switch (e->storage) {
+	case 1:
+		return(*p);
+	case 2:
+		memcpy(&v16, p, 2);
+		return(e->big_endian ? be16toh(v16) : le16toh(v16));
+	case 4:
+		memcpy(&v32, p, 4);
+		return(e->big_endian ? be32toh(v32) : le32toh(v32));
+	default:
+		memcpy(&v64, p, 8);
+		return(e->big_endian ? be64toh(v64) : le64toh(v64));
+	}
+}
+
+static inline int64_t
+IIODecodeElement(const uint8_t *scan, const IIO_ScanElement *e)
+{
+	uint64_t value;
+	uint64_t mask;
+
+	value = IIOLoad(scan + e->offset, e) >> e->shift;
+	if (e->bits >= 64)
+		return((int64_t)value);
+
+	mask = (1ULL << e->bits) - 1;
+	value &= mask;
+	if (e->is_signed && (value >> (e->bits - 1)))
+		value |= ~mask;
+
+	return((int64_t)value);
+}
+
+/**
+  * @brief  Decodes packed scans.
+  * @param  buf: capture buffer describing the layout
+  * @param  data: packed scans, e.g. buf->block after IIOBufferReadRaw()
+  * @param  scans: number of scans in data
+  * @param  samples: num_channels values per scan, in the order of the
+  *         channels passed to IIOBufferOpen()
+  * @param  timestamps: one value per scan, NULL if not wanted
+  * @retval scans
+  */
+int
+IIOBufferDecode(const IIO_Buffer *buf, const uint8_t *data, int scans,
+		int32_t *samples, int64_t *timestamps)
+{
+	const uint8_t *scan;
+	int num = buf->num_channels;
+	int i;
+	int j;
+
+	for (i = 0; i < scans; i++) {
+		scan = data + (size_t)i * buf->scan_size;
+		for (j = 0; j < num; j++)
+			samples[i * num + buf->channels[j].slot] =
+				(int32_t)IIODecodeElement(scan, &buf->channels[j]);
+
+		if (timestamps)
+			timestamps[i] = (-1 != buf->timestamp.channel) ?
+					IIODecodeElement(scan, &buf->timestamp) : 0;
+	}
+
+	return(scans);
+}
+
+/**
+  * @brief  Reads and decodes a block of scans.
+  * @param  buf: capture buffer
+  * @param  samples: room for max_scans * num_channels values
+  * @param  timestamps: room for max_scans values, NULL if not wanted
+  * @param  max_scans: scans wanted, at most one block per call
+  * @param  timeout_ms: -1 blocks until the watermark, otherwise poll timeout
+  * @retval Number of scans decoded, 0 on timeout, -1 on error
+  */
+int
+IIOBufferRead(IIO_Buffer *buf, int32_t *samples, int64_t *timestamps,
+	      int max_scans, int timeout_ms)
+{
+	int scans;
+
+	if (NULL == buf || NULL == samples)
+		return(-1);
+
+	if (NULL != buf->replay)
+		return(buf->replay(buf->replay_arg, samples, timestamps, max_scans, timeout_ms));
+
+	scans = IIOBufferReadRaw(buf, max_scans, timeout_ms);
+	if (scans <= 0)
+		return(scans);
+
+	return(IIOBufferDecode(buf, buf->block, scans, samples, timestamps));
+}
+
+void
+IIOBufferClose(IIO_Buffer *buf)
+{
+	if (NULL == buf)
+		return;
+
+	if (-1 != buf->fd) {
+		IIOBufferEnable(buf->device, 0);
+		close(buf->fd);
+	}
+	free(buf->block);
+	free(buf);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
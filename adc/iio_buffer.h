@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    iio_buffer.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the IIO
+  *          buffered ADC capture.
+  *
+  * @details Provides the following functionality:
+  *          - Scan element and trigger setup
+  *          - Block reads of packed scans from /dev/iio:deviceN
+  *          - Decoding of samples per channel type descriptor
+  *          - Optional per-scan kernel timestamps on CLOCK_MONOTONIC
+  *          - Replay of recorded scans through the same read call
+  ******************************************************************************
+  * @defgroup IIO_Buffer IIO Buffered Capture
+  * @brief Scan layout and buffer state
+  * @{
+  */
+
+#ifndef __IIO_BUFFER_H
+#define __IIO_BUFFER_H
+
+#include <stdint.h>
+#include "iio_adc.h"
+
+#define IIO_SCAN_MAX		16	/* channels per scan, timestamp excluded */
+#define IIO_BUFFER_LENGTH	1024	/* default kernel buffer length in scans */
+
+typedef struct {
+	int channel;		/* N of in_voltageN, -1 for a disabled timestamp */
+	int slot;		/* position in the channel list of IIOBufferOpen() */
+	int index;		/* scan_elements/..._index */
+	int is_signed;
+	int big_endian;
+	int bits;		/* realbits */
+	int storage;		/* storagebits / 8 */
+	int shift;
+	int offset;		/* byte offset inside a scan */
+} IIO_ScanElement;
+
+/* stands in for the device, e.g. to play back a recording */
+typedef int (*IIO_BufferReplay)(void *arg, int32_t *samples, int64_t *timestamps,
+				int max_scans, int timeout_ms);
+
+typedef struct {
+	int device;		/* -1 for a replayed buffer */
+	int fd;			/* /dev/iio:deviceN, -1 for a replayed buffer */
+	int num_channels;
+	IIO_ScanElement channels[IIO_SCAN_MAX];	/* in scan order */
+	IIO_ScanElement timestamp;		/* channel -1 if disabled */
+	int scan_size;		/* bytes per scan including padding */
+	int block_scans;	/* scans fetched by one read */
+	uint8_t *block;
+	uint64_t scans;		/* scans read since open */
+	IIO_BufferReplay replay;	/* NULL for a live device */
+	void *replay_arg;
+} IIO_Buffer;
+
+/** @} */
+
+extern IIO_Buffer *IIOBufferOpen(int device, const int *channels, int num,
+				 const char *trigger, int length, int timestamp);
+extern int IIOBufferClock(int device);
+extern int IIOBufferReadRaw(IIO_Buffer *buf, int max_scans, int timeout_ms);
+extern int IIOBufferDecode(const IIO_Buffer *buf, const uint8_t *data, int scans,
+			   int32_t *samples, int64_t *timestamps);
+extern int IIOBufferRead(IIO_Buffer *buf, int32_t *samples, int64_t *timestamps,
+			 int max_scans, int timeout_ms);
+extern void IIOBufferClose(IIO_Buffer *buf);
+
+
+#endif /*__IIO_BUFFER_H */
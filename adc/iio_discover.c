@@ -0,0 +1,408 @@
+/**
+  ******************************************************************************
+  * @file    iio_discover.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides IIO device discovery and the ADC channel table:
+  *           - Enumeration of /sys/bus/iio/devices
+  *           - Device lookup by name instead of a fixed iio:deviceN
+  *           - One table entry per voltage channel, built at startup
+  *           - Reads indexed by table position
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Channel Table
+  *          ===================================================================
+  *
+  *          Discovery
+  *          =====================
+  *          - Every iio:deviceN directory is checked against the wanted
+  *            name; the device number depends on probe order and differs
+  *            between boards and kernel versions, the name does not
+  *          - A name matches exactly or up to a '.', so "TI-am335x-adc"
+  *            also finds "TI-am335x-adc.0.auto"
+  *          - Each in_voltageN_raw of a matching device becomes one entry,
+  *            sorted by device and channel
+  *
+  *          Table Entries
+  *          =======================
+  *          - raw, scale and offset paths; scale and offset fall back to the
+  *            shared in_voltage_scale / in_voltage_offset
+  *          - scale (mV per count) and offset read once
+  *          - resolution from the scan element type, if the device has a
+  *            buffer
+  *          - the raw file is opened once; ADCTableRead() is a bounds check
+  *            and one pread(), no string work
+  *
+  *          Typical device names
+  *          =======================
+  *            AM335x     TI-am335x-adc
+  *            i.MX6UL    2198000.adc (vf610-adc driver)
+  *            i.MX93     44530000.adc
+  *            RZ/G2L     10059000.adc
+  *          Check /sys/bus/iio/devices/iio:deviceN/name on the target.
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "iio_discover.h" in your application
+  *            - Call ADCDiscover(name) once at startup for each ADC
+  *            - Look channels up with ADCFind() and keep the indexes
+  *            - Read with ADCTableRead() / ADCTableScan()
+  *            - ADCDeviceByName() gives the N for IIOBufferOpen()
+  *            - Compile with: gcc iio_adc.c iio_discover.c your_app.c -o adc_app
+  *
+  *          Example Usage:
+  *            int idx = -1, raw;
+  *            const ADC_ChannelInfo *info;
+  *
+  *            if (ADCDiscover("TI-am335x-adc") > 0 || ADCDiscover("2198000.adc") > 0)
+  *                idx = ADCFind(NULL, 5);
+  *
+  *            info = ADCChannel(idx);
+  *            raw = ADCTableRead(idx);
+  *            printf("%s ch%d: %.1f mV\n", info->name, info->channel,
+  *                   (raw + info->offset) * info->scale);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "iio_discover.h"
+
+#define VALUE_MAX	32
+
+static ADC_ChannelInfo s_table[ADC_TABLE_MAX];
+static int s_num;
+
+/* exact name, or the name followed by a '.' instance suffix; NULL matches all */
+static int
+ADCNameMatches(const char *device_name, const char *name)
+{
+	size_t len;
+
+	if (NULL == name)
+		return(1);
+
+	len = strlen(name);
+	return(0 == strncmp(device_name, name, len) &&
+	       ('\0' == device_name[len] || '.' == device_name[len]));
+}
+
+/* N of an "iio:deviceN" directory entry, -1 for anything else */
+static int
+ADCDeviceNumber(const char *entry)
+{
+	char *end;
+	long n;
+
+	if (strncmp(entry, "iio:device", 10))
+		return(-1);
+
+	n = strtol(entry + 10, &end, 10);
+	if (end == entry + 10 || '\0' != *end)
+		return(-1);
+
+	return((int)n);
+}
+
+static int
+ADCDeviceName(int device, char *name, size_t size)
+{
+	char path[IIO_PATH_MAX];
+
+	if (IIODevicePath(path, device, "name") || IIOReadAttr(path, name, size) < 0)
+		return(-1);
+
+	return(0);
+}
+
+/**
+  * @brief  Looks a device up by name.
+  * @param  name: device name attribute, see ADCNameMatches()
+  * @retval Lowest matching N of iio:deviceN, -1 if none
+  */
+int
+ADCDeviceByName(const char *name)
+{
+	char dev_name[IIO_NAME_MAX];
+	struct dirent *de;
+	int found = -1;
+	int device;
+	DIR *dir;
+
+	dir = opendir(IIOSysRoot());
+	if (NULL == dir) {
+		fprintf(stderr, "Failed to open %s!\n", IIOSysRoot());
+		return(-1);
+	}
+
+	while (NULL != (de = readdir(dir))) {
+		device = ADCDeviceNumber(de->d_name);
+		if (device < 0 || (found >= 0 && device > found))
+			continue;
+		if (ADCDeviceName(device, dev_name, sizeof(dev_name)) ||
+		    !ADCNameMatches(dev_name, name))
+			continue;
+		found = device;
+	}
+
+	closedir(dir);
+	return(found);
+}
+
+/* realbits of "le:u12/16>>0", 0 without scan elements */
+static int
+ADCChannelBits(int device, int channel)
+{
+	char path[IIO_PATH_MAX];
+	char value[VALUE_MAX];
+	int bits;
+
+	if (IIODevicePath(path, device, "scan_elements/in_voltage%d_type", channel) ||
+	    IIOReadAttr(path, value, sizeof(value)) < 1 ||
+	    1 != sscanf(value, "%*ce:%*c%d/", &bits))
+		return(0);
+
+	return(bits);
+}
+
+static int
+ADCTableFind(int device, int channel)
+{
+	int i;
+
+	for (i = 0; i < s_num; i++) {
+		if (device == s_table[i].device && channel == s_table[i].channel)
+			return(i);
+	}
+
+	return(-1);
+}
+
+static int
+ADCTableAdd(int device, const char *name, int channel)
+{
+	ADC_ChannelInfo *info;
+
+	if (ADCTableFind(device, channel) >= 0)
+		return(0);
+
+	if (s_num >= ADC_TABLE_MAX) {
+		fprintf(stderr, "ADC channel table full!\n");
+		return(-1);
+	}
+
+	info = &s_table[s_num];
+	memset(info, 0, sizeof(*info));
+	info->device = device;
+	info->channel = channel;
+	snprintf(info->name, sizeof(info->name), "%s", name);
+
+	if (IIODevicePath(info->raw_path, device, "in_voltage%d_raw", channel))
+		return(-1);
+
+	IIOChannelAttr(device, channel, "scale", info->scale_path);
+	IIOChannelAttr(device, channel, "offset", info->offset_path);
+	info->scale = IIOReadDouble(info->scale_path, 1.0);
+	info->offset = IIOReadDouble(info->offset_path, 0.0);
+	info->bits = ADCChannelBits(device, channel);
+
+	info->raw_fd = open(info->raw_path, O_RDONLY | O_CLOEXEC);
+	if (-1 == info->raw_fd) {
+		fprintf(stderr, "Failed to open %s for reading!\n", info->raw_path);
+		return(-1);
+	}
+
+	s_num++;
+	return(1);
+}
+
+/* adds every in_voltageN_raw of one device */
+static int
+ADCAddDevice(int device, const char *name)
+{
+	char path[IIO_PATH_MAX];
+	struct dirent *de;
+	int added = 0;
+	int channel;
+	int pos;
+	int ret;
+	DIR *dir;
+
+	if (IIODevicePath(path, device, "."))
+		return(-1);
+
+	dir = opendir(path);
+	if (NULL == dir)
+		return(-1);
+
+	while (NULL != (de = readdir(dir))) {
+		pos = 0;
+		if (1 != sscanf(de->d_name, "in_voltage%d%n", &channel, &pos) ||
+		    strcmp(de->d_name + pos, "_raw"))
+			continue;
+
+		ret = ADCTableAdd(device, name, channel);
+		if (ret < 0)
+			break;
+		added += ret;
+	}
+
+	closedir(dir);
+	return(added);
+}
+
+static int
+ADCTableCompare(const void *a, const void *b)
+{
+	const ADC_ChannelInfo *x = a;
+	const ADC_ChannelInfo *y = b;
+
+	if (x->device != y->device)
+		return(x->device - y->device);
+	return(x->channel - y->channel);
+}
+
+/**
+  * @brief  Adds the voltage channels of all devices matching name to the table.
+  * @param  name: device name attribute, NULL for every IIO device
+  * @retval Number of channels added, -1 if no device matched
+  * @note   Indexes returned by ADCFind() before this call may change.
+  */
+int
+ADCDiscover(const char *name)
+{
+	char dev_name[IIO_NAME_MAX];
+	struct dirent *de;
+	int matched = 0;
+	int added = 0;
+	int device;
+	int ret;
+	DIR *dir;
+
+	dir = opendir(IIOSysRoot());
+	if (NULL == dir) {
+		fprintf(stderr, "Failed to open %s!\n", IIOSysRoot());
+		return(-1);
+	}
+
+	while (NULL != (de = readdir(dir))) {
+		device = ADCDeviceNumber(de->d_name);
+		if (device < 0 || ADCDeviceName(device, dev_name, sizeof(dev_name)) ||
+		    !ADCNameMatches(dev_name, name))
+			continue;
+
+		matched++;
+		ret = ADCAddDevice(device, dev_name);
+		if (ret > 0)
+			added += ret;
+	}
+
+	closedir(dir);
+	if (0 == matched) {
+		fprintf(stderr, "No IIO device named %s!\n", name ? name : "(any)");
+		return(-1);
+	}
+
+	qsort(s_table, s_num, sizeof(s_table[0]), ADCTableCompare);
+	return(added);
+}
+
+int
+ADCNumChannels(void)
+{
+	return(s_num);
+}
+
+const ADC_ChannelInfo *
+ADCChannel(int index)
+{
+	if (index < 0 || index >= s_num)
+		return(NULL);
+
+	return(&s_table[index]);
+}
+
+/**
+  * @brief  Finds a table entry.
+  * @param  name: device name, NULL for the first device holding the channel
+  * @param  channel: N of in_voltageN
+  * @retval Table index, -1 if not found
+  */
+int
+ADCFind(const char *name, int channel)
+{
+	int i;
+
+	for (i = 0; i < s_num; i++) {
+		if (channel == s_table[i].channel && ADCNameMatches(s_table[i].name, name))
+			return(i);
+	}
+
+	return(-1);
+}
+
+/**
+  * @brief  Reads the raw value of a table entry.
+  * @retval Raw ADC count, -1 on error
+  */
+int
+ADCTableRead(int index)
+{
+	int value;
+
+	if (index < 0 || index >= s_num || IIOReadFd(s_table[index].raw_fd, &value))
+		return(-1);
+
+	return(value);
+}
+
+/**
+  * @brief  Reads several table entries, one pread() each.
+  * @param  indexes: table indexes
+  * @param  n: number of entries
+  * @param  out: raw values, -1 for a failed entry
+  * @retval 0 on success, -1 if any entry failed
+  */
+int
+ADCTableScan(const int *indexes, int n, int *out)
+{
+	int ret = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		out[i] = ADCTableRead(indexes[i]);
+		if (-1 == out[i])
+			ret = -1;
+	}
+
+	return(ret);
+}
+
+/**
+  * @brief  Closes the channel files and empties the table.
+  */
+void
+ADCTableClear(void)
+{
+	int i;
+
+	for (i = 0; i < s_num; i++)
+		close(s_table[i].raw_fd);
+	s_num = 0;
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
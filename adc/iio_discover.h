@@ -0,0 +1,56 @@
+/**
+  ******************************************************************************
+  * @file    iio_discover.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the IIO
+  *          device discovery and the ADC channel table.
+  *
+  * @details Provides the following functionality:
+  *          - IIO device lookup by name
+  *          - Startup-time table of voltage channels
+  *          - Raw, scale and offset paths and resolution per channel
+  *          - Reads indexed by table position
+  ******************************************************************************
+  * @defgroup IIO_Discover IIO Discovery
+  * @brief Discovered ADC channels
+  * @{
+  */
+
+#ifndef __IIO_DISCOVER_H
+#define __IIO_DISCOVER_H
+
+#include "iio_adc.h"
+
+/* Channels the table holds, override with -DADC_TABLE_MAX=n */
+#ifndef ADC_TABLE_MAX
+#define ADC_TABLE_MAX		64
+#endif
+
+typedef struct {
+	int device;			/* N of iio:deviceN */
+	char name[IIO_NAME_MAX];	/* device name attribute */
+	int channel;			/* N of in_voltageN */
+	char raw_path[IIO_PATH_MAX];
+	char scale_path[IIO_PATH_MAX];	/* per-channel or shared, "" if none */
+	char offset_path[IIO_PATH_MAX];	/* "" if none */
+	double scale;			/* mV per count, 1.0 if unknown */
+	double offset;			/* counts added before scaling */
+	int bits;			/* resolution, 0 if unknown */
+	int raw_fd;			/* kept open for the hot path */
+} ADC_ChannelInfo;
+
+/** @} */
+
+extern int ADCDeviceByName(const char *name);
+extern int ADCDiscover(const char *name);
+extern int ADCNumChannels(void);
+extern const ADC_ChannelInfo *ADCChannel(int index);
+extern int ADCFind(const char *name, int channel);
+extern int ADCTableRead(int index);
+extern int ADCTableScan(const int *indexes, int n, int *out);
+extern void ADCTableClear(void);
+
+
+#endif /*__IIO_DISCOVER_H */
@@ -51,7 +51,8 @@
   *          - Always unexport unused pins
   *          - Never exceed max current/pin
   *          - Input voltages must stay within SoC limits
-  *          - Avoid concurrent pin access
+  *          - Drive each pin from one thread at a time; different pins
+  *            may be used from different threads in parallel
   * 
   *          
   *
@@ -0,0 +1,765 @@
+/**
+  ******************************************************************************
+  * @file    gpio_bitbang.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides bit-banged I2C and SPI masters on GPIO pins:
+  *           - Open-drain I2C with clock stretching and bus recovery
+  *           - I2C transfers with the i2c-dev read/write/I2C_RDWR semantics
+  *           - SPI modes 0-3 with spidev SPI_IOC_MESSAGE semantics
+  *           - Pins driven through cached handles or line requests
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Bit-Banged Buses
+  *          ===================================================================
+  *
+  *          Pin Access
+  *          =====================
+  *          - Every pin is opened once through the handle cache; the bus
+  *            code never formats a path or opens a file per bit
+  *          - I2C needs open-drain outputs (HIGH = released):
+  *              chardev: lines requested with GPIO_V2_LINE_FLAG_OPEN_DRAIN,
+  *                       SCL and SDA of one bank in one request
+  *              mmap:    output latch held LOW, the direction register
+  *                       switches between driving LOW and released
+  *              sysfs:   gpioN/direction written with "low" / "in" on a
+  *                       cached fd (slow, for a few kHz only); also used
+  *                       for mmap banks without a direction register
+  *          - A pin is only written when its level changes
+  *          - SPI SCLK and MOSI of the same bank change in one bank write
+  *
+  *          Timing
+  *          =======================
+  *          - Each half clock period ends at an absolute deadline that is
+  *            busy-waited on CLOCK_MONOTONIC; pin access time counts into
+  *            the half period instead of adding to it
+  *          - If pin access is slower than the requested rate, the bus
+  *            simply runs at the rate the backend reaches
+  *          - 100 kHz I2C needs the chardev or mmap backend; a chardev
+  *            access costs about four ioctls per bit
+  *
+  *          I2C
+  *          =======================
+  *          - After releasing SCL the master waits until SCL reads HIGH,
+  *            slaves may stretch the clock up to GPIO_I2C_STRETCH_TIMEOUT_US
+  *          - GPIOI2CTransfer() takes struct i2c_msg exactly like
+  *            ioctl(fd, I2C_RDWR): repeated start between messages, one stop
+  *            at the end, I2C_M_RD, I2C_M_NOSTART, I2C_M_IGNORE_NAK and
+  *            I2C_M_NO_RD_ACK are honoured
+  *          - GPIOI2CSetSlave()/GPIOI2CRead()/GPIOI2CWrite() behave like
+  *            ioctl(I2C_SLAVE)/read()/write() on /dev/i2c-N
+  *          - Errors return -1 with errno set as i2c-dev does: ENXIO on an
+  *            address NACK, EIO on a data NACK, ETIMEDOUT on clock
+  *            stretching, EBUSY if the bus cannot be recovered
+  *          - A bus with SDA held low is recovered with up to nine SCL
+  *            pulses and a stop condition
+  *
+  *          SPI
+  *          =======================
+  *          - CPOL selects the SCLK idle level, CPHA whether data is
+  *            sampled on the leading (0) or trailing (1) edge
+  *          - GPIOSPITransfer() takes struct spi_ioc_transfer like
+  *            ioctl(fd, SPI_IOC_MESSAGE(n)): per transfer speed_hz,
+  *            cs_change and delay_usecs, 8 bits per word
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_bitbang.h" in your application
+  *            - Select the chardev (or mmap) backend for the banks of the
+  *              bus pins with GPIOSetBackend() for full speed
+  *            - Open the bus on its pins, then use it like the kernel device
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c
+  *                            gpio_thread.c gpio_bitbang.c your_app.c -pthread
+  *
+  *          Example Usage:
+  *            // I2C on GPIO1_12 (SCL) / GPIO1_13 (SDA), OPTIGA style register read
+  *            GPIO_I2C *i2c;
+  *            uint8_t reg = 0x82, state[4];
+  *
+  *            GPIOSetBackend(1, GPIO_BACKEND_CHARDEV);
+  *            i2c = GPIOI2COpen(1, 12, 1, 13, 100000);
+  *            GPIOI2CSetSlave(i2c, 0x30);
+  *            if (1 == GPIOI2CWrite(i2c, &reg, 1) && 4 == GPIOI2CRead(i2c, state, 4))
+  *                printf("state %02x %02x %02x %02x\n", state[0], state[1], state[2], state[3]);
+  *
+  *            // the same as one combined I2C_RDWR transaction
+  *            struct i2c_msg msgs[2] = {
+  *                { .addr = 0x30, .flags = 0, .len = 1, .buf = &reg },
+  *                { .addr = 0x30, .flags = I2C_M_RD, .len = 4, .buf = state },
+  *            };
+  *            GPIOI2CTransfer(i2c, msgs, 2);
+  *
+  *            // SPI mode 0 at 1 MHz on bank 2
+  *            GPIO_SPIConfig cfg = { 2, 0, 2, 1, 2, 2, 2, 3, SPI_MODE_0, 1000000 };
+  *            GPIO_SPI *spi = GPIOSPIOpen(&cfg);
+  *            uint8_t tx[2] = { 0x9F, 0 }, rx[2];
+  *            struct spi_ioc_transfer xfer = {
+  *                .tx_buf = (uintptr_t)tx, .rx_buf = (uintptr_t)rx, .len = 2,
+  *            };
+  *            GPIOSPITransfer(spi, &xfer, 1);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/i2c-dev.h>
+#include "gpio_bitbang.h"
+#include "gpio_mmap.h"
+#include "gpio_thread.h"
+
+#define I2C_RECOVER_PULSES	9
+
+/* busy-waits until the end of the current half period */
+static void
+BBWait(uint64_t *t, uint64_t half_ns)
+{
+	uint64_t now;
+
+	*t += half_ns;
+	now = GPIONowNs();
+	if (now >= *t) {
+		*t = now;	/* pin access alone took longer, do not catch up */
+		return;
+	}
+
+	while (GPIONowNs() < *t)
+		;
+}
+
+static int
+BBPinOpen(GPIO_BitbangPin *p, int bank, int gpio)
+{
+	p->bank = bank;
+	p->gpio = gpio;
+	p->bit = 1U << gpio;
+	p->backend = GPIOGetBackend(bank);
+	p->level = -1;
+	p->dir_fd = -1;
+	p->handle = GPIOOpen(bank, gpio);
+
+	return((NULL == p->handle) ? -1 : 0);
+}
+
+/**
+  * @brief  Prepares a pin for open-drain use on the mmap and sysfs backends.
+  * @note   Chardev pins are requested with OUT_OPEN_DRAIN by the caller.
+  */
+static int
+BBPinOpenDrain(GPIO_BitbangPin *p, int bank, int gpio)
+{
+	char path[GPIO_DIRECTION_MAX];
+
+	if (GPIO_BACKEND_CHARDEV == GPIOGetBackend(bank))
+		return(BBPinOpen(p, bank, gpio));
+
+	/* start released, then preset the output latch LOW */
+	if (GPIOInit(bank, gpio, IN) || BBPinOpen(p, bank, gpio))
+		return(-1);
+
+	if (GPIO_BACKEND_MMAP == p->backend && NULL != GPIOMmapGet(bank) &&
+	    GPIO_REG_NONE != GPIOMmapGet(bank)->layout->dir)
+		return(GPIOMmapWrite(bank, p->bit, 0));
+
+	/* no mapped direction register: switch direction through sysfs */
+	snprintf(path, GPIO_DIRECTION_MAX, "/sys/class/gpio/gpio%d/direction",
+		 GPIOPinNumber(bank, gpio));
+	p->dir_fd = open(path, O_WRONLY | O_CLOEXEC);
+	if (-1 == p->dir_fd) {
+		fprintf(stderr, "Failed to open gpio direction for writing!\n");
+		return(-1);
+	}
+
+	return(0);
+}
+
+static void
+BBPinClose(GPIO_BitbangPin *p)
+{
+	if (-1 != p->dir_fd)
+		close(p->dir_fd);
+	p->dir_fd = -1;
+}
+
+/* open-drain output: LOW drives the line, HIGH releases it */
+static void
+BBPinOD(GPIO_BitbangPin *p, int level)
+{
+	if (level == p->level)
+		return;
+
+	p->level = level;
+	if (-1 != p->dir_fd)
+		pwrite(p->dir_fd, level ? "in" : "low", level ? 2 : 3, 0);
+	else if (GPIO_BACKEND_MMAP == p->backend)
+		GPIOMmapDirection(p->bank, p->bit, level ? IN : OUT);
+	else
+		GPIOHandleWriteForce(p->handle, level);
+}
+
+/* push-pull output */
+static void
+BBPinSet(GPIO_BitbangPin *p, int level)
+{
+	if (level == p->level)
+		return;
+
+	p->level = level;
+	GPIOHandleWriteForce(p->handle, level);
+}
+
+static int
+BBPinGet(GPIO_BitbangPin *p)
+{
+	uint32_t word;
+
+	if (GPIO_BACKEND_MMAP == p->backend) {
+		if (GPIOMmapRead(p->bank, p->bit, &word))
+			return(-1);
+		return(word ? HIGH : LOW);
+	}
+
+	return(GPIOHandleRead(p->handle));
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                   I2C                                     */
+/* ------------------------------------------------------------------------- */
+
+/* releases SCL and waits while a slave stretches the clock */
+static int
+I2CSclHigh(GPIO_I2C *bus)
+{
+	uint64_t start;
+	uint64_t now;
+
+	BBPinOD(&bus->scl, HIGH);
+	if (HIGH == BBPinGet(&bus->scl))
+		return(0);
+
+	bus->stretches++;
+	start = GPIONowNs();
+	do {
+		now = GPIONowNs();
+		if (now - start > bus->stretch_ns) {
+			errno = ETIMEDOUT;
+			return(-1);
+		}
+	} while (HIGH != BBPinGet(&bus->scl));
+
+	/* the high half period starts when the slave let go */
+	bus->t = now;
+	return(0);
+}
+
+static int
+I2CStart(GPIO_I2C *bus)
+{
+	BBPinOD(&bus->sda, LOW);
+	BBWait(&bus->t, bus->half_ns);
+	BBPinOD(&bus->scl, LOW);
+	return(0);
+}
+
+static int
+I2CRepeatedStart(GPIO_I2C *bus)
+{
+	BBPinOD(&bus->sda, HIGH);
+	BBWait(&bus->t, bus->half_ns);
+	if (I2CSclHigh(bus))
+		return(-1);
+	BBWait(&bus->t, bus->half_ns);
+	return(I2CStart(bus));
+}
+
+static void
+I2CStop(GPIO_I2C *bus)
+{
+	BBPinOD(&bus->sda, LOW);
+	BBWait(&bus->t, bus->half_ns);
+	I2CSclHigh(bus);
+	BBWait(&bus->t, bus->half_ns);
+	BBPinOD(&bus->sda, HIGH);
+	BBWait(&bus->t, bus->half_ns);
+}
+
+/* one SCL pulse: data set while SCL is low, sampled while it is high */
+static int
+I2CBit(GPIO_I2C *bus, int out)
+{
+	int in = HIGH;
+
+	BBPinOD(&bus->sda, out);
+	BBWait(&bus->t, bus->half_ns);
+	if (I2CSclHigh(bus))
+		return(-1);
+	BBWait(&bus->t, bus->half_ns);
+	if (out)
+		in = BBPinGet(&bus->sda);
+	BBPinOD(&bus->scl, LOW);
+
+	return(in);
+}
+
+/* @retval 0 ACK, 1 NACK, -1 error */
+static int
+I2CWriteByte(GPIO_I2C *bus, uint8_t byte)
+{
+	int i;
+
+	for (i = 7; i >= 0; i--) {
+		if (I2CBit(bus, (byte >> i) & 1) < 0)
+			return(-1);
+	}
+
+	return(I2CBit(bus, HIGH));
+}
+
+static int
+I2CReadByte(GPIO_I2C *bus, int ack)
+{
+	int byte = 0;
+	int bit;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		bit = I2CBit(bus, HIGH);
+		if (bit < 0)
+			return(-1);
+		byte = (byte << 1) | bit;
+	}
+
+	if (I2CBit(bus, ack ? LOW : HIGH) < 0)
+		return(-1);
+
+	return(byte);
+}
+
+/**
+  * @brief  Frees a bus whose SDA is held low by a slave stuck mid-byte.
+  * @retval 0 if the bus is idle afterwards, -1 otherwise
+  */
+int
+GPIOI2CRecover(GPIO_I2C *bus)
+{
+	int i;
+
+	if (NULL == bus)
+		return(-1);
+
+	bus->t = GPIONowNs();
+	BBPinOD(&bus->sda, HIGH);
+	for (i = 0; i < I2C_RECOVER_PULSES && HIGH != BBPinGet(&bus->sda); i++) {
+		BBPinOD(&bus->scl, LOW);
+		BBWait(&bus->t, bus->half_ns);
+		if (I2CSclHigh(bus))
+			return(-1);
+		BBWait(&bus->t, bus->half_ns);
+	}
+
+	BBPinOD(&bus->scl, LOW);
+	BBWait(&bus->t, bus->half_ns);
+	I2CStop(bus);
+
+	if (HIGH != BBPinGet(&bus->sda) || HIGH != BBPinGet(&bus->scl)) {
+		fprintf(stderr, "Failed to recover i2c bus!\n");
+		return(-1);
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Opens a bit-banged I2C master.
+  * @param  scl_bank, scl_gpio: clock pin
+  * @param  sda_bank, sda_gpio: data pin
+  * @param  freq_hz: SCL rate, 0 = GPIO_I2C_FREQ_DEFAULT
+  * @retval Bus object, NULL on error
+  */
+GPIO_I2C *
+GPIOI2COpen(int scl_bank, int scl_gpio, int sda_bank, int sda_gpio, unsigned int freq_hz)
+{
+	GPIO_PinConfig table[2];
+	GPIO_I2C *bus;
+	int num = 0;
+
+	bus = calloc(1, sizeof(*bus));
+	if (NULL == bus)
+		return(NULL);
+
+	if (0 == freq_hz)
+		freq_hz = GPIO_I2C_FREQ_DEFAULT;
+	bus->half_ns = 500000000ULL / freq_hz;
+	bus->stretch_ns = (uint64_t)GPIO_I2C_STRETCH_TIMEOUT_US * 1000;
+	bus->scl.dir_fd = -1;
+	bus->sda.dir_fd = -1;
+
+	/* chardev pins of one bank end up in one open-drain line request */
+	if (GPIO_BACKEND_CHARDEV == GPIOGetBackend(scl_bank))
+		table[num++] = (GPIO_PinConfig){ scl_bank, scl_gpio, OUT_OPEN_DRAIN };
+	if (GPIO_BACKEND_CHARDEV == GPIOGetBackend(sda_bank))
+		table[num++] = (GPIO_PinConfig){ sda_bank, sda_gpio, OUT_OPEN_DRAIN };
+
+	if ((num > 0 && GPIOInitTable(table, num)) ||
+	    BBPinOpenDrain(&bus->scl, scl_bank, scl_gpio) ||
+	    BBPinOpenDrain(&bus->sda, sda_bank, sda_gpio)) {
+		fprintf(stderr, "Failed to set up i2c pins!\n");
+		GPIOI2CClose(bus);
+		return(NULL);
+	}
+
+	BBPinOD(&bus->scl, HIGH);
+	BBPinOD(&bus->sda, HIGH);
+	if (HIGH != BBPinGet(&bus->sda))
+		GPIOI2CRecover(bus);
+
+	return(bus);
+}
+
+int
+GPIOI2CSetSlave(GPIO_I2C *bus, int addr)
+{
+	if (NULL == bus || addr < 0 || addr > 0x7F) {
+		errno = EINVAL;
+		return(-1);
+	}
+
+	bus->addr = addr;
+	return(0);
+}
+
+/**
+  * @brief  Runs a combined transaction, like ioctl(fd, I2C_RDWR).
+  * @param  bus: I2C bus
+  * @param  msgs: messages, separated by repeated starts
+  * @param  num: number of messages
+  * @retval num on success, -1 with errno set on error
+  */
+int
+GPIOI2CTransfer(GPIO_I2C *bus, struct i2c_msg *msgs, int num)
+{
+	uint8_t addr;
+	int value;
+	int ret;
+	int i;
+	int j;
+
+	if (NULL == bus || NULL == msgs || num < 1 || num > I2C_RDWR_IOCTL_MAX_MSGS) {
+		errno = EINVAL;
+		return(-1);
+	}
+
+	for (i = 0; i < num; i++) {
+		if (msgs[i].flags & (I2C_M_TEN | I2C_M_RECV_LEN)) {
+			errno = EOPNOTSUPP;
+			return(-1);
+		}
+	}
+
+	if ((HIGH != BBPinGet(&bus->sda) || HIGH != BBPinGet(&bus->scl)) && GPIOI2CRecover(bus)) {
+		errno = EBUSY;
+		return(-1);
+	}
+
+	bus->t = GPIONowNs();
+	I2CStart(bus);
+	for (i = 0; i < num; i++) {
+		if (i > 0 && !(msgs[i].flags & I2C_M_NOSTART) && I2CRepeatedStart(bus))
+			goto fail;
+
+		if (0 == i || !(msgs[i].flags & I2C_M_NOSTART)) {
+			addr = (msgs[i].addr << 1) | ((msgs[i].flags & I2C_M_RD) ? 1 : 0);
+			ret = I2CWriteByte(bus, addr);
+			if (ret < 0)
+				goto fail;
+			if (ret && !(msgs[i].flags & I2C_M_IGNORE_NAK)) {
+				errno = ENXIO;
+				goto fail;
+			}
+		}
+
+		for (j = 0; j < msgs[i].len; j++) {
+			if (msgs[i].flags & I2C_M_RD) {
+				/* the last byte of a read is NACKed to end it */
+				value = I2CReadByte(bus, j < msgs[i].len - 1 &&
+						    !(msgs[i].flags & I2C_M_NO_RD_ACK));
+				if (value < 0)
+					goto fail;
+				msgs[i].buf[j] = value;
+				continue;
+			}
+
+			ret = I2CWriteByte(bus, msgs[i].buf[j]);
+			if (ret < 0)
+				goto fail;
+			if (ret && !(msgs[i].flags & I2C_M_IGNORE_NAK)) {
+				errno = EIO;
+				goto fail;
+			}
+		}
+	}
+
+	I2CStop(bus);
+	return(num);
+
+fail:
+	ret = errno;
+	I2CStop(bus);
+	errno = ret;
+	return(-1);
+}
+
+int
+GPIOI2CWrite(GPIO_I2C *bus, const void *buf, int len)
+{
+	struct i2c_msg msg;
+
+	if (NULL == bus || len < 0 || len > 0xFFFF) {
+		errno = EINVAL;
+		return(-1);
+	}
+
+	msg.addr = bus->addr;
+	msg.flags = 0;
+	msg.len = len;
+	msg.buf = (uint8_t *)buf;
+
+	return((1 == GPIOI2CTransfer(bus, &msg, 1)) ? len : -1);
+}
+
+int
+GPIOI2CRead(GPIO_I2C *bus, void *buf, int len)
+{
+	struct i2c_msg msg;
+
+	if (NULL == bus || len < 0 || len > 0xFFFF) {
+		errno = EINVAL;
+		return(-1);
+	}
+
+	msg.addr = bus->addr;
+	msg.flags = I2C_M_RD;
+	msg.len = len;
+	msg.buf = buf;
+
+	return((1 == GPIOI2CTransfer(bus, &msg, 1)) ? len : -1);
+}
+
+void
+GPIOI2CClose(GPIO_I2C *bus)
+{
+	if (NULL == bus)
+		return;
+
+	BBPinClose(&bus->scl);
+	BBPinClose(&bus->sda);
+	free(bus);
+}
+
+/* ------------------------------------------------------------------------- */
+/*                                   SPI                                     */
+/* ------------------------------------------------------------------------- */
+
+/* drives SCLK and MOSI, with one bank write when both change on one bank */
+static void
+SPIDrive(GPIO_SPI *bus, int sclk, int mosi)
+{
+	int both;
+
+	both = (NULL != bus->mosi.handle && bus->sclk.bank == bus->mosi.bank &&
+		sclk != bus->sclk.level && mosi != bus->mosi.level);
+	if (both) {
+		bus->sclk.level = sclk;
+		bus->mosi.level = mosi;
+		GPIOWriteBankForce(bus->sclk.bank, bus->sclk.bit | bus->mosi.bit,
+				   (sclk ? bus->sclk.bit : 0) | (mosi ? bus->mosi.bit : 0));
+		return;
+	}
+
+	if (NULL != bus->mosi.handle)
+		BBPinSet(&bus->mosi, mosi);
+	BBPinSet(&bus->sclk, sclk);
+}
+
+static void
+SPIChipSelect(GPIO_SPI *bus, int active)
+{
+	int level;
+
+	if (NULL == bus->cs.handle)
+		return;
+
+	level = (bus->mode & SPI_CS_HIGH) ? active : !active;
+	BBPinSet(&bus->cs, level);
+}
+
+static uint8_t
+SPIByte(GPIO_SPI *bus, uint8_t out, uint64_t half_ns)
+{
+	int idle = (bus->mode & SPI_CPOL) ? HIGH : LOW;
+	uint8_t in = 0;
+	int shift;
+	int bit;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		shift = (bus->mode & SPI_LSB_FIRST) ? i : 7 - i;
+		bit = (out >> shift) & 1;
+
+		if (bus->mode & SPI_CPHA) {
+			/* shift out on the leading edge, sample on the trailing one */
+			SPIDrive(bus, !idle, bit);
+			BBWait(&bus->t, half_ns);
+			if (NULL != bus->miso.handle && HIGH == BBPinGet(&bus->miso))
+				in |= 1U << shift;
+			SPIDrive(bus, idle, bit);
+			BBWait(&bus->t, half_ns);
+		} else {
+			/* data valid before the leading edge, sampled on it */
+			SPIDrive(bus, idle, bit);
+			BBWait(&bus->t, half_ns);
+			SPIDrive(bus, !idle, bit);
+			if (NULL != bus->miso.handle && HIGH == BBPinGet(&bus->miso))
+				in |= 1U << shift;
+			BBWait(&bus->t, half_ns);
+		}
+	}
+
+	if (!(bus->mode & SPI_CPHA))
+		SPIDrive(bus, idle, bus->mosi.level);
+
+	return(in);
+}
+
+/**
+  * @brief  Opens a bit-banged SPI master.
+  * @param  config: pins, SPI_MODE_x flags and clock rate (0 = GPIO_SPI_FREQ_DEFAULT)
+  * @retval Bus object, NULL on error
+  */
+GPIO_SPI *
+GPIOSPIOpen(const GPIO_SPIConfig *config)
+{
+	GPIO_PinConfig table[4];
+	GPIO_SPI *bus;
+	int num = 0;
+	int ret = 0;
+
+	if (NULL == config || config->sclk_bank < 0 ||
+	    (config->mosi_bank < 0 && config->miso_bank < 0))
+		return(NULL);
+
+	bus = calloc(1, sizeof(*bus));
+	if (NULL == bus)
+		return(NULL);
+
+	bus->mode = config->mode;
+	bus->speed_hz = config->speed_hz ? config->speed_hz : GPIO_SPI_FREQ_DEFAULT;
+	bus->half_ns = 500000000ULL / bus->speed_hz;
+
+	table[num++] = (GPIO_PinConfig){ config->sclk_bank, config->sclk_gpio, OUT };
+	if (config->mosi_bank >= 0)
+		table[num++] = (GPIO_PinConfig){ config->mosi_bank, config->mosi_gpio, OUT };
+	if (config->miso_bank >= 0)
+		table[num++] = (GPIO_PinConfig){ config->miso_bank, config->miso_gpio, IN };
+	if (config->cs_bank >= 0)
+		table[num++] = (GPIO_PinConfig){ config->cs_bank, config->cs_gpio, OUT };
+
+	if (GPIOInitTable(table, num))
+		ret = -1;
+
+	if (0 == ret)
+		ret = BBPinOpen(&bus->sclk, config->sclk_bank, config->sclk_gpio);
+	if (0 == ret && config->mosi_bank >= 0)
+		ret = BBPinOpen(&bus->mosi, config->mosi_bank, config->mosi_gpio);
+	if (0 == ret && config->miso_bank >= 0)
+		ret = BBPinOpen(&bus->miso, config->miso_bank, config->miso_gpio);
+	if (0 == ret && config->cs_bank >= 0)
+		ret = BBPinOpen(&bus->cs, config->cs_bank, config->cs_gpio);
+
+	if (ret) {
+		fprintf(stderr, "Failed to set up spi pins!\n");
+		free(bus);
+		return(NULL);
+	}
+
+	SPIChipSelect(bus, 0);
+	SPIDrive(bus, (bus->mode & SPI_CPOL) ? HIGH : LOW, LOW);
+
+	return(bus);
+}
+
+/**
+  * @brief  Runs a chain of transfers, like ioctl(fd, SPI_IOC_MESSAGE(num)).
+  * @param  bus: SPI bus
+  * @param  xfers: transfers; tx_buf/rx_buf may be 0, bits_per_word 0 or 8
+  * @param  num: number of transfers
+  * @retval Number of bytes transferred, -1 with errno set on error
+  */
+int
+GPIOSPITransfer(GPIO_SPI *bus, struct spi_ioc_transfer *xfers, int num)
+{
+	const uint8_t *tx;
+	uint8_t *rx;
+	uint64_t half_ns;
+	uint8_t in;
+	int total = 0;
+	uint32_t j;
+	int i;
+
+	if (NULL == bus || NULL == xfers || num < 1) {
+		errno = EINVAL;
+		return(-1);
+	}
+
+	for (i = 0; i < num; i++) {
+		if (0 != xfers[i].bits_per_word && 8 != xfers[i].bits_per_word) {
+			errno = EINVAL;
+			return(-1);
+		}
+	}
+
+	for (i = 0; i < num; i++) {
+		tx = (const uint8_t *)(uintptr_t)xfers[i].tx_buf;
+		rx = (uint8_t *)(uintptr_t)xfers[i].rx_buf;
+		half_ns = xfers[i].speed_hz ? 500000000ULL / xfers[i].speed_hz : bus->half_ns;
+
+		SPIChipSelect(bus, 1);
+		bus->t = GPIONowNs();
+		for (j = 0; j < xfers[i].len; j++) {
+			in = SPIByte(bus, tx ? tx[j] : 0, half_ns);
+			if (rx)
+				rx[j] = in;
+		}
+		total += xfers[i].len;
+
+		if (xfers[i].delay_usecs)
+			usleep(xfers[i].delay_usecs);
+
+		/* cs_change toggles CS between transfers and keeps it after the last */
+		if ((i < num - 1) == !!xfers[i].cs_change)
+			SPIChipSelect(bus, 0);
+	}
+
+	return(total);
+}
+
+void
+GPIOSPIClose(GPIO_SPI *bus)
+{
+	free(bus);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+  * @file    gpio_bitbang.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the
+  *          bit-banged I2C and SPI masters on GPIO pins.
+  *
+  * @details Provides the following functionality:
+  *          - I2C master with clock stretching and bus recovery
+  *          - i2c-dev style read/write and I2C_RDWR message transfers
+  *          - SPI master, modes 0-3, MSB or LSB first
+  *          - spidev style SPI_IOC_MESSAGE transfers
+  ******************************************************************************
+  * @defgroup GPIO_Bitbang GPIO Bit-Banged Buses
+  * @brief Bus pins, timing and bus objects
+  * @{
+  */
+
+#ifndef __GPIO_BITBANG_H
+#define __GPIO_BITBANG_H
+
+#include <stdint.h>
+#include <linux/i2c.h>
+#include <linux/spi/spidev.h>
+#include "sysfs_gpio.h"
+
+#define GPIO_I2C_FREQ_DEFAULT		100000	/* Hz */
+#define GPIO_I2C_STRETCH_TIMEOUT_US	25000	/* SMBus clock low timeout */
+#define GPIO_SPI_FREQ_DEFAULT		1000000	/* Hz */
+
+typedef struct {
+	int bank;
+	int gpio;
+	int backend;		/* GPIO_BACKEND_* of the bank */
+	uint32_t bit;		/* 1 << gpio */
+	GPIO_Handle *handle;
+	int dir_fd;		/* gpioN/direction, open-drain emulation on sysfs */
+	int level;		/* last level set, -1 if unknown */
+} GPIO_BitbangPin;
+
+typedef struct {
+	GPIO_BitbangPin scl;
+	GPIO_BitbangPin sda;
+	uint16_t addr;		/* slave of GPIOI2CRead/Write, as ioctl(I2C_SLAVE) */
+	uint64_t half_ns;	/* half SCL period */
+	uint64_t stretch_ns;	/* clock stretching limit */
+	uint64_t t;		/* deadline of the current half period */
+	uint64_t stretches;	/* SCL edges held low by a slave */
+} GPIO_I2C;
+
+typedef struct {
+	int sclk_bank, sclk_gpio;
+	int mosi_bank, mosi_gpio;	/* -1 bank: receive only */
+	int miso_bank, miso_gpio;	/* -1 bank: transmit only */
+	int cs_bank, cs_gpio;		/* -1 bank: chip select handled by the caller */
+	int mode;			/* SPI_MODE_0..3, optionally | SPI_LSB_FIRST | SPI_CS_HIGH */
+	unsigned int speed_hz;
+} GPIO_SPIConfig;
+
+typedef struct {
+	GPIO_BitbangPin sclk;
+	GPIO_BitbangPin mosi;
+	GPIO_BitbangPin miso;
+	GPIO_BitbangPin cs;
+	int mode;
+	unsigned int speed_hz;
+	uint64_t half_ns;
+	uint64_t t;
+} GPIO_SPI;
+
+/** @} */
+
+extern GPIO_I2C *GPIOI2COpen(int scl_bank, int scl_gpio, int sda_bank, int sda_gpio,
+			     unsigned int freq_hz);
+extern int GPIOI2CSetSlave(GPIO_I2C *bus, int addr);
+extern int GPIOI2CWrite(GPIO_I2C *bus, const void *buf, int len);
+extern int GPIOI2CRead(GPIO_I2C *bus, void *buf, int len);
+extern int GPIOI2CTransfer(GPIO_I2C *bus, struct i2c_msg *msgs, int num);
+extern int GPIOI2CRecover(GPIO_I2C *bus);
+extern void GPIOI2CClose(GPIO_I2C *bus);
+
+extern GPIO_SPI *GPIOSPIOpen(const GPIO_SPIConfig *config);
+extern int GPIOSPITransfer(GPIO_SPI *bus, struct spi_ioc_transfer *xfers, int num);
+extern void GPIOSPIClose(GPIO_SPI *bus);
+
+
+#endif /*__GPIO_BITBANG_H */
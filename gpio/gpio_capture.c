@@ -0,0 +1,345 @@
+/**
+  ******************************************************************************
+  * @file    gpio_capture.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides the GPIO event capture subsystem:
+  *           - Capture thread blocking on a GPIO event set
+  *           - Lock-free single-producer/single-consumer event ring
+  *           - Batched draining by application threads
+  *           - Capture/overflow statistics
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of GPIO Event Capture
+  *          ===================================================================
+  *
+  *          Capture Path
+  *          =====================
+  *          - One thread per GPIO_Capture sleeps in GPIOEventWait()
+  *          - Every {bank, pin, edge, timestamp} record is copied into a
+  *            power-of-two ring; no locks, no allocation, no printing
+  *          - The thread can run SCHED_FIFO so bursts are taken off the
+  *            kernel queue before it overflows
+  *
+  *          Event Ring
+  *          =======================
+  *          - head is advanced only by the capture thread, tail only by the
+  *            consumer; both are free running 32-bit counters
+  *          - Release/acquire ordering on head/tail publishes the records,
+  *            so exactly one producer and one consumer thread are allowed
+  *          - A full ring drops the newest event and counts an overflow,
+  *            the capture thread never blocks on the application
+  *          - If the event set fails (closed fd, end of a replay) the
+  *            thread records the error and ends; GPIOCaptureWait() returns
+  *            -1 with that errno once the ring is drained
+  *
+  *          Consumer
+  *          =======================
+  *          - GPIOCaptureDrain() copies out as many events as are available
+  *          - GPIOCaptureWait() / GPIOCaptureFd() block until a batch was
+  *            pushed; the fd can be added to the application's own epoll
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_capture.h" in your application
+  *            - Initialise input pins with GPIOInit(bank, pin, IN)
+  *            - Create the capture, add pins, start it
+  *            - Drain events from one application thread
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c gpio_event.c
+  *                            gpio_thread.c gpio_capture.c your_app.c -pthread
+  *
+  *          Example Usage:
+  *            GPIO_Capture *cap = GPIOCaptureCreate(GPIO_CAPTURE_RING_DEFAULT);
+  *            GPIO_Event ev[64];
+  *            int i, n;
+  *
+  *            GPIOCaptureAdd(cap, 2, 24, GPIO_EDGE_BOTH);
+  *            GPIOCaptureAdd(cap, 2, 25, GPIO_EDGE_RISING);
+  *            GPIOCaptureStart(cap, 50);             // SCHED_FIFO 50
+  *            while (1) {
+  *                GPIOCaptureWait(cap, -1);
+  *                n = GPIOCaptureDrain(cap, ev, 64);
+  *                for (i = 0; i < n; i++)
+  *                    handle_event(&ev[i]);          // may be slow
+  *            }
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "gpio_capture.h"
+
+#define GPIO_CAPTURE_BATCH	64
+
+static void
+GPIOCapturePush(GPIO_Capture *cap, const GPIO_Event *events, int num)
+{
+	uint32_t head;
+	uint32_t tail;
+	uint32_t used;
+	uint32_t high;
+	int i;
+
+	head = atomic_load_explicit(&cap->head, memory_order_relaxed);
+	tail = atomic_load_explicit(&cap->tail, memory_order_acquire);
+
+	for (i = 0; i < num; i++) {
+		if (head - tail == cap->size) {
+			atomic_fetch_add_explicit(&cap->overflows, num - i, memory_order_relaxed);
+			break;
+		}
+		cap->ring[head & cap->mask] = events[i];
+		head++;
+	}
+
+	atomic_store_explicit(&cap->head, head, memory_order_release);
+	atomic_fetch_add_explicit(&cap->captured, i, memory_order_relaxed);
+
+	used = head - tail;
+	high = atomic_load_explicit(&cap->high_water, memory_order_relaxed);
+	if (used > high)
+		atomic_store_explicit(&cap->high_water, used, memory_order_relaxed);
+}
+
+static void *
+GPIOCaptureThread(void *arg)
+{
+	GPIO_Capture *cap = arg;
+	GPIO_Event batch[GPIO_CAPTURE_BATCH];
+	uint64_t one = 1;
+	int n;
+
+	while (GPIOThreadRunning(&cap->thread)) {
+		n = GPIOEventWait(cap->set, batch, GPIO_CAPTURE_BATCH, -1);
+		if (-1 == n && EINTR != errno) {
+			/* a dead source (closed fd, end of a replay) would spin here */
+			__atomic_store_n(&cap->error, errno ? errno : EIO, __ATOMIC_RELEASE);
+			write(cap->notify_fd, &one, sizeof(one));
+			break;
+		}
+		if (n <= 0)
+			continue;
+
+		GPIOCapturePush(cap, batch, n);
+		write(cap->notify_fd, &one, sizeof(one));
+	}
+
+	return(NULL);
+}
+
+/**
+  * @brief  Allocates a capture with an event ring of at least size entries.
+  * @param  size: ring capacity, rounded up to a power of two
+  * @retval Capture object, NULL on error
+  */
+GPIO_Capture *
+GPIOCaptureCreate(unsigned int size)
+{
+	struct epoll_event ev;
+	GPIO_Capture *cap;
+	uint32_t ring = 2;
+
+	if (0 == size)
+		size = GPIO_CAPTURE_RING_DEFAULT;
+	while (ring < size && ring < 0x80000000U)
+		ring <<= 1;
+
+	cap = calloc(1, sizeof(*cap));
+	if (NULL == cap)
+		return(NULL);
+
+	cap->ring = calloc(ring, sizeof(GPIO_Event));
+	cap->set = GPIOEventSetCreate();
+	cap->notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (NULL == cap->ring || NULL == cap->set || GPIOThreadInit(&cap->thread) ||
+	    -1 == cap->notify_fd) {
+		fprintf(stderr, "Failed to allocate gpio capture!\n");
+		GPIOCaptureDestroy(cap);
+		return(NULL);
+	}
+
+	/* the stop fd is not a source of the set, GPIOEventWait() returns 0 for it */
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = cap->thread.stop_fd;
+	epoll_ctl(cap->set->epfd, EPOLL_CTL_ADD, cap->thread.stop_fd, &ev);
+
+	cap->size = ring;
+	cap->mask = ring - 1;
+	atomic_init(&cap->head, 0);
+	atomic_init(&cap->tail, 0);
+	atomic_init(&cap->captured, 0);
+	atomic_init(&cap->drained, 0);
+	atomic_init(&cap->overflows, 0);
+	atomic_init(&cap->high_water, 0);
+
+	return(cap);
+}
+
+int
+GPIOCaptureAdd(GPIO_Capture *cap, int bank, int gpio, int edge)
+{
+	if (NULL == cap || cap->thread.running)
+		return(-1);
+
+	return(GPIOEventSetAdd(cap->set, bank, gpio, edge));
+}
+
+/**
+  * @brief  Starts the capture thread.
+  * @param  cap: capture object
+  * @param  priority: SCHED_FIFO priority (1-99), 0 keeps the default policy
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOCaptureStart(GPIO_Capture *cap, int priority)
+{
+	if (NULL == cap || cap->thread.running)
+		return(-1);
+
+	cap->error = 0;
+	return(GPIOThreadStart(&cap->thread, GPIOCaptureThread, cap, priority, "capture"));
+}
+
+/**
+  * @brief  Copies captured events out of the ring (consumer side).
+  * @param  cap: capture object
+  * @param  events: output array
+  * @param  max: capacity of events
+  * @retval Number of events copied
+  */
+int
+GPIOCaptureDrain(GPIO_Capture *cap, GPIO_Event *events, int max)
+{
+	uint32_t head;
+	uint32_t tail;
+	uint32_t avail;
+	uint32_t first;
+	uint32_t n;
+
+	if (NULL == cap || NULL == events || max < 1)
+		return(0);
+
+	tail = atomic_load_explicit(&cap->tail, memory_order_relaxed);
+	head = atomic_load_explicit(&cap->head, memory_order_acquire);
+
+	avail = head - tail;
+	n = (avail < (uint32_t)max) ? avail : (uint32_t)max;
+	if (0 == n)
+		return(0);
+
+	/* at most two contiguous chunks because of the wrap-around */
+	first = cap->size - (tail & cap->mask);
+	if (first > n)
+		first = n;
+	memcpy(events, &cap->ring[tail & cap->mask], first * sizeof(GPIO_Event));
+	memcpy(events + first, cap->ring, (n - first) * sizeof(GPIO_Event));
+
+	atomic_store_explicit(&cap->tail, tail + n, memory_order_release);
+	atomic_fetch_add_explicit(&cap->drained, n, memory_order_relaxed);
+
+	return((int)n);
+}
+
+/**
+  * @brief  Blocks until the capture thread pushed events.
+  * @retval 1 if events may be available, 0 on timeout, -1 on error or
+  *         once the capture thread ended and the ring is drained (errno
+  *         holds the error that ended it)
+  */
+int
+GPIOCaptureWait(GPIO_Capture *cap, int timeout_ms)
+{
+	struct pollfd pfd;
+	uint64_t count;
+	int ret;
+
+	if (NULL == cap)
+		return(-1);
+
+	if (atomic_load_explicit(&cap->head, memory_order_acquire) !=
+	    atomic_load_explicit(&cap->tail, memory_order_relaxed))
+		return(1);
+
+	if (__atomic_load_n(&cap->error, __ATOMIC_ACQUIRE)) {
+		errno = cap->error;
+		return(-1);
+	}
+
+	pfd.fd = cap->notify_fd;
+	pfd.events = POLLIN;
+	ret = poll(&pfd, 1, timeout_ms);
+	if (-1 == ret)
+		return((EINTR == errno) ? 0 : -1);
+	if (0 == ret)
+		return(0);
+
+	read(cap->notify_fd, &count, sizeof(count));
+	if (__atomic_load_n(&cap->error, __ATOMIC_ACQUIRE) &&
+	    atomic_load_explicit(&cap->head, memory_order_acquire) ==
+	    atomic_load_explicit(&cap->tail, memory_order_relaxed)) {
+		errno = cap->error;
+		return(-1);
+	}
+	return(1);
+}
+
+int
+GPIOCaptureFd(GPIO_Capture *cap)
+{
+	return((NULL == cap) ? -1 : cap->notify_fd);
+}
+
+void
+GPIOCaptureGetStats(GPIO_Capture *cap, GPIO_CaptureStats *stats)
+{
+	if (NULL == cap || NULL == stats)
+		return;
+
+	stats->captured = atomic_load_explicit(&cap->captured, memory_order_relaxed);
+	stats->drained = atomic_load_explicit(&cap->drained, memory_order_relaxed);
+	stats->overflows = atomic_load_explicit(&cap->overflows, memory_order_relaxed);
+	stats->high_water = atomic_load_explicit(&cap->high_water, memory_order_relaxed);
+}
+
+int
+GPIOCaptureStop(GPIO_Capture *cap)
+{
+	if (NULL == cap)
+		return(-1);
+
+	return(GPIOThreadStop(&cap->thread));
+}
+
+void
+GPIOCaptureDestroy(GPIO_Capture *cap)
+{
+	if (NULL == cap)
+		return;
+
+	GPIOThreadDestroy(&cap->thread);
+	if (NULL != cap->set)
+		GPIOEventSetDestroy(cap->set);
+	if (cap->notify_fd > 0)
+		close(cap->notify_fd);
+	free(cap->ring);
+	free(cap);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,68 @@
+/**
+  ******************************************************************************
+  * @file    gpio_capture.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the GPIO
+  *          event capture subsystem.
+  *
+  * @details Provides the following functionality:
+  *          - Dedicated capture thread per event set
+  *          - Single-producer/single-consumer lock-free event ring
+  *          - Batched draining and overflow statistics
+  ******************************************************************************
+  * @defgroup GPIO_Capture GPIO Event Capture
+  * @brief Capture thread and event ring
+  * @{
+  */
+
+#ifndef __GPIO_CAPTURE_H
+#define __GPIO_CAPTURE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "gpio_event.h"
+#include "gpio_thread.h"
+
+#define GPIO_CAPTURE_RING_DEFAULT	4096	/* events, rounded up to a power of two */
+
+typedef struct {
+	uint64_t captured;	/* events pushed into the ring */
+	uint64_t drained;	/* events handed to the application */
+	uint64_t overflows;	/* events dropped because the ring was full */
+	uint32_t high_water;	/* highest ring fill level seen */
+} GPIO_CaptureStats;
+
+typedef struct {
+	GPIO_EventSet *set;
+	GPIO_Thread thread;	/* capture thread, its stop fd is in the set */
+	int error;		/* errno that ended the capture thread, 0 while it runs */
+	int notify_fd;		/* eventfd signalled after every pushed batch */
+
+	GPIO_Event *ring;
+	uint32_t size;
+	uint32_t mask;
+	_Atomic uint32_t head;	/* written by the capture thread only */
+	_Atomic uint32_t tail;	/* written by the consumer only */
+
+	_Atomic uint64_t captured;
+	_Atomic uint64_t drained;
+	_Atomic uint64_t overflows;
+	_Atomic uint32_t high_water;
+} GPIO_Capture;
+
+/** @} */
+
+extern GPIO_Capture *GPIOCaptureCreate(unsigned int size);
+extern int GPIOCaptureAdd(GPIO_Capture *cap, int bank, int gpio, int edge);
+extern int GPIOCaptureStart(GPIO_Capture *cap, int priority);
+extern int GPIOCaptureDrain(GPIO_Capture *cap, GPIO_Event *events, int max);
+extern int GPIOCaptureWait(GPIO_Capture *cap, int timeout_ms);
+extern int GPIOCaptureFd(GPIO_Capture *cap);
+extern void GPIOCaptureGetStats(GPIO_Capture *cap, GPIO_CaptureStats *stats);
+extern int GPIOCaptureStop(GPIO_Capture *cap);
+extern void GPIOCaptureDestroy(GPIO_Capture *cap);
+
+
+#endif /*__GPIO_CAPTURE_H */
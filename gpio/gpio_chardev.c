@@ -0,0 +1,528 @@
+/**
+  ******************************************************************************
+  * @file    gpio_chardev.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides the GPIO character-device backend:
+  *           - Bank to /dev/gpiochipN mapping
+  *           - Multi-line requests (GPIO_V2_GET_LINE_IOCTL)
+  *           - Atomic read/write of line groups (GET/SET_VALUES)
+  *           - Single pin backend for GPIOInit/GPIORead/GPIOWrite
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the GPIO Character Device
+  *          ===================================================================
+  *
+  *          Line Requests
+  *          =====================
+  *          - Each GPIO bank is a gpiochip, by default /dev/gpiochip<bank>
+  *          - A line request reserves up to 64 lines of one chip and
+  *            returns a single fd for all of them
+  *          - GPIO_V2_LINE_GET_VALUES/SET_VALUES read or drive any subset of
+  *            the lines in one ioctl, so simultaneous output changes are
+  *            applied together by the kernel
+  *          - Lines are released when the request fd is closed; nothing is
+  *            left exported behind a crashed process
+  *
+  *          Backend Selection
+  *          =======================
+  *          - GPIOSetBackend(bank, GPIO_BACKEND_CHARDEV) routes GPIOInit(),
+  *            GPIORead() and GPIOWrite() of that bank through this file
+  *          - GPIOInit() then holds a single-line request per pin
+  *          - Pins covered by GPIOLinesRequest() are bound to the group, so
+  *            GPIORead()/GPIOWrite() on them reuse the group fd
+  *          - GPIODirection() on a pin of a group reconfigures only that
+  *            line, the other lines keep their direction and levels
+  *          - A request fails without touching existing handles; lines
+  *            the library holds itself are handed over only once the new
+  *            request goes through
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_chardev.h" in your application
+  *            - Override the chip of a bank with GPIOSetChip() if the
+  *              gpiochip numbering does not follow the bank numbering
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c gpio_thread.c
+  *                            your_app.c -o gpio_app -pthread
+  *            - Requires a kernel with GPIO uAPI v2 (5.10 or newer)
+  *
+  *          Example Usage:
+  *            // GPIO2_22..25 in one request, read and drive in one ioctl each
+  *            static const int pins[] = { 22, 23, 24, 25 };
+  *            GPIO_Lines *l = GPIOLinesRequest(2, pins, 4, OUT);
+  *            GPIOLinesWrite(l, 0x3, 0x1);   // GPIO2_22 HIGH, GPIO2_23 LOW
+  *            GPIOLinesRelease(l);
+  *
+  *            // Same entry points as the sysfs driver
+  *            GPIOSetBackend(2, GPIO_BACKEND_CHARDEV);
+  *            GPIOInit(2, 24, IN);
+  *            int val = GPIORead(2, 24);
+  *
+  *          Testing without hardware:
+  *            modprobe gpio-mockup gpio_mockup_ranges=-1,32
+  *            GPIOSetChip(2, "/dev/gpiochipX");   // the mockup chip
+  *            // or create a gpio-sim chip through configfs and read the
+  *            // simulated line levels from /sys/devices/platform/gpio-sim.*
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/ioctl.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include "gpio_chardev.h"
+
+#define GPIO_CONSUMER	"calixto-gpio"
+
+static char s_chip_path[GPIO_MAX_BANKS][GPIO_CHIP_PATH_MAX];
+
+int
+GPIOSetChip(int bank, const char *path)
+{
+	if (bank < 0 || bank >= GPIO_MAX_BANKS || NULL == path)
+		return(-1);
+
+	snprintf(s_chip_path[bank], GPIO_CHIP_PATH_MAX, "%s", path);
+	return(0);
+}
+
+int
+GPIOChipOpen(int bank)
+{
+	char path[GPIO_CHIP_PATH_MAX];
+	int fd;
+
+	if (bank >= 0 && bank < GPIO_MAX_BANKS && s_chip_path[bank][0])
+		snprintf(path, GPIO_CHIP_PATH_MAX, "%s", s_chip_path[bank]);
+	else
+		snprintf(path, GPIO_CHIP_PATH_MAX, "/dev/gpiochip%d", bank);
+
+	fd = open(path, O_RDWR | O_CLOEXEC);
+	if (-1 == fd) {
+		fprintf(stderr, "Failed to open %s!\n", path);
+		return(-1);
+	}
+
+	return(fd);
+}
+
+static uint64_t
+GPIOLinesFlags(int dir)
+{
+	if (OUT == dir)
+		return(GPIO_V2_LINE_FLAG_OUTPUT);
+	if (OUT_OPEN_DRAIN == dir)
+		return(GPIO_V2_LINE_FLAG_OUTPUT | GPIO_V2_LINE_FLAG_OPEN_DRAIN);
+	if (IN == dir)
+		return(GPIO_V2_LINE_FLAG_INPUT);
+
+	return(0);	/* keep the current direction */
+}
+
+int
+GPIOLinesRead(GPIO_Lines *lines, uint64_t mask, uint64_t *values)
+{
+	struct gpio_v2_line_values lv;
+
+	if (NULL == lines || -1 == lines->fd || NULL == values)
+		return(-1);
+
+	lv.mask = mask;
+	lv.bits = 0;
+	if (-1 == ioctl(lines->fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &lv)) {
+		fprintf(stderr, "Failed to read gpio lines!\n");
+		return(-1);
+	}
+
+	*values = lv.bits & mask;
+	return(0);
+}
+
+int
+GPIOLinesWrite(GPIO_Lines *lines, uint64_t mask, uint64_t values)
+{
+	struct gpio_v2_line_values lv;
+
+	if (NULL == lines || -1 == lines->fd)
+		return(-1);
+
+	lv.mask = mask;
+	lv.bits = values & mask;
+	if (-1 == ioctl(lines->fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &lv)) {
+		fprintf(stderr, "Failed to write gpio lines!\n");
+		return(-1);
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Applies the line directions and edge detection of a group with SET_CONFIG.
+  * @note   The config replaces the whole request, so every line gets its
+  *         own direction from line_dir[] and the current output levels are
+  *         passed along to keep outputs from glitching low.
+  * @retval 0 on success, -1 on error
+  */
+static int
+GPIOLinesConfigure(GPIO_Lines *lines, uint64_t rising, uint64_t falling)
+{
+	static const int s_dirs[] = { IN, OUT, OUT_OPEN_DRAIN };
+
+	struct gpio_v2_line_config cfg;
+	struct gpio_v2_line_attribute *attr;
+	uint64_t edges;
+	uint64_t both;
+	uint64_t outputs = 0;
+	uint64_t mask;
+	uint64_t values;
+	unsigned int n = 0;
+	int d;
+	int i;
+
+	edges = rising | falling;
+	both = rising & falling;
+
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.flags = GPIOLinesFlags(lines->dir);
+
+	if (both) {
+		attr = &cfg.attrs[n++].attr;
+		attr->id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+		attr->flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING |
+			      GPIO_V2_LINE_FLAG_EDGE_FALLING;
+		cfg.attrs[n - 1].mask = both;
+	}
+	if (rising & ~both) {
+		attr = &cfg.attrs[n++].attr;
+		attr->id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+		attr->flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING;
+		cfg.attrs[n - 1].mask = rising & ~both;
+	}
+	if (falling & ~both) {
+		attr = &cfg.attrs[n++].attr;
+		attr->id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+		attr->flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+		cfg.attrs[n - 1].mask = falling & ~both;
+	}
+
+	/* lines configured apart from the rest of the request */
+	for (d = 0; d < 3; d++) {
+		mask = 0;
+		for (i = 0; i < lines->num_lines; i++) {
+			if (lines->line_dir[i] == s_dirs[d] && !(edges & (1ULL << i)))
+				mask |= 1ULL << i;
+		}
+		if (OUT == s_dirs[d] || OUT_OPEN_DRAIN == s_dirs[d])
+			outputs |= mask;
+		if (0 == mask || s_dirs[d] == lines->dir)
+			continue;
+
+		attr = &cfg.attrs[n++].attr;
+		attr->id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+		attr->flags = GPIOLinesFlags(s_dirs[d]);
+		cfg.attrs[n - 1].mask = mask;
+	}
+
+	if (outputs && 0 == GPIOLinesRead(lines, outputs, &values)) {
+		attr = &cfg.attrs[n++].attr;
+		attr->id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		attr->values = values;
+		cfg.attrs[n - 1].mask = outputs;
+	}
+	cfg.num_attrs = n;
+
+	for (i = 0; i < lines->num_lines; i++)
+		GPIOShadowInvalidate(lines->bank, 1U << lines->gpio[i]);
+
+	if (-1 == ioctl(lines->fd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &cfg)) {
+		fprintf(stderr, "Failed to configure gpio lines!\n");
+		return(-1);
+	}
+
+	lines->rising = rising;
+	lines->falling = falling;
+	return(0);
+}
+
+/* line request ioctl, the lines are not bound to the handle cache yet */
+static GPIO_Lines *
+GPIOLinesTry(int bank, const int *gpios, int num, int dir)
+{
+	struct gpio_v2_line_request req;
+	GPIO_Lines *lines;
+	int chip;
+	int i;
+
+	memset(&req, 0, sizeof(req));
+	for (i = 0; i < num; i++)
+		req.offsets[i] = gpios[i];
+	req.num_lines = num;
+	req.config.flags = GPIOLinesFlags(dir);
+	if (OUT_OPEN_DRAIN == dir) {
+		req.config.num_attrs = 1;
+		req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+		req.config.attrs[0].attr.values = ~0ULL;
+		req.config.attrs[0].mask = (num >= 64) ? ~0ULL : (1ULL << num) - 1;
+	}
+	snprintf(req.consumer, sizeof(req.consumer), GPIO_CONSUMER);
+
+	chip = GPIOChipOpen(bank);
+	if (-1 == chip)
+		return(NULL);
+
+	if (-1 == ioctl(chip, GPIO_V2_GET_LINE_IOCTL, &req)) {
+		close(chip);
+		return(NULL);
+	}
+	close(chip);
+
+	lines = calloc(1, sizeof(*lines));
+	if (NULL == lines) {
+		close(req.fd);
+		return(NULL);
+	}
+
+	lines->bank = bank;
+	lines->fd = req.fd;
+	lines->dir = dir;
+	lines->num_lines = num;
+	for (i = 0; i < num; i++) {
+		lines->gpio[i] = gpios[i];
+		lines->line_dir[i] = dir;
+	}
+
+	return(lines);
+}
+
+static void
+GPIOLinesBind(GPIO_Lines *lines)
+{
+	int i;
+
+	for (i = 0; i < lines->num_lines; i++)
+		GPIOHandleBind(lines->bank * 32 + lines->gpio[i], lines, i);
+}
+
+/*
+ * releases the requests the library made itself (GPIOInit(), bank
+ * access) on any of the pins, keeping a copy of each in old[]
+ */
+static int
+GPIOLinesEvict(int bank, const int *gpios, int num, GPIO_Lines *old)
+{
+	GPIO_Lines *held;
+	int nold = 0;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		held = GPIOHandleLines(bank * 32 + gpios[i]);
+		if (NULL == held || !held->owned)
+			continue;
+
+		old[nold++] = *held;
+		GPIOLinesRelease(held);
+	}
+
+	return(nold);
+}
+
+/* re-requests evicted requests after the new request failed */
+static void
+GPIOLinesRestore(const GPIO_Lines *old, int nold)
+{
+	GPIO_Lines *lines;
+	int i;
+
+	for (i = 0; i < nold; i++) {
+		lines = GPIOLinesTry(old[i].bank, old[i].gpio, old[i].num_lines, old[i].dir);
+		if (NULL == lines) {
+			fprintf(stderr, "Failed to restore gpio lines!\n");
+			continue;
+		}
+
+		memcpy(lines->line_dir, old[i].line_dir, sizeof(lines->line_dir));
+		if (GPIOLinesConfigure(lines, old[i].rising, old[i].falling))
+			fprintf(stderr, "Failed to restore gpio lines!\n");
+		lines->owned = 1;
+		GPIOLinesBind(lines);
+	}
+}
+
+/**
+  * @brief  Requests a group of lines of one bank with a single fd.
+  * @note   Lines held by requests the library made itself are released
+  *         only if the kernel reports them busy, and requested again if
+  *         the new request still fails; handles are rebound on success.
+  * @param  bank: GPIO bank (gpiochip)
+  * @param  gpios: line offsets inside the bank
+  * @param  num: number of lines (max GPIO_LINES_MAX)
+  * @param  dir: IN, OUT, OUT_OPEN_DRAIN (lines start released) or -1 to
+  *         keep the current direction
+  * @retval Line group, NULL on error. Bit i of values maps to gpios[i].
+  */
+GPIO_Lines *
+GPIOLinesRequest(int bank, const int *gpios, int num, int dir)
+{
+	GPIO_Lines *lines;
+	GPIO_Lines *old;
+	int nold;
+
+	if (NULL == gpios || num < 1 || num > GPIO_LINES_MAX)
+		return(NULL);
+
+	lines = GPIOLinesTry(bank, gpios, num, dir);
+	if (NULL == lines && EBUSY == errno) {
+		old = calloc(num, sizeof(*old));
+		if (NULL != old) {
+			nold = GPIOLinesEvict(bank, gpios, num, old);
+			if (nold > 0) {
+				lines = GPIOLinesTry(bank, gpios, num, dir);
+				if (NULL == lines)
+					GPIOLinesRestore(old, nold);
+			}
+			free(old);
+		}
+	}
+
+	if (NULL == lines) {
+		fprintf(stderr, "Failed to request gpio lines!\n");
+		return(NULL);
+	}
+
+	GPIOLinesBind(lines);
+	return(lines);
+}
+
+/**
+  * @brief  Changes the direction of some lines of a group.
+  * @param  lines: line group
+  * @param  mask: lines (bit i = gpios[i]) to configure, the others keep theirs
+  * @param  dir: IN, OUT or OUT_OPEN_DRAIN
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOLinesDirection(GPIO_Lines *lines, uint64_t mask, int dir)
+{
+	int old[GPIO_LINES_MAX];
+	int i;
+
+	if (NULL == lines || -1 == lines->fd)
+		return(-1);
+
+	memcpy(old, lines->line_dir, sizeof(old));
+	for (i = 0; i < lines->num_lines; i++) {
+		if (mask & (1ULL << i))
+			lines->line_dir[i] = dir;
+	}
+
+	if (GPIOLinesConfigure(lines, lines->rising, lines->falling)) {
+		memcpy(lines->line_dir, old, sizeof(old));
+		return(-1);
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Enables edge detection on a subset of a group.
+  * @param  lines: line group
+  * @param  mask: lines (bit i = gpios[i]) to configure
+  * @param  edge: GPIO_EDGE_NONE/RISING/FALLING/BOTH
+  * @retval 0 on success, -1 on error. Events are read from lines->fd.
+  */
+int
+GPIOLinesEdge(GPIO_Lines *lines, uint64_t mask, int edge)
+{
+	uint64_t rising;
+	uint64_t falling;
+
+	if (NULL == lines || -1 == lines->fd)
+		return(-1);
+
+	rising = lines->rising & ~mask;
+	falling = lines->falling & ~mask;
+	if (edge & GPIO_EDGE_RISING)
+		rising |= mask;
+	if (edge & GPIO_EDGE_FALLING)
+		falling |= mask;
+
+	return(GPIOLinesConfigure(lines, rising, falling));
+}
+
+void
+GPIOLinesRelease(GPIO_Lines *lines)
+{
+	int i;
+
+	if (NULL == lines)
+		return;
+
+	lines->owned = 0;
+	for (i = 0; i < lines->num_lines; i++)
+		GPIOHandleUnbind(lines->bank * 32 + lines->gpio[i], lines);
+
+	if (-1 != lines->fd)
+		close(lines->fd);
+	free(lines);
+}
+
+/**
+  * @brief  Tells whether a line is already requested with a direction.
+  * @note   Requesting an output line again drives it LOW, so re-init of a
+  *         pin that is already set up must leave its request alone.
+  * @retval 1 if the line is held with dir, 0 otherwise
+  */
+int
+GPIOLinesHeld(int bank, int gpio, int dir)
+{
+	GPIO_Lines *lines;
+	int i;
+
+	lines = GPIOHandleLines(bank * 32 + gpio);
+	if (NULL == lines || -1 == lines->fd || -1 == dir)
+		return(0);
+
+	for (i = 0; i < lines->num_lines; i++) {
+		if (lines->gpio[i] == gpio)
+			return(dir == lines->line_dir[i]);
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  GPIOInit() of a bank using the chardev backend.
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOChardevInit(int bank, int gpio, int dir)
+{
+	GPIO_Lines *lines;
+
+	if (GPIOLinesHeld(bank, gpio, dir))
+		return(0);
+
+	lines = GPIOLinesRequest(bank, &gpio, 1, dir);
+	if (NULL == lines)
+		return(-1);
+
+	lines->owned = 1;
+	return(0);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,57 @@
+/**
+  ******************************************************************************
+  * @file    gpio_chardev.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the GPIO
+  *          character-device backend (Linux GPIO uAPI v2).
+  *
+  * @details Provides the following functionality:
+  *          - Multi-line requests on /dev/gpiochipN
+  *          - Single-ioctl read/write of a group of lines
+  *          - Bank to gpiochip mapping
+  ******************************************************************************
+  * @defgroup GPIO_Lines GPIO Line Requests
+  * @brief Group of lines of one bank held by a single request fd
+  * @{
+  */
+
+#ifndef __GPIO_CHARDEV_H
+#define __GPIO_CHARDEV_H
+
+#include <stdint.h>
+#include "sysfs_gpio.h"
+
+#define GPIO_LINES_MAX		64	/* GPIO_V2_LINES_MAX */
+#define GPIO_CHIP_PATH_MAX	64
+
+typedef struct GPIO_Lines {
+	int bank;			/* bank the lines belong to */
+	int fd;				/* line request fd, -1 when released */
+	int dir;			/* IN / OUT as requested */
+	int num_lines;			/* number of requested lines */
+	int gpio[GPIO_LINES_MAX];	/* line offsets in request order */
+	int line_dir[GPIO_LINES_MAX];	/* direction of each line, -1 as found */
+	int owned;			/* requested by the library, released with its pins */
+	uint64_t rising;		/* lines with rising edge detection */
+	uint64_t falling;		/* lines with falling edge detection */
+} GPIO_Lines;
+
+/** @} */
+
+extern int GPIOSetChip(int bank, const char *path);
+extern int GPIOChipOpen(int bank);
+
+extern GPIO_Lines *GPIOLinesRequest(int bank, const int *gpios, int num, int dir);
+extern int GPIOLinesRead(GPIO_Lines *lines, uint64_t mask, uint64_t *values);
+extern int GPIOLinesWrite(GPIO_Lines *lines, uint64_t mask, uint64_t values);
+extern int GPIOLinesDirection(GPIO_Lines *lines, uint64_t mask, int dir);
+extern int GPIOLinesEdge(GPIO_Lines *lines, uint64_t mask, int edge);
+extern void GPIOLinesRelease(GPIO_Lines *lines);
+extern int GPIOLinesHeld(int bank, int gpio, int dir);
+
+extern int GPIOChardevInit(int bank, int gpio, int dir);
+
+
+#endif /*__GPIO_CHARDEV_H */
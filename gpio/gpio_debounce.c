@@ -0,0 +1,361 @@
+/**
+  ******************************************************************************
+  * @file    gpio_debounce.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides the GPIO input debounce engine:
+  *           - Stable-time and integrator filters per pin
+  *           - Filtering of timestamped edge events, no re-reading
+  *           - Deadline computation for event loop timeouts
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Debounce Engine
+  *          ===================================================================
+  *
+  *          Input
+  *          =====================
+  *          - The engine consumes the raw edges of gpio_event.c or
+  *            gpio_capture.c; the pin is never re-read to filter it
+  *          - Between two edges the raw level is known exactly, so each
+  *            filter is evaluated in closed form on the edge timestamps
+  *
+  *          Stable-Time Filter (GPIO_DEBOUNCE_STABLE)
+  *          =======================
+  *          - A new level is accepted once it held for the whole window
+  *          - Any edge inside the window restarts it; bursts of contact
+  *            bounce shorter than the window produce no transition at all
+  *
+  *          Integrator Filter (GPIO_DEBOUNCE_INTEGRATOR)
+  *          =======================
+  *          - Integrates time spent HIGH minus time spent LOW, clamped to
+  *            [0, window]; the output turns HIGH at the top and LOW at the
+  *            bottom of the range
+  *          - Acts as a time-weighted majority vote: short glitches only
+  *            move the integrator a little, noisy but dominant levels still
+  *            get through within a bounded delay
+  *
+  *          Output
+  *          =======================
+  *          - Clean transitions are GPIO_Event records; the timestamp is
+  *            that of the raw edge which started the accepted level
+  *          - A transition becomes due when its window expires, which may
+  *            be long after the last raw edge. GPIODebounceTimeout() gives
+  *            the epoll timeout to the next deadline and GPIODebounceFlush()
+  *            emits what is due; GPIODebounceWait() does both
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_debounce.h" in your application
+  *            - Add every filtered pin with its mode and window
+  *            - Arm the same pins for GPIO_EDGE_BOTH in an event set
+  *            - Call GPIODebounceWait() instead of GPIOEventWait()
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c
+  *                            gpio_event.c gpio_thread.c gpio_debounce.c your_app.c
+  *
+  *          Example Usage:
+  *            GPIO_Debounce *db = GPIODebounceCreate();
+  *            GPIO_EventSet *set = GPIOEventSetCreate();
+  *            GPIO_Event ev[8];
+  *            int i, n;
+  *
+  *            GPIOInit(2, 24, IN);
+  *            GPIODebounceAdd(db, 2, 24, GPIO_DEBOUNCE_STABLE, 20000, -1); // 20 ms
+  *            GPIOEventSetAdd(set, 2, 24, GPIO_EDGE_BOTH);
+  *            while (1) {
+  *                n = GPIODebounceWait(db, set, ev, 8, -1);
+  *                for (i = 0; i < n; i++)
+  *                    printf("GPIO2_24 now %d\n", GPIO_EDGE_RISING == ev[i].edge);
+  *            }
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpio_debounce.h"
+#include "gpio_thread.h"
+
+static GPIO_DebouncePin *
+GPIODebounceFind(GPIO_Debounce *db, int bank, int gpio)
+{
+	int i;
+
+	for (i = 0; i < db->num_pins; i++) {
+		if (db->pins[i].bank == bank && db->pins[i].gpio == gpio)
+			return(&db->pins[i]);
+	}
+
+	return(NULL);
+}
+
+/* time the pending level of a pin is accepted, 0 if nothing is pending */
+static uint64_t
+GPIODebounceDeadline(const GPIO_DebouncePin *p)
+{
+	if (GPIO_DEBOUNCE_INTEGRATOR == p->mode) {
+		if (HIGH == p->raw && LOW == p->state)
+			return(p->integ_time + (p->window_ns - p->integ));
+		if (LOW == p->raw && HIGH == p->state)
+			return(p->integ_time + p->integ);
+		return(0);
+	}
+
+	if (p->raw != p->state)
+		return(p->raw_since + p->window_ns);
+
+	return(0);
+}
+
+/**
+  * @brief  Advances the filter of one pin to time now.
+  * @retval 1 if a clean transition was stored in out, 0 otherwise
+  */
+static int
+GPIODebounceAdvance(GPIO_DebouncePin *p, uint64_t now, GPIO_Event *out)
+{
+	uint64_t deadline;
+	uint64_t dt;
+	int emitted = 0;
+
+	deadline = GPIODebounceDeadline(p);
+	if (0 != deadline && deadline <= now) {
+		p->state = p->raw;
+		p->transitions++;
+		out->bank = p->bank;
+		out->gpio = p->gpio;
+		out->edge = (HIGH == p->state) ? GPIO_EDGE_RISING : GPIO_EDGE_FALLING;
+		out->timestamp_ns = p->raw_since;
+		emitted = 1;
+	}
+
+	if (GPIO_DEBOUNCE_INTEGRATOR == p->mode && now > p->integ_time) {
+		dt = now - p->integ_time;
+		if (HIGH == p->raw)
+			p->integ = (p->window_ns - p->integ > dt) ? p->integ + dt : p->window_ns;
+		else
+			p->integ = (p->integ > dt) ? p->integ - dt : 0;
+		p->integ_time = now;
+	}
+
+	return(emitted);
+}
+
+GPIO_Debounce *
+GPIODebounceCreate(void)
+{
+	return(calloc(1, sizeof(GPIO_Debounce)));
+}
+
+/**
+  * @brief  Adds a pin to the debounce engine.
+  * @param  db: debounce engine
+  * @param  bank, gpio: input pin
+  * @param  mode: GPIO_DEBOUNCE_STABLE or GPIO_DEBOUNCE_INTEGRATOR
+  * @param  window_us: stable time / integrator depth in microseconds
+  * @param  level: current level, -1 reads it with GPIORead()
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIODebounceAdd(GPIO_Debounce *db, int bank, int gpio, int mode,
+		unsigned int window_us, int level)
+{
+	GPIO_DebouncePin *p;
+
+	if (NULL == db || db->num_pins >= GPIO_DEBOUNCE_MAX || 0 == window_us)
+		return(-1);
+
+	if (GPIO_DEBOUNCE_STABLE != mode && GPIO_DEBOUNCE_INTEGRATOR != mode)
+		return(-1);
+
+	if (NULL != GPIODebounceFind(db, bank, gpio))
+		return(-1);
+
+	if (level < 0)
+		level = GPIORead(bank, gpio);
+	if (level < 0)
+		return(-1);
+
+	p = &db->pins[db->num_pins++];
+	memset(p, 0, sizeof(*p));
+	p->bank = bank;
+	p->gpio = gpio;
+	p->mode = mode;
+	p->window_ns = (uint64_t)window_us * 1000;
+	p->state = level ? HIGH : LOW;
+	p->raw = p->state;
+	p->raw_since = GPIONowNs();
+	p->integ = (HIGH == p->state) ? p->window_ns : 0;
+	p->integ_time = p->raw_since;
+
+	return(0);
+}
+
+/**
+  * @brief  Feeds raw edges and collects the clean transitions they complete.
+  * @param  db: debounce engine
+  * @param  in: raw edges in timestamp order, other pins are ignored
+  * @param  num: number of raw edges
+  * @param  out: clean transitions, needs room for num entries
+  * @param  max: capacity of out
+  * @retval Number of clean transitions stored
+  */
+int
+GPIODebounceFeed(GPIO_Debounce *db, const GPIO_Event *in, int num, GPIO_Event *out, int max)
+{
+	GPIO_DebouncePin *p;
+	GPIO_Event spill;
+	int count = 0;
+	int level;
+	int i;
+
+	if (NULL == db || NULL == in)
+		return(0);
+
+	for (i = 0; i < num; i++) {
+		p = GPIODebounceFind(db, in[i].bank, in[i].gpio);
+		if (NULL == p)
+			continue;
+
+		/* the level before this edge may have become stable meanwhile */
+		if (count < max)
+			count += GPIODebounceAdvance(p, in[i].timestamp_ns, &out[count]);
+		else
+			GPIODebounceAdvance(p, in[i].timestamp_ns, &spill);
+
+		level = (GPIO_EDGE_RISING == in[i].edge) ? HIGH : LOW;
+		p->edges++;
+		if (level == p->raw)
+			continue;
+
+		p->raw = level;
+		p->raw_since = in[i].timestamp_ns;
+	}
+
+	return(count);
+}
+
+/**
+  * @brief  Emits transitions whose window expired by now.
+  * @retval Number of clean transitions stored
+  */
+int
+GPIODebounceFlush(GPIO_Debounce *db, uint64_t now_ns, GPIO_Event *out, int max)
+{
+	int count = 0;
+	int i;
+
+	if (NULL == db || NULL == out)
+		return(0);
+
+	for (i = 0; i < db->num_pins && count < max; i++)
+		count += GPIODebounceAdvance(&db->pins[i], now_ns, &out[count]);
+
+	return(count);
+}
+
+/**
+  * @brief  Milliseconds until the next pending transition is due.
+  * @retval Timeout for poll/epoll, -1 if nothing is pending
+  */
+int
+GPIODebounceTimeout(GPIO_Debounce *db, uint64_t now_ns)
+{
+	uint64_t deadline;
+	uint64_t next = 0;
+	int i;
+
+	if (NULL == db)
+		return(-1);
+
+	for (i = 0; i < db->num_pins; i++) {
+		deadline = GPIODebounceDeadline(&db->pins[i]);
+		if (0 != deadline && (0 == next || deadline < next))
+			next = deadline;
+	}
+
+	if (0 == next)
+		return(-1);
+	if (next <= now_ns)
+		return(0);
+
+	return((int)((next - now_ns + 999999) / 1000000));
+}
+
+/**
+  * @brief  Waits on an event set and returns debounced transitions only.
+  * @param  db: debounce engine
+  * @param  set: event set with the debounced pins armed for GPIO_EDGE_BOTH
+  * @param  out: clean transitions
+  * @param  max: capacity of out
+  * @param  timeout_ms: -1 waits until a clean transition is produced
+  * @retval Number of clean transitions, 0 on timeout, -1 on error
+  */
+int
+GPIODebounceWait(GPIO_Debounce *db, GPIO_EventSet *set, GPIO_Event *out,
+		 int max, int timeout_ms)
+{
+	GPIO_Event raw[GPIO_DEBOUNCE_MAX];
+	uint64_t start;
+	uint64_t now;
+	int elapsed;
+	int wait_ms;
+	int count;
+	int n;
+
+	if (NULL == db || NULL == set || NULL == out || max < 1)
+		return(-1);
+
+	start = GPIONowNs();
+	while (1) {
+		now = GPIONowNs();
+		count = GPIODebounceFlush(db, now, out, max);
+		if (count > 0)
+			return(count);
+
+		elapsed = (int)((now - start) / 1000000);
+		if (timeout_ms >= 0 && elapsed >= timeout_ms)
+			return(0);
+
+		wait_ms = GPIODebounceTimeout(db, now);
+		if (timeout_ms >= 0 && (wait_ms < 0 || wait_ms > timeout_ms - elapsed))
+			wait_ms = timeout_ms - elapsed;
+
+		n = GPIOEventWait(set, raw, (max < GPIO_DEBOUNCE_MAX) ? max : GPIO_DEBOUNCE_MAX, wait_ms);
+		if (n < 0)
+			return(-1);
+
+		count = GPIODebounceFeed(db, raw, n, out, max);
+		if (count > 0)
+			return(count);
+	}
+}
+
+int
+GPIODebounceLevel(GPIO_Debounce *db, int bank, int gpio)
+{
+	GPIO_DebouncePin *p;
+
+	if (NULL == db)
+		return(-1);
+
+	p = GPIODebounceFind(db, bank, gpio);
+	return((NULL == p) ? -1 : p->state);
+}
+
+void
+GPIODebounceDestroy(GPIO_Debounce *db)
+{
+	free(db);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,65 @@
+/**
+  ******************************************************************************
+  * @file    gpio_debounce.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the GPIO
+  *          input debounce and glitch-filter engine.
+  *
+  * @details Provides the following functionality:
+  *          - Per-pin stable-time debounce
+  *          - Per-pin integrator (time-weighted majority) filter
+  *          - Clean transitions computed from edge timestamps
+  ******************************************************************************
+  * @defgroup GPIO_Debounce GPIO Debounce Engine
+  * @brief Filter modes and per-pin filter state
+  * @{
+  */
+
+#ifndef __GPIO_DEBOUNCE_H
+#define __GPIO_DEBOUNCE_H
+
+#include <stdint.h>
+#include "gpio_event.h"
+
+#define GPIO_DEBOUNCE_MAX		64	/* pins per debounce engine */
+
+#define GPIO_DEBOUNCE_STABLE		0	/* level must hold for the whole window */
+#define GPIO_DEBOUNCE_INTEGRATOR	1	/* level must dominate by the window */
+
+typedef struct {
+	int bank;
+	int gpio;
+	int mode;		/* GPIO_DEBOUNCE_* */
+	uint64_t window_ns;	/* stable time / integrator depth */
+	int state;		/* debounced level delivered to the application */
+	int raw;		/* last raw level seen in the edge stream */
+	uint64_t raw_since;	/* timestamp of the last raw edge */
+	uint64_t integ;		/* integrator, 0 = solid LOW, window_ns = solid HIGH */
+	uint64_t integ_time;	/* timestamp the integrator was advanced to */
+	uint64_t edges;		/* raw edges fed */
+	uint64_t transitions;	/* clean transitions emitted */
+} GPIO_DebouncePin;
+
+typedef struct {
+	int num_pins;
+	GPIO_DebouncePin pins[GPIO_DEBOUNCE_MAX];
+} GPIO_Debounce;
+
+/** @} */
+
+extern GPIO_Debounce *GPIODebounceCreate(void);
+extern int GPIODebounceAdd(GPIO_Debounce *db, int bank, int gpio, int mode,
+			   unsigned int window_us, int level);
+extern int GPIODebounceFeed(GPIO_Debounce *db, const GPIO_Event *in, int num,
+			    GPIO_Event *out, int max);
+extern int GPIODebounceFlush(GPIO_Debounce *db, uint64_t now_ns, GPIO_Event *out, int max);
+extern int GPIODebounceTimeout(GPIO_Debounce *db, uint64_t now_ns);
+extern int GPIODebounceWait(GPIO_Debounce *db, GPIO_EventSet *set, GPIO_Event *out,
+			    int max, int timeout_ms);
+extern int GPIODebounceLevel(GPIO_Debounce *db, int bank, int gpio);
+extern void GPIODebounceDestroy(GPIO_Debounce *db);
+
+
+#endif /*__GPIO_DEBOUNCE_H */
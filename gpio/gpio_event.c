@@ -0,0 +1,358 @@
+/**
+  ******************************************************************************
+  * @file    gpio_event.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides interrupt driven GPIO edge events:
+  *           - Edge selection through sysfs 'edge' or line request flags
+  *           - epoll based wait on a set of pins
+  *           - Timestamped rising/falling edge records
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of GPIO Edge Events
+  *          ===================================================================
+  *
+  *          Sysfs Backend
+  *          =====================
+  *          - Writing "rising", "falling" or "both" to gpioN/edge arms the
+  *            pin interrupt in the kernel
+  *          - gpioN/value then signals EPOLLPRI/EPOLLERR on every edge
+  *          - The value is re-read (pread at offset 0) to re-arm the fd and
+  *            to tell a rising from a falling edge
+  *          - Timestamp is taken with CLOCK_MONOTONIC on wake-up
+  *
+  *          Character Device Backend
+  *          =======================
+  *          - Edge flags are added to the line request with SET_CONFIG
+  *          - The request fd becomes readable and delivers
+  *            struct gpio_v2_line_event records queued by the kernel
+  *          - Timestamp is the kernel's CLOCK_MONOTONIC interrupt time,
+  *            no edge is lost while the application is busy
+  *
+  *          The waiting thread sleeps in epoll_wait(); there is no polling
+  *          and no CPU time is used while the inputs are idle. A source
+  *          that fails to read (e.g. a request fd that was closed) makes
+  *          GPIOEventWait() return -1 with its errno, once the events
+  *          read before it have been returned.
+  *
+  *          Replay
+  *          =======================
+  *          - A set whose replay hook is installed (e.g. by ADCReplayGPIO()
+  *            of adc/adc_record.c) returns recorded events from
+  *            GPIOEventWait() instead of the pins, so edge handling code can
+  *            be run without hardware
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_event.h" in your application
+  *            - Initialise the pins as inputs with GPIOInit(bank, pin, IN)
+  *            - Create a set with GPIOEventSetCreate() and add the pins
+  *            - Call GPIOEventWait() in the monitoring thread
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c gpio_event.c
+  *                            gpio_thread.c your_app.c
+  *
+  *          Example Usage:
+  *            GPIO_EventSet *set = GPIOEventSetCreate();
+  *            GPIO_Event ev[8];
+  *            int i, n;
+  *
+  *            GPIOInit(2, 24, IN);
+  *            GPIOEventSetAdd(set, 2, 24, GPIO_EDGE_BOTH);
+  *            while (1) {
+  *                n = GPIOEventWait(set, ev, 8, -1);
+  *                for (i = 0; i < n; i++)
+  *                    printf("GPIO%d_%d %s at %llu ns\n", ev[i].bank, ev[i].gpio,
+  *                           GPIO_EDGE_RISING == ev[i].edge ? "rising" : "falling",
+  *                           (unsigned long long)ev[i].timestamp_ns);
+  *            }
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/epoll.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include "gpio_chardev.h"
+#include "gpio_event.h"
+#include "gpio_thread.h"
+
+#define GPIO_EVENT_BATCH	16
+
+static GPIO_EventSource *
+GPIOEventFind(GPIO_EventSet *set, int bank, int gpio)
+{
+	int i;
+
+	for (i = 0; i < set->num_sources; i++) {
+		if (set->sources[i].bank == bank && set->sources[i].gpio == gpio)
+			return(&set->sources[i]);
+	}
+
+	return(NULL);
+}
+
+static GPIO_EventSource *
+GPIOEventFindFd(GPIO_EventSet *set, int fd)
+{
+	int i;
+
+	for (i = 0; i < set->num_sources; i++) {
+		if (set->sources[i].fd == fd)
+			return(&set->sources[i]);
+	}
+
+	return(NULL);
+}
+
+GPIO_EventSet *
+GPIOEventSetCreate(void)
+{
+	GPIO_EventSet *set;
+
+	set = calloc(1, sizeof(*set));
+	if (NULL == set)
+		return(NULL);
+
+	set->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (-1 == set->epfd) {
+		fprintf(stderr, "Failed to create epoll instance!\n");
+		free(set);
+		return(NULL);
+	}
+
+	return(set);
+}
+
+/**
+  * @brief  Arms edge detection on an input and adds it to the set.
+  * @param  set: event set
+  * @param  bank, gpio: input pin, already initialised with GPIOInit()
+  * @param  edge: GPIO_EDGE_RISING/FALLING/BOTH
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOEventSetAdd(GPIO_EventSet *set, int bank, int gpio, int edge)
+{
+	struct epoll_event ev;
+	GPIO_EventSource *src;
+	GPIO_Handle *h;
+	char value_str[3];
+	int shared;
+
+	if (NULL == set || GPIO_EDGE_NONE == edge)
+		return(-1);
+
+	if (NULL != GPIOEventFind(set, bank, gpio) || set->num_sources >= GPIO_EVENT_SET_MAX)
+		return(-1);
+
+	h = GPIOOpen(bank, gpio);
+	if (NULL == h)
+		return(-1);
+
+	if (GPIO_BACKEND_MMAP == h->backend) {
+		fprintf(stderr, "Edge events need the sysfs or chardev backend!\n");
+		return(-1);
+	}
+
+	if (GPIO_BACKEND_CHARDEV == h->backend) {
+		if (GPIOLinesEdge(h->lines, 1ULL << h->line, edge))
+			return(-1);
+	} else {
+		if (GPIOEdge(GPIOPinNumber(h->pin / 32, h->pin % 32), edge))
+			return(-1);
+		/* consume the pending notification so the first wait blocks */
+		pread(h->fd, value_str, sizeof(value_str), 0);
+	}
+
+	/* lines of one request share the fd, it is registered only once */
+	shared = (NULL != GPIOEventFindFd(set, h->fd));
+
+	src = &set->sources[set->num_sources];
+	src->bank = bank;
+	src->gpio = gpio;
+	src->edge = edge;
+	src->fd = h->fd;
+	src->lines = (GPIO_BACKEND_CHARDEV == h->backend) ? h->lines : NULL;
+
+	if (!shared) {
+		memset(&ev, 0, sizeof(ev));
+		ev.events = src->lines ? EPOLLIN : (EPOLLPRI | EPOLLERR);
+		ev.data.fd = src->fd;
+		if (-1 == epoll_ctl(set->epfd, EPOLL_CTL_ADD, src->fd, &ev)) {
+			fprintf(stderr, "Failed to add gpio to epoll!\n");
+			return(-1);
+		}
+	}
+
+	set->num_sources++;
+	return(0);
+}
+
+int
+GPIOEventSetRemove(GPIO_EventSet *set, int bank, int gpio)
+{
+	GPIO_EventSource *src;
+	GPIO_Handle *h;
+	int fd;
+
+	if (NULL == set)
+		return(-1);
+
+	src = GPIOEventFind(set, bank, gpio);
+	if (NULL == src)
+		return(-1);
+
+	h = GPIOOpen(bank, gpio);
+	if (NULL != h && NULL != src->lines)
+		GPIOLinesEdge(src->lines, 1ULL << h->line, GPIO_EDGE_NONE);
+	else if (NULL != h)
+		GPIOEdge(GPIOPinNumber(h->pin / 32, h->pin % 32), GPIO_EDGE_NONE);
+
+	fd = src->fd;
+	*src = set->sources[--set->num_sources];
+
+	if (NULL == GPIOEventFindFd(set, fd))
+		epoll_ctl(set->epfd, EPOLL_CTL_DEL, fd, NULL);
+
+	return(0);
+}
+
+static int
+GPIOEventReadLines(GPIO_EventSet *set, GPIO_EventSource *src, GPIO_Event *events, int max)
+{
+	struct gpio_v2_line_event le[GPIO_EVENT_BATCH];
+	GPIO_EventSource *pin;
+	ssize_t len;
+	int count = 0;
+	int n;
+	int i;
+
+	n = (max < GPIO_EVENT_BATCH) ? max : GPIO_EVENT_BATCH;
+	len = read(src->fd, le, n * sizeof(le[0]));
+	if (len < (ssize_t)sizeof(le[0]))
+		return((-1 == len && EAGAIN != errno) ? -1 : 0);
+
+	n = len / sizeof(le[0]);
+	for (i = 0; i < n; i++) {
+		pin = GPIOEventFind(set, src->lines->bank, le[i].offset);
+		if (NULL == pin)
+			continue;
+
+		events[count].bank = pin->bank;
+		events[count].gpio = pin->gpio;
+		events[count].edge = (GPIO_V2_LINE_EVENT_RISING_EDGE == le[i].id) ?
+				     GPIO_EDGE_RISING : GPIO_EDGE_FALLING;
+		events[count].timestamp_ns = le[i].timestamp_ns;
+		count++;
+	}
+
+	return(count);
+}
+
+static int
+GPIOEventReadSysfs(GPIO_EventSource *src, GPIO_Event *event)
+{
+	char value_str[3];
+
+	event->timestamp_ns = GPIONowNs();
+	if (pread(src->fd, value_str, sizeof(value_str), 0) < 1)
+		return(-1);
+
+	event->bank = src->bank;
+	event->gpio = src->gpio;
+	if (GPIO_EDGE_BOTH == src->edge)
+		event->edge = ('0' == value_str[0]) ? GPIO_EDGE_FALLING : GPIO_EDGE_RISING;
+	else
+		event->edge = src->edge;
+
+	return(1);
+}
+
+/**
+  * @brief  Blocks until edges occur on any pin of the set.
+  * @param  set: event set
+  * @param  events: output array
+  * @param  max: capacity of events
+  * @param  timeout_ms: epoll timeout, -1 waits forever
+  * @retval Number of events stored, 0 on timeout, -1 on error
+  */
+int
+GPIOEventWait(GPIO_EventSet *set, GPIO_Event *events, int max, int timeout_ms)
+{
+	struct epoll_event ready[GPIO_EVENT_SET_MAX];
+	GPIO_EventSource *src;
+	int count = 0;
+	int nready;
+	int err;
+	int ret;
+	int i;
+
+	if (NULL == set || NULL == events || max < 1)
+		return(-1);
+
+	if (NULL != set->replay)
+		return(set->replay(set->replay_arg, events, max, timeout_ms));
+
+	nready = epoll_wait(set->epfd, ready, (max < GPIO_EVENT_SET_MAX) ? max : GPIO_EVENT_SET_MAX,
+			    timeout_ms);
+	if (-1 == nready) {
+		if (EINTR == errno)
+			return(0);
+		fprintf(stderr, "Failed to wait for gpio events!\n");
+		return(-1);
+	}
+
+	for (i = 0; i < nready && count < max; i++) {
+		src = GPIOEventFindFd(set, ready[i].data.fd);
+		if (NULL == src)
+			continue;
+
+		if (NULL != src->lines)
+			ret = GPIOEventReadLines(set, src, &events[count], max - count);
+		else
+			ret = GPIOEventReadSysfs(src, &events[count]);
+
+		/* a broken source stays ready: report it rather than return 0 forever */
+		if (ret < 0) {
+			if (count > 0)
+				break;
+			err = errno;
+			fprintf(stderr, "Failed to read gpio events!\n");
+			errno = err;
+			return(-1);
+		}
+		count += ret;
+	}
+
+	return(count);
+}
+
+void
+GPIOEventSetDestroy(GPIO_EventSet *set)
+{
+	if (NULL == set)
+		return;
+
+	while (set->num_sources > 0)
+		GPIOEventSetRemove(set, set->sources[0].bank, set->sources[0].gpio);
+
+	close(set->epfd);
+	free(set);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    gpio_event.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for interrupt
+  *          driven GPIO edge events.
+  *
+  * @details Provides the following functionality:
+  *          - Edge selection (rising/falling/both) per pin
+  *          - Blocking wait on many pins with epoll
+  *          - CLOCK_MONOTONIC event timestamps
+  *          - Replay of recorded events through the same wait call
+  ******************************************************************************
+  * @defgroup GPIO_Event GPIO Edge Events
+  * @brief Event record and event set
+  * @{
+  */
+
+#ifndef __GPIO_EVENT_H
+#define __GPIO_EVENT_H
+
+#include <stdint.h>
+#include "sysfs_gpio.h"
+
+#define GPIO_EVENT_SET_MAX	64	/* pins per event set */
+
+typedef struct {
+	int bank;
+	int gpio;
+	int edge;		/* GPIO_EDGE_RISING or GPIO_EDGE_FALLING */
+	uint64_t timestamp_ns;	/* CLOCK_MONOTONIC */
+} GPIO_Event;
+
+typedef struct {
+	int bank;
+	int gpio;
+	int edge;		/* configured edges */
+	int fd;			/* polled fd: gpioN/value or line request fd */
+	struct GPIO_Lines *lines;	/* line request (chardev only) */
+} GPIO_EventSource;
+
+/* replaces the live pins of a set, e.g. with a recording */
+typedef int (*GPIO_EventReplay)(void *arg, GPIO_Event *events, int max, int timeout_ms);
+
+typedef struct {
+	int epfd;
+	int num_sources;
+	GPIO_EventSource sources[GPIO_EVENT_SET_MAX];
+	GPIO_EventReplay replay;	/* NULL for live pins */
+	void *replay_arg;
+} GPIO_EventSet;
+
+/** @} */
+
+extern GPIO_EventSet *GPIOEventSetCreate(void);
+extern int GPIOEventSetAdd(GPIO_EventSet *set, int bank, int gpio, int edge);
+extern int GPIOEventSetRemove(GPIO_EventSet *set, int bank, int gpio);
+extern int GPIOEventWait(GPIO_EventSet *set, GPIO_Event *events, int max, int timeout_ms);
+extern void GPIOEventSetDestroy(GPIO_EventSet *set);
+
+
+#endif /*__GPIO_EVENT_H */
@@ -0,0 +1,408 @@
+/**
+  ******************************************************************************
+  * @file    gpio_freq.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides frequency and pulse-width measurement on
+  *          GPIO inputs:
+  *           - Measurement thread consuming timestamped edge events
+  *           - Frequency, period, pulse width, duty cycle and pulse count
+  *           - Configurable averaging window per pin
+  *           - Lock-free, non-blocking result reads
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Frequency Counter
+  *          ===================================================================
+  *
+  *          Measurement
+  *          =====================
+  *          - Every pin is armed for both edges; nothing is polled
+  *          - A period is the time between two rising edges, the pulse
+  *            width the time from a rising to the next falling edge
+  *          - Periods are summed until they cover the window, then the
+  *            window is published: frequency = periods / summed time.
+  *            Averaging over many periods removes most of the per-edge
+  *            timestamp jitter
+  *          - A window of 0 publishes every single period; slow signals
+  *            whose period exceeds the window publish once per period
+  *          - A period with a missed falling edge still counts for the
+  *            frequency but not for the pulse width
+  *          - When no rising edge arrived for two windows (or two periods
+  *            if longer) the frequency drops to 0
+  *          - If the event set fails (e.g. a request fd was closed), the
+  *            thread ends and GPIOFreqRead() fails with its errno
+  *
+  *          Timestamps
+  *          =======================
+  *          - Chardev banks deliver the kernel's interrupt timestamps and
+  *            queue edges while the thread is busy: use them for signals
+  *            in the kHz range
+  *          - Sysfs banks are timestamped on wake-up and can merge edges,
+  *            they suit slow signals only
+  *
+  *          Result Access
+  *          =======================
+  *          - Each pin publishes its window under a sequence counter
+  *            (seqlock); GPIOFreqRead() never blocks the measurement
+  *            thread and retries only if it raced with a publication
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_freq.h" in your application
+  *            - Initialise input pins with GPIOInit(bank, pin, IN), the
+  *              chardev backend is recommended above a few hundred Hz
+  *            - Add the pins with their window, start the counter
+  *            - Read results from any thread with GPIOFreqRead()
+  *            - Without a thread, feed events from your own loop with
+  *              GPIOFreqFeed() and GPIOFreqIdle()
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c gpio_event.c
+  *                            gpio_thread.c gpio_freq.c your_app.c -pthread
+  *
+  *          Example Usage:
+  *            GPIO_Freq *freq = GPIOFreqCreate();
+  *            GPIO_FreqResult r;
+  *
+  *            GPIOSetBackend(2, GPIO_BACKEND_CHARDEV);
+  *            GPIOInit(2, 24, IN);
+  *            GPIOFreqAdd(freq, 2, 24, 100000);      // 100 ms window
+  *            GPIOFreqStart(freq, 50);               // SCHED_FIFO 50
+  *            while (1) {
+  *                GPIOFreqRead(freq, 2, 24, &r);
+  *                printf("%.1f Hz, %.1f %% duty, %llu pulses\n", r.frequency_hz,
+  *                       r.duty * 100, (unsigned long long)r.pulses);
+  *                sleep(1);
+  *            }
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/epoll.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gpio_freq.h"
+
+#define GPIO_FREQ_BATCH		64
+
+static GPIO_FreqPin *
+GPIOFreqFind(GPIO_Freq *freq, int bank, int gpio)
+{
+	int i;
+
+	for (i = 0; i < freq->num_pins; i++) {
+		if (freq->pins[i].bank == bank && freq->pins[i].gpio == gpio)
+			return(&freq->pins[i]);
+	}
+
+	return(NULL);
+}
+
+static void
+GPIOFreqReset(GPIO_FreqPin *p)
+{
+	p->win_periods = 0;
+	p->win_span = 0;
+	p->win_high = 0;
+	p->win_duty_span = 0;
+	p->win_high_periods = 0;
+}
+
+/* copies the window into the published snapshot and starts a new one */
+static void
+GPIOFreqPublish(GPIO_FreqPin *p, uint64_t pulses, uint64_t timestamp)
+{
+	uint32_t seq;
+
+	seq = __atomic_load_n(&p->seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&p->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	__atomic_store_n(&p->pub_periods, p->win_periods, __ATOMIC_RELAXED);
+	__atomic_store_n(&p->pub_span, p->win_span, __ATOMIC_RELAXED);
+	__atomic_store_n(&p->pub_high, p->win_high, __ATOMIC_RELAXED);
+	__atomic_store_n(&p->pub_duty_span, p->win_duty_span, __ATOMIC_RELAXED);
+	__atomic_store_n(&p->pub_high_periods, p->win_high_periods, __ATOMIC_RELAXED);
+	__atomic_store_n(&p->pub_pulses, pulses, __ATOMIC_RELAXED);
+	__atomic_store_n(&p->pub_timestamp, timestamp, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&p->seq, seq + 2, __ATOMIC_RELEASE);
+
+	GPIOFreqReset(p);
+}
+
+static void
+GPIOFreqEdge(GPIO_FreqPin *p, const GPIO_Event *ev)
+{
+	uint64_t pulses;
+	uint64_t period;
+
+	if (GPIO_EDGE_FALLING == ev->edge) {
+		p->last_fall = ev->timestamp_ns;
+		return;
+	}
+
+	/* only the measurement thread writes pub_pulses */
+	pulses = p->pub_pulses + 1;
+	if (0 != p->last_rise && ev->timestamp_ns > p->last_rise) {
+		period = ev->timestamp_ns - p->last_rise;
+		p->win_periods++;
+		p->win_span += period;
+		if (p->last_fall > p->last_rise && p->last_fall < ev->timestamp_ns) {
+			p->win_high += p->last_fall - p->last_rise;
+			p->win_duty_span += period;
+			p->win_high_periods++;
+		}
+	}
+	p->last_rise = ev->timestamp_ns;
+
+	if (p->win_periods > 0 && p->win_span >= p->window_ns) {
+		GPIOFreqPublish(p, pulses, ev->timestamp_ns);
+		return;
+	}
+
+	/* keep the count current between windows */
+	__atomic_store_n(&p->pub_pulses, pulses, __ATOMIC_RELAXED);
+}
+
+/**
+  * @brief  Feeds edge events of the counted pins, other pins are ignored.
+  * @param  freq: frequency counter
+  * @param  events: edges in timestamp order
+  * @param  num: number of events
+  */
+void
+GPIOFreqFeed(GPIO_Freq *freq, const GPIO_Event *events, int num)
+{
+	GPIO_FreqPin *p;
+	int i;
+
+	if (NULL == freq || NULL == events)
+		return;
+
+	for (i = 0; i < num; i++) {
+		p = GPIOFreqFind(freq, events[i].bank, events[i].gpio);
+		if (NULL != p)
+			GPIOFreqEdge(p, &events[i]);
+	}
+}
+
+/**
+  * @brief  Drops the frequency of pins whose signal stopped to 0.
+  * @param  freq: frequency counter
+  * @param  now_ns: current CLOCK_MONOTONIC time
+  */
+void
+GPIOFreqIdle(GPIO_Freq *freq, uint64_t now_ns)
+{
+	GPIO_FreqPin *p;
+	uint64_t periods;
+	uint64_t stale;
+	int i;
+
+	if (NULL == freq)
+		return;
+
+	for (i = 0; i < freq->num_pins; i++) {
+		p = &freq->pins[i];
+		periods = p->pub_periods;
+		if (0 == p->last_rise || 0 == periods)
+			continue;
+
+		stale = 2 * p->window_ns;
+		if (stale < 2 * (p->pub_span / periods))
+			stale = 2 * (p->pub_span / periods);
+		if (now_ns - p->last_rise <= stale)
+			continue;
+
+		/* the next rising edge starts a fresh measurement */
+		p->last_rise = 0;
+		GPIOFreqReset(p);
+		GPIOFreqPublish(p, p->pub_pulses, now_ns);
+	}
+}
+
+static void *
+GPIOFreqThread(void *arg)
+{
+	GPIO_Freq *freq = arg;
+	GPIO_Event batch[GPIO_FREQ_BATCH];
+	int n;
+
+	while (GPIOThreadRunning(&freq->thread)) {
+		n = GPIOEventWait(freq->set, batch, GPIO_FREQ_BATCH, GPIO_FREQ_IDLE_MS);
+		if (-1 == n) {
+			/* a failed set would fail again at once: end the measurement */
+			__atomic_store_n(&freq->error, errno ? errno : EIO, __ATOMIC_RELEASE);
+			break;
+		}
+		if (n > 0)
+			GPIOFreqFeed(freq, batch, n);
+		GPIOFreqIdle(freq, GPIONowNs());
+	}
+
+	return(NULL);
+}
+
+GPIO_Freq *
+GPIOFreqCreate(void)
+{
+	struct epoll_event ev;
+	GPIO_Freq *freq;
+
+	freq = calloc(1, sizeof(*freq));
+	if (NULL == freq)
+		return(NULL);
+
+	freq->set = GPIOEventSetCreate();
+	if (NULL == freq->set || GPIOThreadInit(&freq->thread)) {
+		fprintf(stderr, "Failed to allocate gpio frequency counter!\n");
+		GPIOFreqDestroy(freq);
+		return(NULL);
+	}
+
+	/* the stop fd is not a source of the set, GPIOEventWait() returns 0 for it */
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = freq->thread.stop_fd;
+	epoll_ctl(freq->set->epfd, EPOLL_CTL_ADD, freq->thread.stop_fd, &ev);
+
+	return(freq);
+}
+
+/**
+  * @brief  Adds an input to the counter and arms both of its edges.
+  * @param  freq: frequency counter
+  * @param  bank, gpio: input pin, already initialised with GPIOInit()
+  * @param  window_us: averaging window in microseconds, 0 = every period
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOFreqAdd(GPIO_Freq *freq, int bank, int gpio, unsigned int window_us)
+{
+	GPIO_FreqPin *p;
+
+	if (NULL == freq || freq->thread.running || freq->num_pins >= GPIO_FREQ_MAX)
+		return(-1);
+
+	if (NULL != GPIOFreqFind(freq, bank, gpio))
+		return(-1);
+
+	if (GPIOEventSetAdd(freq->set, bank, gpio, GPIO_EDGE_BOTH))
+		return(-1);
+
+	p = &freq->pins[freq->num_pins++];
+	memset(p, 0, sizeof(*p));
+	p->bank = bank;
+	p->gpio = gpio;
+	p->window_ns = (uint64_t)window_us * 1000;
+
+	return(0);
+}
+
+/**
+  * @brief  Starts the measurement thread.
+  * @param  freq: frequency counter
+  * @param  priority: SCHED_FIFO priority (1-99), 0 keeps the default policy
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOFreqStart(GPIO_Freq *freq, int priority)
+{
+	if (NULL == freq)
+		return(-1);
+
+	freq->error = 0;
+	return(GPIOThreadStart(&freq->thread, GPIOFreqThread, freq, priority, "frequency"));
+}
+
+/**
+  * @brief  Returns the last published measurement of a pin without blocking.
+  * @param  freq: frequency counter
+  * @param  bank, gpio: counted pin
+  * @param  result: measurement, all zero until the first window completed
+  * @retval 0 on success, -1 if the pin is not counted or, with errno set,
+  *         if the measurement thread ended on an error
+  */
+int
+GPIOFreqRead(GPIO_Freq *freq, int bank, int gpio, GPIO_FreqResult *result)
+{
+	GPIO_FreqPin *p;
+	uint64_t periods, span, high, duty_span, high_periods, pulses, timestamp;
+	uint32_t seq;
+	int error;
+
+	if (NULL == freq || NULL == result)
+		return(-1);
+
+	error = __atomic_load_n(&freq->error, __ATOMIC_ACQUIRE);
+	if (0 != error) {
+		errno = error;
+		return(-1);
+	}
+
+	p = GPIOFreqFind(freq, bank, gpio);
+	if (NULL == p)
+		return(-1);
+
+	do {
+		seq = __atomic_load_n(&p->seq, __ATOMIC_ACQUIRE);
+		periods = __atomic_load_n(&p->pub_periods, __ATOMIC_RELAXED);
+		span = __atomic_load_n(&p->pub_span, __ATOMIC_RELAXED);
+		high = __atomic_load_n(&p->pub_high, __ATOMIC_RELAXED);
+		duty_span = __atomic_load_n(&p->pub_duty_span, __ATOMIC_RELAXED);
+		high_periods = __atomic_load_n(&p->pub_high_periods, __ATOMIC_RELAXED);
+		pulses = __atomic_load_n(&p->pub_pulses, __ATOMIC_RELAXED);
+		timestamp = __atomic_load_n(&p->pub_timestamp, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((seq & 1) || seq != __atomic_load_n(&p->seq, __ATOMIC_RELAXED));
+
+	memset(result, 0, sizeof(*result));
+	result->pulses = pulses;
+	result->periods = periods;
+	result->timestamp_ns = timestamp;
+	if (0 == periods || 0 == span)
+		return(0);
+
+	result->frequency_hz = (double)periods * 1e9 / (double)span;
+	result->period_ns = span / periods;
+	if (0 != high_periods && 0 != duty_span) {
+		result->high_ns = high / high_periods;
+		result->low_ns = (duty_span - high) / high_periods;
+		result->duty = (double)high / (double)duty_span;
+	}
+
+	return(0);
+}
+
+int
+GPIOFreqStop(GPIO_Freq *freq)
+{
+	if (NULL == freq)
+		return(-1);
+
+	return(GPIOThreadStop(&freq->thread));
+}
+
+void
+GPIOFreqDestroy(GPIO_Freq *freq)
+{
+	if (NULL == freq)
+		return;
+
+	GPIOThreadDestroy(&freq->thread);
+	if (NULL != freq->set)
+		GPIOEventSetDestroy(freq->set);
+	free(freq);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
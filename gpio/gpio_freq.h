@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    gpio_freq.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the GPIO
+  *          frequency counter and pulse-width measurement.
+  *
+  * @details Provides the following functionality:
+  *          - Frequency and period averaged over a time window
+  *          - Pulse width (high time) and duty cycle
+  *          - Pulse count since the pin was added
+  *          - Non-blocking reads while the measurement thread runs
+  ******************************************************************************
+  * @defgroup GPIO_Freq GPIO Frequency Counter
+  * @brief Per-pin accumulators and published results
+  * @{
+  */
+
+#ifndef __GPIO_FREQ_H
+#define __GPIO_FREQ_H
+
+#include <stdint.h>
+#include "gpio_event.h"
+#include "gpio_thread.h"
+
+#define GPIO_FREQ_MAX		GPIO_EVENT_SET_MAX	/* pins per counter */
+#define GPIO_FREQ_IDLE_MS	50	/* wake-up period for stopped-signal detection */
+
+typedef struct {
+	double frequency_hz;	/* 0 when the signal stopped */
+	uint64_t period_ns;	/* average period over the window */
+	uint64_t high_ns;	/* average pulse width, 0 if unknown */
+	uint64_t low_ns;	/* average low time, 0 if unknown */
+	double duty;		/* high time / period, 0.0 - 1.0 */
+	uint64_t pulses;	/* rising edges since the pin was added */
+	uint64_t periods;	/* periods the window averaged */
+	uint64_t timestamp_ns;	/* rising edge that closed the window */
+} GPIO_FreqResult;
+
+typedef struct {
+	int bank;
+	int gpio;
+	uint64_t window_ns;	/* 0 publishes every period */
+
+	/* accumulators, measurement thread only */
+	uint64_t last_rise;
+	uint64_t last_fall;
+	uint64_t win_periods;
+	uint64_t win_span;	/* sum of the periods */
+	uint64_t win_high;	/* sum of the high times */
+	uint64_t win_duty_span;	/* sum of the periods with a known high time */
+	uint64_t win_high_periods;
+
+	/* published snapshot, seqlock protected */
+	uint32_t seq;
+	uint64_t pub_periods;
+	uint64_t pub_span;
+	uint64_t pub_high;
+	uint64_t pub_duty_span;
+	uint64_t pub_high_periods;
+	uint64_t pub_pulses;
+	uint64_t pub_timestamp;
+} GPIO_FreqPin;
+
+typedef struct {
+	GPIO_EventSet *set;
+	GPIO_Thread thread;	/* measurement thread, its stop fd is in the set */
+	int error;		/* errno that ended the measurement thread, 0 while it runs */
+	int num_pins;
+	GPIO_FreqPin pins[GPIO_FREQ_MAX];
+} GPIO_Freq;
+
+/** @} */
+
+extern GPIO_Freq *GPIOFreqCreate(void);
+extern int GPIOFreqAdd(GPIO_Freq *freq, int bank, int gpio, unsigned int window_us);
+extern int GPIOFreqStart(GPIO_Freq *freq, int priority);
+extern void GPIOFreqFeed(GPIO_Freq *freq, const GPIO_Event *events, int num);
+extern void GPIOFreqIdle(GPIO_Freq *freq, uint64_t now_ns);
+extern int GPIOFreqRead(GPIO_Freq *freq, int bank, int gpio, GPIO_FreqResult *result);
+extern int GPIOFreqStop(GPIO_Freq *freq);
+extern void GPIOFreqDestroy(GPIO_Freq *freq);
+
+
+#endif /*__GPIO_FREQ_H */
@@ -0,0 +1,392 @@
+/**
+  ******************************************************************************
+  * @file    gpio_mmap.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides the memory mapped GPIO register backend:
+  *           - Register layout table for the supported SoCs
+  *           - Bank mapping through /dev/mem, UIO or a regular file
+  *           - Bank read/write with set/clear registers or locked RMW
+  *           - Direction control through the bank direction register
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the GPIO Register Backend
+  *          ===================================================================
+  *
+  *          Register Access
+  *          =====================
+  *          - Every GPIO bank of the SoC is a block of memory mapped
+  *            registers: input level, output latch, direction and on most
+  *            parts write-1-to-set / write-1-to-clear registers
+  *          - The block is mapped into the process once; a read or a write
+  *            is then a single load or store, no syscall
+  *          - Banks with set/clear registers change outputs without
+  *            touching other pins; banks without them (i.MX6UL, RZ/G2L)
+  *            use a read-modify-write of the output latch under a per-bank
+  *            spin lock
+  *
+  *          Register Layouts
+  *          =======================
+  *            SoC        Banks  Width  DATAIN DATAOUT  SET    CLEAR  DIR
+  *            AM335x     4      32     0x138  0x13C    0x194  0x190  OE  0x134 (0=out)
+  *            i.MX6UL    5      32     0x008  0x000    -      -      GDIR 0x004 (1=out)
+  *            i.MX93     4      32     0x050  0x040    0x044  0x048  PDDR 0x054 (1=out)
+  *            RZ/G2L     49     8      PIN    P        -      -      (pinctrl, not mapped)
+  *
+  *          On RZ/G2L a bank is an 8 pin port and Linux numbers the pins
+  *          port * 8 + bit; direction stays with the pinctrl driver and
+  *          GPIOInit() sets it through sysfs under that number (see
+  *          GPIOPinNumber()). All 49 ports fit the default GPIO_MAX_BANKS.
+  *
+  *          Caution
+  *          =======================
+  *          - The kernel GPIO driver still owns the controller. Configure
+  *            pins (pinmux, direction) through the kernel first and use
+  *            this backend for the data path only
+  *          - /dev/mem needs root and CONFIG_STRICT_DEVMEM allowing the
+  *            GPIO region; a UIO device is the cleaner alternative
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_mmap.h" in your application
+  *            - Map a bank with GPIOMmapOpen(bank, &GPIO_LayoutAM335x)
+  *            - Route the bank through the registers with
+  *              GPIOSetBackend(bank, GPIO_BACKEND_MMAP)
+  *            - GPIOInit/GPIORead/GPIOWrite and the bank functions then
+  *              access the registers directly
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c gpio_thread.c
+  *                            your_app.c -pthread
+  *
+  *          Example Usage:
+  *            GPIOMmapOpen(2, GPIOMmapLayout("am335x"));
+  *            GPIOSetBackend(2, GPIO_BACKEND_MMAP);
+  *            GPIOInit(2, 22, OUT);
+  *            while (1) {
+  *                GPIOWrite(2, 22, HIGH);
+  *                GPIOWrite(2, 22, LOW);
+  *            }
+  *
+  *          Testing without hardware:
+  *            // a regular file stands in for the register block, registers
+  *            // start at offset + (bank base % page size) inside the file
+  *            GPIOMmapOpenFile(2, &GPIO_LayoutAM335x, "/tmp/gpio2.bin", 0);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include "gpio_mmap.h"
+
+const GPIO_MmapLayout GPIO_LayoutAM335x = {
+	.name = "am335x",
+	.num_banks = 4,
+	.base = { 0x44E07000, 0x4804C000, 0x481AC000, 0x481AE000 },
+	.size = 0x1000,
+	.width = 32,
+	.datain = 0x138,
+	.dataout = 0x13C,
+	.set = 0x194,
+	.clear = 0x190,
+	.dir = 0x134,
+	.dir_out = 0,
+};
+
+const GPIO_MmapLayout GPIO_LayoutIMX6UL = {
+	.name = "imx6ul",
+	.num_banks = 5,
+	.base = { 0x0209C000, 0x020A0000, 0x020A4000, 0x020A8000, 0x020AC000 },
+	.size = 0x1000,
+	.width = 32,
+	.datain = 0x08,
+	.dataout = 0x00,
+	.set = GPIO_REG_NONE,
+	.clear = GPIO_REG_NONE,
+	.dir = 0x04,
+	.dir_out = 1,
+};
+
+const GPIO_MmapLayout GPIO_LayoutIMX93 = {
+	.name = "imx93",
+	.num_banks = 4,
+	.base = { 0x47400000, 0x43810000, 0x43820000, 0x43830000 },
+	.size = 0x1000,
+	.width = 32,
+	.datain = 0x50,
+	.dataout = 0x40,
+	.set = 0x44,
+	.clear = 0x48,
+	.dir = 0x54,
+	.dir_out = 1,
+};
+
+const GPIO_MmapLayout GPIO_LayoutRZG2L = {
+	.name = "rzg2l",
+	.num_banks = 49,
+	.pins_per_bank = 8,
+	.base = { 0x11030010 },
+	.stride = 1,
+	.size = 0x900,
+	.width = 8,
+	.datain = 0x800,
+	.dataout = 0x000,
+	.set = GPIO_REG_NONE,
+	.clear = GPIO_REG_NONE,
+	.dir = GPIO_REG_NONE,
+	.dir_out = 1,
+};
+
+static const GPIO_MmapLayout *s_layouts[] = {
+	&GPIO_LayoutAM335x,
+	&GPIO_LayoutIMX6UL,
+	&GPIO_LayoutIMX93,
+	&GPIO_LayoutRZG2L,
+};
+
+static GPIO_MmapBank s_banks[GPIO_MAX_BANKS];
+
+const GPIO_MmapLayout *
+GPIOMmapLayout(const char *name)
+{
+	unsigned int i;
+
+	for (i = 0; i < sizeof(s_layouts) / sizeof(s_layouts[0]); i++) {
+		if (0 == strcasecmp(name, s_layouts[i]->name))
+			return(s_layouts[i]);
+	}
+
+	return(NULL);
+}
+
+static uint32_t
+GPIOMmapBase(const GPIO_MmapLayout *layout, int bank)
+{
+	if (layout->stride)
+		return(layout->base[0] + bank * layout->stride);
+
+	return(layout->base[bank]);
+}
+
+static int
+GPIOMmapMap(int bank, const GPIO_MmapLayout *layout, int fd, off_t offset)
+{
+	GPIO_MmapBank *b;
+	long page;
+	uint32_t in_page;
+
+	page = sysconf(_SC_PAGESIZE);
+	in_page = GPIOMmapBase(layout, bank) & (page - 1);
+
+	b = &s_banks[bank];
+	b->map_len = in_page + layout->size;
+	b->map = mmap(NULL, b->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+	if (MAP_FAILED == b->map) {
+		fprintf(stderr, "Failed to map gpio bank %d!\n", bank);
+		b->map = NULL;
+		close(fd);
+		return(-1);
+	}
+
+	b->layout = layout;
+	b->fd = fd;
+	b->regs = (volatile uint8_t *)b->map + in_page;
+	b->lock = 0;
+	return(0);
+}
+
+/**
+  * @brief  Maps the registers of a bank through /dev/mem.
+  * @param  bank: GPIO bank
+  * @param  layout: register layout of the SoC
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOMmapOpen(int bank, const GPIO_MmapLayout *layout)
+{
+	long page;
+	int fd;
+
+	if (bank < 0 || bank >= GPIO_MAX_BANKS || NULL == layout || bank >= layout->num_banks)
+		return(-1);
+
+	GPIOMmapClose(bank);
+
+	fd = open("/dev/mem", O_RDWR | O_SYNC | O_CLOEXEC);
+	if (-1 == fd) {
+		fprintf(stderr, "Failed to open /dev/mem!\n");
+		return(-1);
+	}
+
+	page = sysconf(_SC_PAGESIZE);
+	return(GPIOMmapMap(bank, layout, fd, GPIOMmapBase(layout, bank) & ~(page - 1)));
+}
+
+/**
+  * @brief  Maps the registers of a bank from a UIO device or a regular file.
+  * @param  bank: GPIO bank
+  * @param  layout: register layout of the SoC
+  * @param  path: /dev/uioN or a file standing in for the register block
+  * @param  offset: page aligned mmap offset (UIO map index * page size)
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOMmapOpenFile(int bank, const GPIO_MmapLayout *layout, const char *path, off_t offset)
+{
+	int fd;
+
+	if (bank < 0 || bank >= GPIO_MAX_BANKS || NULL == layout || NULL == path)
+		return(-1);
+
+	GPIOMmapClose(bank);
+
+	fd = open(path, O_RDWR | O_CLOEXEC);
+	if (-1 == fd) {
+		fprintf(stderr, "Failed to open %s!\n", path);
+		return(-1);
+	}
+
+	return(GPIOMmapMap(bank, layout, fd, offset));
+}
+
+void
+GPIOMmapClose(int bank)
+{
+	GPIO_MmapBank *b;
+
+	if (bank < 0 || bank >= GPIO_MAX_BANKS)
+		return;
+
+	b = &s_banks[bank];
+	if (NULL == b->map)
+		return;
+
+	munmap(b->map, b->map_len);
+	close(b->fd);
+	memset(b, 0, sizeof(*b));
+}
+
+GPIO_MmapBank *
+GPIOMmapGet(int bank)
+{
+	if (bank < 0 || bank >= GPIO_MAX_BANKS || NULL == s_banks[bank].map)
+		return(NULL);
+
+	return(&s_banks[bank]);
+}
+
+static inline uint32_t
+GPIOMmapReg(GPIO_MmapBank *b, int reg)
+{
+	if (8 == b->layout->width)
+		return(*(volatile uint8_t *)(b->regs + reg));
+
+	return(*(volatile uint32_t *)(b->regs + reg));
+}
+
+static inline void
+GPIOMmapSetReg(GPIO_MmapBank *b, int reg, uint32_t value)
+{
+	if (8 == b->layout->width)
+		*(volatile uint8_t *)(b->regs + reg) = (uint8_t)value;
+	else
+		*(volatile uint32_t *)(b->regs + reg) = value;
+}
+
+static inline void
+GPIOMmapLock(GPIO_MmapBank *b)
+{
+	while (__atomic_exchange_n(&b->lock, 1, __ATOMIC_ACQUIRE))
+		;
+}
+
+static inline void
+GPIOMmapUnlock(GPIO_MmapBank *b)
+{
+	__atomic_store_n(&b->lock, 0, __ATOMIC_RELEASE);
+}
+
+int
+GPIOMmapRead(int bank, uint32_t mask, uint32_t *values)
+{
+	GPIO_MmapBank *b;
+
+	b = GPIOMmapGet(bank);
+	if (NULL == b || NULL == values)
+		return(-1);
+
+	*values = GPIOMmapReg(b, b->layout->datain) & mask;
+	return(0);
+}
+
+/**
+  * @brief  Drives the mask pins of a mapped bank.
+  * @retval 0 on success, -1 if the bank is not mapped
+  */
+int
+GPIOMmapWrite(int bank, uint32_t mask, uint32_t values)
+{
+	GPIO_MmapBank *b;
+	uint32_t out;
+
+	b = GPIOMmapGet(bank);
+	if (NULL == b)
+		return(-1);
+
+	if (GPIO_REG_NONE != b->layout->set && GPIO_REG_NONE != b->layout->clear) {
+		if (values & mask)
+			GPIOMmapSetReg(b, b->layout->set, values & mask);
+		if (~values & mask)
+			GPIOMmapSetReg(b, b->layout->clear, ~values & mask);
+		return(0);
+	}
+
+	GPIOMmapLock(b);
+	out = GPIOMmapReg(b, b->layout->dataout);
+	GPIOMmapSetReg(b, b->layout->dataout, (out & ~mask) | (values & mask));
+	GPIOMmapUnlock(b);
+	return(0);
+}
+
+int
+GPIOMmapDirection(int bank, uint32_t mask, int dir)
+{
+	GPIO_MmapBank *b;
+	uint32_t reg;
+	int out_bits;
+
+	b = GPIOMmapGet(bank);
+	if (NULL == b)
+		return(-1);
+
+	if (GPIO_REG_NONE == b->layout->dir) {
+		fprintf(stderr, "Direction of bank %d is not memory mapped!\n", bank);
+		return(-1);
+	}
+
+	/* the register bit is dir_out for outputs, the inverse for inputs */
+	out_bits = (OUT == dir) ? b->layout->dir_out : !b->layout->dir_out;
+
+	GPIOMmapLock(b);
+	reg = GPIOMmapReg(b, b->layout->dir);
+	GPIOMmapSetReg(b, b->layout->dir, out_bits ? (reg | mask) : (reg & ~mask));
+	GPIOMmapUnlock(b);
+	return(0);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
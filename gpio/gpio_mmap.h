@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    gpio_mmap.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the memory
+  *          mapped GPIO register backend.
+  *
+  * @details Provides the following functionality:
+  *          - Per-SoC GPIO bank register layouts
+  *          - Mapping of banks through /dev/mem, UIO or a plain file
+  *          - Direct register read/write of a bank
+  ******************************************************************************
+  * @defgroup GPIO_Mmap GPIO Register Backend
+  * @brief Register layouts and mapped banks
+  * @{
+  */
+
+#ifndef __GPIO_MMAP_H
+#define __GPIO_MMAP_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include "sysfs_gpio.h"
+
+#define GPIO_MMAP_MAX_BANKS	8	/* explicit base addresses per layout */
+
+#define GPIO_REG_NONE		(-1)	/* register not present on this SoC */
+
+typedef struct {
+	const char *name;
+	int num_banks;
+	int pins_per_bank;	/* Linux numbers banks by this many pins, 0 = 32 */
+	uint32_t base[GPIO_MMAP_MAX_BANKS];	/* physical base of every bank */
+	uint32_t stride;	/* if set, bank n is at base[0] + n * stride */
+	uint32_t size;		/* bytes to map per bank */
+	int width;		/* register width in bits: 32 or 8 */
+	int datain;		/* input level register */
+	int dataout;		/* output latch register */
+	int set;		/* write-1-to-set register or GPIO_REG_NONE */
+	int clear;		/* write-1-to-clear register or GPIO_REG_NONE */
+	int dir;		/* direction register or GPIO_REG_NONE */
+	int dir_out;		/* level of a direction bit for an output: 0 or 1 */
+} GPIO_MmapLayout;
+
+typedef struct {
+	const GPIO_MmapLayout *layout;
+	int fd;			/* /dev/mem, /dev/uioN or backing file */
+	void *map;		/* page aligned mapping */
+	size_t map_len;
+	volatile uint8_t *regs;	/* bank register block inside the mapping */
+	int lock;		/* guards read-modify-write of dataout */
+} GPIO_MmapBank;
+
+extern const GPIO_MmapLayout GPIO_LayoutAM335x;
+extern const GPIO_MmapLayout GPIO_LayoutIMX6UL;
+extern const GPIO_MmapLayout GPIO_LayoutIMX93;
+extern const GPIO_MmapLayout GPIO_LayoutRZG2L;
+
+/** @} */
+
+extern const GPIO_MmapLayout *GPIOMmapLayout(const char *name);
+extern int GPIOMmapOpen(int bank, const GPIO_MmapLayout *layout);
+extern int GPIOMmapOpenFile(int bank, const GPIO_MmapLayout *layout, const char *path, off_t offset);
+extern void GPIOMmapClose(int bank);
+extern GPIO_MmapBank *GPIOMmapGet(int bank);
+
+extern int GPIOMmapRead(int bank, uint32_t mask, uint32_t *values);
+extern int GPIOMmapWrite(int bank, uint32_t mask, uint32_t values);
+extern int GPIOMmapDirection(int bank, uint32_t mask, int dir);
+
+
+#endif /*__GPIO_MMAP_H */
@@ -0,0 +1,177 @@
+/**
+  ******************************************************************************
+  * @file    gpio_thread.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides the worker thread shared by the GPIO
+  *          capture, frequency counter and waveform engine:
+  *           - Thread start with an optional SCHED_FIFO priority
+  *           - Stop flag and stop eventfd
+  *           - Monotonic nanosecond clock
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the GPIO Worker Thread
+  *          ===================================================================
+  *
+  *          Start
+  *          =====================
+  *          - A priority of 1-99 starts the thread SCHED_FIFO; without
+  *            CAP_SYS_NICE (or an RLIMIT_RTPRIO allowing it) the thread is
+  *            started again with the default policy and a warning
+  *
+  *          Stop
+  *          =======================
+  *          - GPIOThreadStop() clears the run flag, signals stop_fd and
+  *            joins the thread
+  *          - The thread checks GPIOThreadRunning() in its loop and keeps
+  *            stop_fd in the poll or epoll set it sleeps on, so a stop
+  *            never waits for the next event or deadline
+  *
+  *          Clock
+  *          =======================
+  *          - GPIONowNs() reads CLOCK_MONOTONIC, the clock of the kernel
+  *            GPIO event timestamps and of timerfd deadlines
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Embed a GPIO_Thread, GPIOThreadInit() it on creation
+  *            - Compile with the module using it: gcc ... gpio_thread.c -pthread
+  *
+  *          Example Usage:
+  *            static void *worker(void *arg)
+  *            {
+  *                GPIO_Thread *t = arg;
+  *                struct pollfd pfd = { t->stop_fd, POLLIN, 0 };
+  *                while (GPIOThreadRunning(t))
+  *                    poll(&pfd, 1, 100);
+  *                return NULL;
+  *            }
+  *
+  *            GPIOThreadInit(&t);
+  *            GPIOThreadStart(&t, worker, &t, 50, "example");
+  *            GPIOThreadStop(&t);
+  *            GPIOThreadDestroy(&t);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/eventfd.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "gpio_thread.h"
+
+int
+GPIOThreadInit(GPIO_Thread *t)
+{
+	if (NULL == t)
+		return(-1);
+
+	t->running = 0;
+	t->stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	return((-1 == t->stop_fd) ? -1 : 0);
+}
+
+/**
+  * @brief  Starts the thread.
+  * @param  t: thread, initialised with GPIOThreadInit()
+  * @param  fn, arg: thread function and its argument
+  * @param  priority: SCHED_FIFO priority (1-99), 0 keeps the default policy
+  * @param  name: used in the error message
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOThreadStart(GPIO_Thread *t, void *(*fn)(void *), void *arg, int priority,
+		const char *name)
+{
+	struct sched_param param;
+	pthread_attr_t attr;
+	int ret;
+
+	if (NULL == t || t->running)
+		return(-1);
+
+	pthread_attr_init(&attr);
+	if (priority > 0) {
+		memset(&param, 0, sizeof(param));
+		param.sched_priority = priority;
+		pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+		pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+		pthread_attr_setschedparam(&attr, &param);
+	}
+
+	__atomic_store_n(&t->running, 1, __ATOMIC_RELEASE);
+	ret = pthread_create(&t->thread, &attr, fn, arg);
+	if (0 != ret && priority > 0) {
+		fprintf(stderr, "SCHED_FIFO not permitted, using default policy!\n");
+		pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+		ret = pthread_create(&t->thread, &attr, fn, arg);
+	}
+	pthread_attr_destroy(&attr);
+
+	if (0 != ret) {
+		fprintf(stderr, "Failed to start gpio %s thread!\n", name);
+		t->running = 0;
+		return(-1);
+	}
+
+	return(0);
+}
+
+int
+GPIOThreadRunning(GPIO_Thread *t)
+{
+	return(__atomic_load_n(&t->running, __ATOMIC_ACQUIRE));
+}
+
+int
+GPIOThreadStop(GPIO_Thread *t)
+{
+	uint64_t one = 1;
+
+	if (NULL == t || !t->running)
+		return(-1);
+
+	__atomic_store_n(&t->running, 0, __ATOMIC_RELEASE);
+	write(t->stop_fd, &one, sizeof(one));
+	pthread_join(t->thread, NULL);
+	read(t->stop_fd, &one, sizeof(one));
+
+	return(0);
+}
+
+void
+GPIOThreadDestroy(GPIO_Thread *t)
+{
+	if (NULL == t)
+		return;
+
+	if (t->running)
+		GPIOThreadStop(t);
+
+	if (t->stop_fd > 0)
+		close(t->stop_fd);
+	t->stop_fd = -1;
+}
+
+uint64_t
+GPIONowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    gpio_thread.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the worker
+  *          threads of the GPIO subsystems.
+  *
+  * @details Provides the following functionality:
+  *          - SCHED_FIFO thread start with fallback to the default policy
+  *          - Stop request through an eventfd the thread can sleep on
+  *          - CLOCK_MONOTONIC time in nanoseconds
+  ******************************************************************************
+  * @defgroup GPIO_Thread GPIO Worker Thread
+  * @brief Thread, run flag and stop fd of a capture, counter or engine
+  * @{
+  */
+
+#ifndef __GPIO_THREAD_H
+#define __GPIO_THREAD_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+typedef struct {
+	pthread_t thread;
+	int running;		/* cleared by GPIOThreadStop() */
+	int stop_fd;		/* eventfd, readable once a stop was requested */
+} GPIO_Thread;
+
+/** @} */
+
+extern int GPIOThreadInit(GPIO_Thread *t);
+extern int GPIOThreadStart(GPIO_Thread *t, void *(*fn)(void *), void *arg, int priority,
+			   const char *name);
+extern int GPIOThreadRunning(GPIO_Thread *t);
+extern int GPIOThreadStop(GPIO_Thread *t);
+extern void GPIOThreadDestroy(GPIO_Thread *t);
+extern uint64_t GPIONowNs(void);
+
+
+#endif /*__GPIO_THREAD_H */
@@ -0,0 +1,464 @@
+/**
+  ******************************************************************************
+  * @file    gpio_wave.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides the timer driven GPIO waveform engine:
+  *           - Software PWM on any output pin
+  *           - Arbitrary bit patterns at a fixed bit time
+  *           - Phase-aligned multi-pin output from a common timeline
+  *           - Jitter statistics of the achieved deadlines
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Waveform Engine
+  *          ===================================================================
+  *
+  *          Timeline
+  *          =====================
+  *          - All channels share one start time; every edge is computed
+  *            as start + phase + n * period (or n * bit time), never by
+  *            adding up sleeps, so the output does not drift
+  *          - The engine thread arms a timerfd with TFD_TIMER_ABSTIME for
+  *            the earliest pending edge and sleeps in poll() until then
+  *          - The thread can run SCHED_FIFO to keep wake-up latency low
+  *
+  *          Output
+  *          =======================
+  *          - All edges due at a wake-up are grouped per bank and written
+  *            with one GPIOWriteBank() call, so pins of one bank switch
+  *            together (one SET_VALUES or register store) and stay phase
+  *            aligned
+  *          - Pins keep their cached handles, no file is opened while the
+  *            engine runs
+  *
+  *          PWM
+  *          =======================
+  *          - A period starts with a rising edge and ends high_ns later
+  *            with a falling edge; 0 and >= period give a constant level
+  *          - GPIOWaveSetDuty() may be called at any time, the new high
+  *            time applies from the next period on (no runt pulses)
+  *          - If the thread was late by more than a whole period, the
+  *            missed periods are skipped and counted as overruns
+  *
+  *          Bit Patterns
+  *          =======================
+  *          - Bit i of the pattern is output at start + phase + i * bit_ns
+  *          - One-shot patterns hold the last bit, repeated ones wrap
+  *          - Late bits are output immediately, never dropped
+  *
+  *          Statistics
+  *          =======================
+  *          - Every wake-up is compared with its deadline; minimum,
+  *            maximum and average lateness show which edge rate a board
+  *            sustains. Keep periods well above late_max_ns
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "gpio_wave.h" in your application
+  *            - Initialise the pins as outputs with GPIOInit(bank, pin, OUT)
+  *            - Add PWM or pattern channels, then start the engine
+  *            - Change the duty cycle on the fly with GPIOWaveSetDuty()
+  *            - Check GPIOWaveGetStats() for the achieved jitter
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c
+  *                            gpio_thread.c gpio_wave.c your_app.c -pthread
+  *
+  *          Example Usage:
+  *            GPIO_Wave *wave = GPIOWaveCreate();
+  *            static const uint8_t sync[] = { 0xA5, 0x0F };
+  *            GPIO_WaveStats st;
+  *            int pwm;
+  *
+  *            GPIOInit(2, 22, OUT);
+  *            GPIOInit(2, 23, OUT);
+  *            GPIOInit(2, 24, OUT);
+  *            pwm = GPIOWaveAddPWM(wave, 2, 22, 1000000, 250000, 0);  // 1 kHz, 25 %
+  *            GPIOWaveAddPWM(wave, 2, 23, 1000000, 250000, 500000);    // 180 deg shifted
+  *            GPIOWaveAddPattern(wave, 2, 24, sync, 16, 100000, 0, 1); // 10 kbit/s
+  *            GPIOWaveStart(wave, 80);                                 // SCHED_FIFO 80
+  *
+  *            GPIOWaveSetDuty(wave, pwm, 750000);                      // 75 %
+  *            sleep(10);
+  *            GPIOWaveGetStats(wave, &st);
+  *            printf("late max %llu ns\n", (unsigned long long)st.late_max_ns);
+  *            GPIOWaveDestroy(wave);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/timerfd.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "gpio_wave.h"
+
+static int
+GPIOWaveArm(GPIO_Wave *wave, uint64_t deadline)
+{
+	struct itimerspec its;
+
+	memset(&its, 0, sizeof(its));
+	its.it_value.tv_sec = deadline / 1000000000ULL;
+	its.it_value.tv_nsec = deadline % 1000000000ULL;
+
+	/* re-arming also clears a pending expiry, no read() is needed */
+	return(timerfd_settime(wave->timer_fd, TFD_TIMER_ABSTIME, &its, NULL));
+}
+
+static void
+GPIOWaveReset(GPIO_WaveChannel *ch, uint64_t t0)
+{
+	ch->start_ns = t0 + ch->phase_ns;
+	ch->next_ns = ch->start_ns;
+	ch->in_high = 0;
+	ch->step = 0;
+}
+
+/**
+  * @brief  Produces the level of the edge due at ch->next_ns and schedules the next.
+  * @param  ch: channel whose edge is due
+  * @param  now: wake-up time, later than ch->next_ns if the thread was late
+  * @retval Number of skipped PWM periods
+  */
+static uint64_t
+GPIOWaveAdvance(GPIO_WaveChannel *ch, uint64_t now)
+{
+	uint64_t skipped = 0;
+	uint64_t high;
+	int bit;
+
+	if (GPIO_WAVE_PATTERN == ch->type) {
+		bit = (int)(ch->step % ch->nbits);
+		ch->level = (ch->bits[bit / 8] >> (bit % 8)) & 1;
+		ch->step++;
+		if (!ch->repeat && ch->step >= (uint64_t)ch->nbits)
+			ch->next_ns = 0;
+		else
+			ch->next_ns = ch->start_ns + ch->step * ch->bit_ns;
+		return(0);
+	}
+
+	if (ch->in_high) {
+		ch->level = LOW;
+		ch->in_high = 0;
+		ch->start_ns += ch->period_ns;
+		ch->next_ns = ch->start_ns;
+		return(0);
+	}
+
+	/* start of a period, realign if whole periods were missed */
+	if (now - ch->start_ns >= ch->period_ns) {
+		skipped = (now - ch->start_ns) / ch->period_ns;
+		ch->start_ns += skipped * ch->period_ns;
+	}
+
+	high = __atomic_load_n(&ch->high_ns, __ATOMIC_RELAXED);
+	ch->level = (0 == high) ? LOW : HIGH;
+	if (0 == high || high >= ch->period_ns) {
+		ch->start_ns += ch->period_ns;
+		ch->next_ns = ch->start_ns;
+	} else {
+		ch->in_high = 1;
+		ch->next_ns = ch->start_ns + high;
+	}
+
+	return(skipped);
+}
+
+/* outputs every edge due by now, one bank write per touched bank */
+static void
+GPIOWaveStep(GPIO_Wave *wave, uint64_t now)
+{
+	uint32_t mask[GPIO_MAX_BANKS];
+	uint32_t values[GPIO_MAX_BANKS];
+	GPIO_WaveChannel *ch;
+	uint64_t overruns = 0;
+	int i;
+
+	memset(mask, 0, sizeof(mask));
+	memset(values, 0, sizeof(values));
+
+	for (i = 0; i < wave->num_channels; i++) {
+		ch = &wave->channels[i];
+		if (0 == ch->next_ns || ch->next_ns > now)
+			continue;
+
+		overruns += GPIOWaveAdvance(ch, now);
+		mask[ch->bank] |= 1U << ch->gpio;
+		if (HIGH == ch->level)
+			values[ch->bank] |= 1U << ch->gpio;
+	}
+
+	for (i = 0; i < GPIO_MAX_BANKS; i++) {
+		if (mask[i] && GPIOWriteBank(i, mask[i], values[i]))
+			__atomic_store_n(&wave->write_errors, wave->write_errors + 1, __ATOMIC_RELAXED);
+	}
+
+	if (overruns)
+		__atomic_store_n(&wave->overruns, wave->overruns + overruns, __ATOMIC_RELAXED);
+}
+
+static void
+GPIOWaveAccount(GPIO_Wave *wave, uint64_t deadline, uint64_t now)
+{
+	uint64_t late;
+
+	late = (now > deadline) ? now - deadline : 0;
+	if (late < wave->late_min)
+		__atomic_store_n(&wave->late_min, late, __ATOMIC_RELAXED);
+	if (late > wave->late_max)
+		__atomic_store_n(&wave->late_max, late, __ATOMIC_RELAXED);
+	__atomic_store_n(&wave->late_sum, wave->late_sum + late, __ATOMIC_RELAXED);
+	__atomic_store_n(&wave->deadlines, wave->deadlines + 1, __ATOMIC_RELEASE);
+}
+
+static void *
+GPIOWaveThread(void *arg)
+{
+	GPIO_Wave *wave = arg;
+	struct pollfd pfd[2];
+	uint64_t deadline;
+	uint64_t now;
+	int i;
+
+	now = GPIONowNs();
+	for (i = 0; i < wave->num_channels; i++)
+		GPIOWaveReset(&wave->channels[i], now + GPIO_WAVE_LEAD_NS);
+
+	pfd[0].fd = wave->timer_fd;
+	pfd[0].events = POLLIN;
+	pfd[1].fd = wave->thread.stop_fd;
+	pfd[1].events = POLLIN;
+
+	while (GPIOThreadRunning(&wave->thread)) {
+		deadline = 0;
+		for (i = 0; i < wave->num_channels; i++) {
+			if (0 != wave->channels[i].next_ns &&
+			    (0 == deadline || wave->channels[i].next_ns < deadline))
+				deadline = wave->channels[i].next_ns;
+		}
+
+		/* all one-shot patterns done: sleep until stopped */
+		if (0 == deadline) {
+			poll(&pfd[1], 1, -1);
+			continue;
+		}
+
+		if (GPIOWaveArm(wave, deadline)) {
+			fprintf(stderr, "Failed to arm waveform timer!\n");
+			break;
+		}
+		if (poll(pfd, 2, -1) < 1 || (pfd[1].revents & POLLIN))
+			continue;
+
+		now = GPIONowNs();
+		GPIOWaveAccount(wave, deadline, now);
+		GPIOWaveStep(wave, now);
+	}
+
+	return(NULL);
+}
+
+GPIO_Wave *
+GPIOWaveCreate(void)
+{
+	GPIO_Wave *wave;
+
+	wave = calloc(1, sizeof(*wave));
+	if (NULL == wave)
+		return(NULL);
+
+	wave->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+	wave->thread.stop_fd = -1;
+	if (-1 == wave->timer_fd || -1 == GPIOThreadInit(&wave->thread)) {
+		fprintf(stderr, "Failed to allocate gpio waveform engine!\n");
+		GPIOWaveDestroy(wave);
+		return(NULL);
+	}
+	wave->late_min = UINT64_MAX;
+
+	return(wave);
+}
+
+static GPIO_WaveChannel *
+GPIOWaveNew(GPIO_Wave *wave, int bank, int gpio, int type, uint64_t phase_ns)
+{
+	GPIO_WaveChannel *ch;
+	int i;
+
+	if (NULL == wave || wave->thread.running || wave->num_channels >= GPIO_WAVE_CHANNELS_MAX)
+		return(NULL);
+
+	if (bank < 0 || bank >= GPIO_MAX_BANKS || gpio < 0 || gpio >= GPIO_PINS_PER_BANK)
+		return(NULL);
+
+	for (i = 0; i < wave->num_channels; i++) {
+		if (wave->channels[i].bank == bank && wave->channels[i].gpio == gpio)
+			return(NULL);
+	}
+
+	/* open the handle now, the engine never opens files */
+	if (NULL == GPIOOpen(bank, gpio))
+		return(NULL);
+
+	ch = &wave->channels[wave->num_channels];
+	memset(ch, 0, sizeof(*ch));
+	ch->bank = bank;
+	ch->gpio = gpio;
+	ch->type = type;
+	ch->phase_ns = phase_ns;
+
+	return(ch);
+}
+
+/**
+  * @brief  Adds a software PWM output.
+  * @param  wave: waveform engine
+  * @param  bank, gpio: output pin, already initialised with GPIOInit()
+  * @param  period_ns: PWM period
+  * @param  high_ns: high time per period, 0 = always LOW, >= period = always HIGH
+  * @param  phase_ns: delay of the first period from the common start
+  * @retval Channel number on success, -1 on error
+  */
+int
+GPIOWaveAddPWM(GPIO_Wave *wave, int bank, int gpio, uint64_t period_ns,
+	       uint64_t high_ns, uint64_t phase_ns)
+{
+	GPIO_WaveChannel *ch;
+
+	if (0 == period_ns)
+		return(-1);
+
+	ch = GPIOWaveNew(wave, bank, gpio, GPIO_WAVE_PWM, phase_ns);
+	if (NULL == ch)
+		return(-1);
+
+	ch->period_ns = period_ns;
+	ch->high_ns = high_ns;
+
+	return(wave->num_channels++);
+}
+
+/**
+  * @brief  Adds a bit pattern output.
+  * @param  wave: waveform engine
+  * @param  bank, gpio: output pin, already initialised with GPIOInit()
+  * @param  bits: pattern, bit i is bits[i / 8] >> (i % 8)
+  * @param  nbits: pattern length (max GPIO_WAVE_BITS_MAX)
+  * @param  bit_ns: duration of one bit
+  * @param  phase_ns: delay of the first bit from the common start
+  * @param  repeat: 1 loops the pattern, 0 outputs it once and holds the last bit
+  * @retval Channel number on success, -1 on error
+  */
+int
+GPIOWaveAddPattern(GPIO_Wave *wave, int bank, int gpio, const uint8_t *bits,
+		   int nbits, uint64_t bit_ns, uint64_t phase_ns, int repeat)
+{
+	GPIO_WaveChannel *ch;
+
+	if (NULL == bits || nbits < 1 || nbits > GPIO_WAVE_BITS_MAX || 0 == bit_ns)
+		return(-1);
+
+	ch = GPIOWaveNew(wave, bank, gpio, GPIO_WAVE_PATTERN, phase_ns);
+	if (NULL == ch)
+		return(-1);
+
+	memcpy(ch->bits, bits, (nbits + 7) / 8);
+	ch->nbits = nbits;
+	ch->bit_ns = bit_ns;
+	ch->repeat = repeat;
+
+	return(wave->num_channels++);
+}
+
+/**
+  * @brief  Changes the high time of a PWM channel, also while running.
+  * @param  wave: waveform engine
+  * @param  channel: channel returned by GPIOWaveAddPWM()
+  * @param  high_ns: new high time, applied from the next period
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOWaveSetDuty(GPIO_Wave *wave, int channel, uint64_t high_ns)
+{
+	if (NULL == wave || channel < 0 || channel >= wave->num_channels)
+		return(-1);
+
+	if (GPIO_WAVE_PWM != wave->channels[channel].type)
+		return(-1);
+
+	__atomic_store_n(&wave->channels[channel].high_ns, high_ns, __ATOMIC_RELAXED);
+	return(0);
+}
+
+/**
+  * @brief  Starts the engine thread, the first edges follow GPIO_WAVE_LEAD_NS later.
+  * @param  wave: waveform engine
+  * @param  priority: SCHED_FIFO priority (1-99), 0 keeps the default policy
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOWaveStart(GPIO_Wave *wave, int priority)
+{
+	if (NULL == wave || wave->thread.running || 0 == wave->num_channels)
+		return(-1);
+
+	return(GPIOThreadStart(&wave->thread, GPIOWaveThread, wave, priority, "waveform"));
+}
+
+void
+GPIOWaveGetStats(GPIO_Wave *wave, GPIO_WaveStats *stats)
+{
+	uint64_t late_min;
+
+	if (NULL == wave || NULL == stats)
+		return;
+
+	stats->deadlines = __atomic_load_n(&wave->deadlines, __ATOMIC_ACQUIRE);
+	late_min = __atomic_load_n(&wave->late_min, __ATOMIC_RELAXED);
+	stats->late_min_ns = (UINT64_MAX == late_min) ? 0 : late_min;
+	stats->late_max_ns = __atomic_load_n(&wave->late_max, __ATOMIC_RELAXED);
+	stats->late_avg_ns = stats->deadlines ?
+			     __atomic_load_n(&wave->late_sum, __ATOMIC_RELAXED) / stats->deadlines : 0;
+	stats->overruns = __atomic_load_n(&wave->overruns, __ATOMIC_RELAXED);
+	stats->write_errors = __atomic_load_n(&wave->write_errors, __ATOMIC_RELAXED);
+}
+
+/**
+  * @brief  Stops the engine, the outputs keep their current level.
+  * @retval 0 on success, -1 if the engine was not running
+  */
+int
+GPIOWaveStop(GPIO_Wave *wave)
+{
+	if (NULL == wave)
+		return(-1);
+
+	return(GPIOThreadStop(&wave->thread));
+}
+
+void
+GPIOWaveDestroy(GPIO_Wave *wave)
+{
+	if (NULL == wave)
+		return;
+
+	GPIOThreadDestroy(&wave->thread);
+	if (wave->timer_fd > 0)
+		close(wave->timer_fd);
+	free(wave);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    gpio_wave.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the timer
+  *          driven GPIO waveform engine (software PWM and bit patterns).
+  *
+  * @details Provides the following functionality:
+  *          - Software PWM with run-time duty cycle updates
+  *          - Arbitrary bit patterns, one-shot or repeated
+  *          - Phase-aligned output of many pins from one timeline
+  *          - Deadline jitter statistics
+  ******************************************************************************
+  * @defgroup GPIO_Wave GPIO Waveform Engine
+  * @brief Channel definitions and engine state
+  * @{
+  */
+
+#ifndef __GPIO_WAVE_H
+#define __GPIO_WAVE_H
+
+#include <stdint.h>
+#include "sysfs_gpio.h"
+#include "gpio_thread.h"
+
+#define GPIO_WAVE_CHANNELS_MAX	32	/* output pins per engine */
+#define GPIO_WAVE_BITS_MAX	1024	/* bits per pattern */
+#define GPIO_WAVE_LEAD_NS	1000000	/* delay from start to the first edge */
+
+#define GPIO_WAVE_PWM		0
+#define GPIO_WAVE_PATTERN	1
+
+typedef struct {
+	uint64_t deadlines;	/* timer expiries handled */
+	uint64_t late_min_ns;	/* wake-up lateness against the deadline */
+	uint64_t late_max_ns;
+	uint64_t late_avg_ns;
+	uint64_t overruns;	/* PWM periods skipped because the thread was late */
+	uint64_t write_errors;
+} GPIO_WaveStats;
+
+typedef struct {
+	int bank;
+	int gpio;
+	int type;		/* GPIO_WAVE_PWM or GPIO_WAVE_PATTERN */
+	uint64_t phase_ns;	/* offset of the first edge from the common start */
+	uint64_t start_ns;	/* current PWM period / first pattern bit */
+	uint64_t next_ns;	/* absolute time of the next edge, 0 = none */
+	int level;
+
+	/* PWM */
+	uint64_t period_ns;
+	uint64_t high_ns;	/* requested high time, applied at the next period */
+	int in_high;
+
+	/* bit pattern, bit i is bits[i / 8] >> (i % 8) */
+	uint8_t bits[GPIO_WAVE_BITS_MAX / 8];
+	int nbits;
+	int repeat;
+	uint64_t bit_ns;
+	uint64_t step;		/* bits output since start */
+} GPIO_WaveChannel;
+
+typedef struct {
+	GPIO_Thread thread;	/* engine thread, its stop fd is polled with timer_fd */
+	int timer_fd;		/* timerfd armed with absolute deadlines */
+	int num_channels;
+	GPIO_WaveChannel channels[GPIO_WAVE_CHANNELS_MAX];
+
+	/* statistics, written by the engine thread only */
+	uint64_t deadlines;
+	uint64_t late_min;
+	uint64_t late_max;
+	uint64_t late_sum;
+	uint64_t overruns;
+	uint64_t write_errors;
+} GPIO_Wave;
+
+/** @} */
+
+extern GPIO_Wave *GPIOWaveCreate(void);
+extern int GPIOWaveAddPWM(GPIO_Wave *wave, int bank, int gpio, uint64_t period_ns,
+			  uint64_t high_ns, uint64_t phase_ns);
+extern int GPIOWaveAddPattern(GPIO_Wave *wave, int bank, int gpio, const uint8_t *bits,
+			      int nbits, uint64_t bit_ns, uint64_t phase_ns, int repeat);
+extern int GPIOWaveSetDuty(GPIO_Wave *wave, int channel, uint64_t high_ns);
+extern int GPIOWaveStart(GPIO_Wave *wave, int priority);
+extern void GPIOWaveGetStats(GPIO_Wave *wave, GPIO_WaveStats *stats);
+extern int GPIOWaveStop(GPIO_Wave *wave);
+extern void GPIOWaveDestroy(GPIO_Wave *wave);
+
+
+#endif /*__GPIO_WAVE_H */
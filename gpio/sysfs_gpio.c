@@ -26,17 +26,71 @@
   *          =======================  
   *          - Uses Linux sysfs virtual file system interface
   *          - Control files located at /sys/class/gpio/
-  *          - Each operation involves file operations (open/read/write/close)
+  *          - Export/direction changes involve file operations (open/write/close)
   *          - Provides hardware abstraction through filesystem
+  *
+  *          Handle Cache
+  *          =======================  
+  *          - The gpioN/value file of every initialised pin is opened once
+  *            and kept in a table indexed by Linux pin number
+  *          - Reads and writes use pread()/pwrite() at offset 0 on the cached
+  *            fd, i.e. one syscall per access and no path formatting
+  *          - Pins exported outside this driver are opened lazily on first use
+  *          - GPIOClose()/GPIOCloseAll() release the cached fds
+  *
+  *          Output Shadow
+  *          =======================  
+  *          - The level last written to every output is kept per bank
+  *          - GPIOWrite()/GPIOWriteBank() skip the syscall for pins that
+  *            already hold the requested level
+  *          - Direction changes, GPIOInit() and closing a pin invalidate it
+  *          - GPIOWriteForce()/GPIOWriteBankForce() always write, e.g. when
+  *            another process may have driven the pin
+  *
+  *          Thread Safety
+  *          =======================  
+  *          - Reads and writes take no lock: the handle table is looked up
+  *            by index and an open handle is published with a single
+  *            release store of its fd
+  *          - The first open of a pin and the calls that (re)configure
+  *            pins (GPIOInit(), GPIOInitTable(), GPIODirection(), closing)
+  *            take one recursive mutex; concurrent first uses of a pin
+  *            open it exactly once, and direction changes on lines of one
+  *            request never lose each other's update
+  *          - The shadow of a bank is one 64-bit atomic word (valid bits
+  *            and levels), updated by compare-and-swap, so threads writing
+  *            different pins of the same bank never lose each other's bits
+  *          - Bank writes only touch the mask pins: SET_VALUES of a line
+  *            request and set/clear registers are atomic, RMW register
+  *            banks use the per-bank lock of gpio_mmap.c
+  *          - Any number of threads may drive different pins in parallel.
+  *            A single pin must be driven by one thread at a time, and
+  *            GPIOInit()/GPIOClose()/GPIOSetBackend() must not race with
+  *            I/O on the pins (or line request) they reconfigure
   *  
   *          ===================================================================      
   *                              How to use this driver
   *          ===================================================================          
   *            - Include "sysfs_gpio.h" in your application
-  *            - Initialize pins using GPIOInit(bank, pin, direction)
+  *            - Initialize pins using GPIOInit(bank, pin, direction), or a
+  *              whole pin table at once with GPIOInitTable(table, count)
   *            - Read inputs with GPIORead(bank, pin)
   *            - Control outputs with GPIOWrite(bank, pin, value)
-  *            - Compile with: gcc gpio.c your_app.c -o gpio_app
+  *            - For tight loops fetch the handle once with GPIOOpen(bank, pin)
+  *              and use GPIOHandleRead()/GPIOHandleWrite()
+  *            - Release cached fds with GPIOCloseAll() before exiting
+  *            - Select the /dev/gpiochipN backend for a bank with
+  *              GPIOSetBackend(bank, GPIO_BACKEND_CHARDEV), see gpio_chardev.c
+  *            - Scan or drive many pins of a bank at once with
+  *              GPIOReadBank(bank, mask, &values)/GPIOWriteBank(bank, mask, values)
+  *            - Drive banks through memory mapped registers with
+  *              GPIO_BACKEND_MMAP, see gpio_mmap.c
+  *            - Wait for input edges instead of polling, see gpio_event.c
+  *            - Measure frequency and pulse width of inputs, see gpio_freq.c
+  *            - Generate PWM and bit patterns on outputs, see gpio_wave.c
+  *            - Drive I2C and SPI buses from GPIO pins, see gpio_bitbang.c
+  *            - Compile with: gcc sysfs_gpio.c gpio_chardev.c gpio_mmap.c gpio_thread.c your_app.c
+  *                            -o gpio_app -pthread
   *            - Run with root privileges: sudo ./gpio_app
   *            - Ensure proper permissions on /sys/class/gpio/
   * 
@@ -49,6 +103,11 @@
   *            int val = GPIORead(2, 24);
   *            GPIOWrite(2, 22, val);
   *
+  *            // Toggle through the cached handle
+  *            GPIO_Handle *out = GPIOOpen(2, 22);
+  *            GPIOHandleWrite(out, HIGH);
+  *            GPIOHandleWrite(out, LOW);
+  *
   *  @endverbatim
   *    
   ******************************************************************************
@@ -59,21 +118,491 @@
 
 
 
+#include <sys/inotify.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include "sysfs_gpio.h" 
+#include "gpio_chardev.h"
+#include "gpio_mmap.h"
+#include "gpio_thread.h"
+
+#define VALUE_MAX 32
+#define BUFFER_MAX 12
+
+#define GPIO_READY_RECHECK_MS	20
+
+static GPIO_Handle s_handles[GPIO_MAX_PINS];
+static pthread_once_t s_handles_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t s_handles_lock;
+static int s_backend[GPIO_MAX_BANKS];
+
+/*
+ * last level written to each output, one atomic word per bank:
+ * bits 63..32 mark pins with a known level, bits 31..0 hold the levels
+ */
+static uint64_t s_shadow[GPIO_MAX_BANKS];
+
+#define SHADOW_VALID(mask)	((uint64_t)(mask) << 32)
+
+static void
+GPIOHandlesInit(void)
+{
+	pthread_mutexattr_t attr;
+	int i;
+
+	for (i = 0; i < GPIO_MAX_PINS; i++) {
+		s_handles[i].pin = i;
+		s_handles[i].fd  = -1;
+		s_handles[i].dir = -1;
+		s_handles[i].backend = GPIO_BACKEND_SYSFS;
+		s_handles[i].line  = 0;
+		s_handles[i].lines = NULL;
+	}
+
+	/* line requests rebind other pins from inside a locked call */
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&s_handles_lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+static void
+GPIOHandlesSetup(void)
+{
+	pthread_once(&s_handles_once, GPIOHandlesInit);
+}
+
+static void
+GPIOHandlesLock(void)
+{
+	GPIOHandlesSetup();
+	pthread_mutex_lock(&s_handles_lock);
+}
+
+static void
+GPIOHandlesUnlock(void)
+{
+	pthread_mutex_unlock(&s_handles_lock);
+}
+
+/* publishes a handle, the other fields must be set before */
+static void
+GPIOHandlePublish(GPIO_Handle *h, int fd)
+{
+	__atomic_store_n(&h->fd, fd, __ATOMIC_RELEASE);
+}
+
+static GPIO_Handle *
+GPIOHandleOpen(int pin)
+{
+	char path[VALUE_MAX];
+	GPIO_Handle *h;
+	int fd;
+
+	h = &s_handles[pin];
+	if (-1 != h->fd)
+		return(h);	/* opened by another thread meanwhile */
+
+	if (GPIO_BACKEND_CHARDEV == GPIOGetBackend(pin / 32)) {
+		/* request the line as-is, GPIOInit() was not called for it */
+		if (GPIOChardevInit(pin / 32, pin % 32, -1))
+			return(NULL);
+		return(h);
+	}
+
+	if (GPIO_BACKEND_MMAP == GPIOGetBackend(pin / 32)) {
+		if (NULL == GPIOMmapGet(pin / 32)) {
+			fprintf(stderr, "GPIO bank %d is not mapped!\n", pin / 32);
+			return(NULL);
+		}
+		/* the fd belongs to the bank mapping, it only marks the handle open */
+		h->backend = GPIO_BACKEND_MMAP;
+		GPIOHandlePublish(h, GPIOMmapGet(pin / 32)->fd);
+		return(h);
+	}
+
+	snprintf(path, VALUE_MAX, "/sys/class/gpio/gpio%d/value", GPIOPinNumber(pin / 32, pin % 32));
+	fd = open(path, O_RDWR | O_CLOEXEC);
+	if (-1 == fd && EACCES == errno)
+		fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (-1 == fd) {
+		fprintf(stderr, "Failed to open gpio value!\n");
+		return(NULL);
+	}
+	h->backend = GPIO_BACKEND_SYSFS;
+	GPIOHandlePublish(h, fd);
+
+	return(h);
+}
+
+/**
+  * @brief  Opens gpioN/value (or a line request) of a pin once and caches the fd.
+  * @note   An open handle is found with one acquire load and no lock. Only
+  *         the first use of a pin takes the handle table mutex.
+  * @param  pin: handle index, bank * 32 + gpio
+  * @retval Pointer to the cached handle, NULL on error
+  */
+static GPIO_Handle *
+GPIOHandleGet(int pin)
+{
+	GPIO_Handle *h;
+
+	if (pin < 0 || pin >= GPIO_MAX_PINS) {
+		fprintf(stderr, "GPIO %d outside handle cache!\n", pin);
+		return(NULL);
+	}
+
+	GPIOHandlesSetup();
+	h = &s_handles[pin];
+	if (-1 != __atomic_load_n(&h->fd, __ATOMIC_ACQUIRE))
+		return(h);
+
+	pthread_mutex_lock(&s_handles_lock);
+	h = GPIOHandleOpen(pin);
+	pthread_mutex_unlock(&s_handles_lock);
+
+	return(h);
+}
+
+static void
+GPIOHandleRelease(int pin)
+{
+	GPIO_Handle *h;
+	int fd;
+
+	if (pin < 0 || pin >= GPIO_MAX_PINS)
+		return;
+
+	GPIOHandlesLock();
+	h = &s_handles[pin];
+	GPIOShadowInvalidate(pin / 32, 1U << (pin % 32));
+	if (NULL != h->lines) {
+		if (h->lines->owned)
+			GPIOLinesRelease(h->lines);
+		else
+			GPIOHandleUnbind(pin, h->lines);
+		GPIOHandlesUnlock();
+		return;
+	}
+
+	fd = h->fd;
+	GPIOHandlePublish(h, -1);
+	if (-1 != fd && GPIO_BACKEND_SYSFS == h->backend)
+		close(fd);
+	h->backend = GPIO_BACKEND_SYSFS;
+	h->dir = -1;
+	GPIOHandlesUnlock();
+}
+
+/**
+  * @brief  Points a pin handle at a chardev line request.
+  * @param  pin: handle index, bank * 32 + gpio
+  * @param  lines: line request holding the pin
+  * @param  line: bit index of the pin inside the request
+  * @retval 0 on success, -1 if the pin is outside the handle cache
+  */
+int
+GPIOHandleBind(int pin, struct GPIO_Lines *lines, int line)
+{
+	GPIO_Handle *h;
+	GPIO_Lines *old;
+
+	if (pin < 0 || pin >= GPIO_MAX_PINS)
+		return(-1);
+
+	GPIOHandlesLock();
+	GPIOShadowInvalidate(pin / 32, 1U << (pin % 32));
+	h = &s_handles[pin];
+	old = h->lines;
+	if (NULL == old && -1 != h->fd && GPIO_BACKEND_SYSFS == h->backend)
+		close(h->fd);
+
+	h->dir = lines->dir;
+	h->backend = GPIO_BACKEND_CHARDEV;
+	h->line = line;
+	h->lines = lines;
+	GPIOHandlePublish(h, lines->fd);
+
+	/* a request made by the library is dropped once one of its pins moves */
+	if (NULL != old && old != lines && old->owned)
+		GPIOLinesRelease(old);
+
+	GPIOHandlesUnlock();
+	return(0);
+}
+
+/**
+  * @brief  Line request a pin handle is bound to.
+  * @retval Line request, NULL if the pin is not held by one
+  */
+struct GPIO_Lines *
+GPIOHandleLines(int pin)
+{
+	GPIO_Lines *lines;
+
+	if (pin < 0 || pin >= GPIO_MAX_PINS)
+		return(NULL);
+
+	GPIOHandlesLock();
+	lines = s_handles[pin].lines;
+	GPIOHandlesUnlock();
+	return(lines);
+}
+
+void
+GPIOHandleUnbind(int pin, struct GPIO_Lines *lines)
+{
+	GPIO_Handle *h;
+
+	if (pin < 0 || pin >= GPIO_MAX_PINS)
+		return;
+
+	GPIOHandlesLock();
+	h = &s_handles[pin];
+	if (h->lines == lines) {
+		GPIOShadowInvalidate(pin / 32, 1U << (pin % 32));
+		GPIOHandlePublish(h, -1);
+		h->dir = -1;
+		h->line  = 0;
+		h->lines = NULL;
+	}
+	GPIOHandlesUnlock();
+}
+
+/**
+  * @brief  Forgets the last written level of pins, the next write goes out.
+  * @param  bank: GPIO bank
+  * @param  mask: pins to invalidate, bit n = GPIOx_n
+  */
+void
+GPIOShadowInvalidate(int bank, uint32_t mask)
+{
+	if (bank < 0 || bank >= GPIO_MAX_BANKS)
+		return;
+
+	__atomic_fetch_and(&s_shadow[bank], ~SHADOW_VALID(mask), __ATOMIC_RELAXED);
+}
+
+static void
+GPIOShadowUpdate(int bank, uint32_t mask, uint32_t values, int ok)
+{
+	uint64_t old;
+	uint64_t new;
+
+	if (!ok) {
+		GPIOShadowInvalidate(bank, mask);
+		return;
+	}
+
+	/* other threads may update other pins of the bank concurrently */
+	old = __atomic_load_n(&s_shadow[bank], __ATOMIC_RELAXED);
+	do {
+		new = (old & ~(SHADOW_VALID(mask) | mask)) | SHADOW_VALID(mask) | (values & mask);
+	} while (!__atomic_compare_exchange_n(&s_shadow[bank], &old, new, 1,
+					      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/* pins of mask whose requested level differs from the shadow or is unknown */
+static uint32_t
+GPIOShadowPending(int bank, uint32_t mask, uint32_t values)
+{
+	uint64_t shadow;
+
+	shadow = __atomic_load_n(&s_shadow[bank], __ATOMIC_RELAXED);
+	return(mask & ~((uint32_t)(shadow >> 32) & ~((uint32_t)shadow ^ values)));
+}
+
+/**
+  * @brief  Selects the backend used by GPIOInit/GPIORead/GPIOWrite for a bank.
+  * @param  bank: GPIO bank
+  * @param  backend: GPIO_BACKEND_SYSFS, GPIO_BACKEND_CHARDEV or GPIO_BACKEND_MMAP
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOSetBackend(int bank, int backend)
+{
+	if (bank < 0 || bank >= GPIO_MAX_BANKS)
+		return(-1);
+
+	if (GPIO_BACKEND_SYSFS != backend && GPIO_BACKEND_CHARDEV != backend &&
+	    GPIO_BACKEND_MMAP != backend)
+		return(-1);
+
+	s_backend[bank] = backend;
+	return(0);
+}
+
+int
+GPIOGetBackend(int bank)
+{
+	if (bank < 0 || bank >= GPIO_MAX_BANKS)
+		return(-1);
+
+	return(s_backend[bank]);
+}
  
+/**
+  * @brief  Linux GPIO number of a pin, as used under /sys/class/gpio.
+  * @note   bank * 32 + gpio, except for banks mapped with a register
+  *         layout that numbers them differently (RZ/G2L: port * 8 + bit).
+  * @retval GPIO number
+  */
 int
-GPIOExport(int pin)
+GPIOPinNumber(int bank, int gpio)
+{
+	GPIO_MmapBank *b;
+
+	b = GPIOMmapGet(bank);
+	if (NULL != b && b->layout->pins_per_bank)
+		return(bank * b->layout->pins_per_bank + gpio);
+
+	return(bank * 32 + gpio);
+}
+
+/* handle index (bank * 32 + gpio) of a Linux GPIO number, -1 outside the cache */
+static int
+GPIOPinIndex(int pin)
+{
+	GPIO_MmapBank *b;
+	int bank;
+	int n;
+
+	for (bank = 0; bank < GPIO_MAX_BANKS; bank++) {
+		b = GPIOMmapGet(bank);
+		if (NULL == b || 0 == b->layout->pins_per_bank)
+			continue;
+		n = b->layout->pins_per_bank;
+		if (pin >= bank * n && pin < (bank + 1) * n)
+			return(bank * 32 + pin - bank * n);
+	}
+
+	return((pin < 0 || pin >= GPIO_MAX_PINS) ? -1 : pin);
+}
+
+static int
+GPIOExported(int pin)
+{
+	char path[GPIO_DIRECTION_MAX];
+
+	snprintf(path, GPIO_DIRECTION_MAX, "/sys/class/gpio/gpio%d", pin);
+	return(0 == access(path, F_OK));
+}
+
+static int
+GPIOExportFd(int fd, int pin)
 {
-#define BUFFER_MAX 3
 	char buffer[BUFFER_MAX];
 	ssize_t bytes_written;
+
+	bytes_written = snprintf(buffer, BUFFER_MAX, "%d", pin);
+	if (-1 == write(fd, buffer, bytes_written) && EBUSY != errno) {
+		fprintf(stderr, "Failed to export gpio %d!\n", pin);
+		return(-1);
+	}
+
+	/* EBUSY: exported meanwhile, nothing left to do */
+	return(0);
+}
+
+/**
+  * @brief  Waits until gpioN/direction of all pins is writable.
+  * @note   udev fixes up the permissions of a freshly exported pin
+  *         asynchronously. The wait sleeps on inotify IN_ATTRIB of the
+  *         direction files and re-checks at least every
+  *         GPIO_READY_RECHECK_MS in case no event is delivered.
+  * @retval 0 when all pins are ready, -1 on timeout
+  */
+static int
+GPIOWaitReady(const int *pins, int num, int timeout_ms)
+{
+	char path[GPIO_DIRECTION_MAX];
+	char events[1024];
+	struct pollfd pfd;
+	uint64_t deadline;
+	uint64_t now;
+	char *ready;
+	int pending;
+	int wait_ms;
+	int ifd = -1;
+	int i;
+
+	ready = calloc(num > 0 ? num : 1, 1);
+	if (NULL == ready)
+		return(-1);
+
+	deadline = GPIONowNs() / 1000000 + timeout_ms;
+	while (1) {
+		pending = 0;
+		for (i = 0; i < num; i++) {
+			if (ready[i])
+				continue;
+			snprintf(path, GPIO_DIRECTION_MAX, "/sys/class/gpio/gpio%d/direction", pins[i]);
+			if (0 == access(path, W_OK)) {
+				ready[i] = 1;
+				continue;
+			}
+			pending++;
+			if (-1 != ifd)
+				inotify_add_watch(ifd, path, IN_ATTRIB);
+		}
+
+		if (0 == pending)
+			break;
+
+		now = GPIONowNs() / 1000000;
+		if (now >= deadline) {
+			for (i = 0; i < num; i++) {
+				if (!ready[i])
+					fprintf(stderr, "Timeout waiting for gpio %d!\n", pins[i]);
+			}
+			break;
+		}
+
+		if (-1 == ifd) {
+			ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+			if (-1 != ifd)
+				continue;	/* add the watches, then re-check */
+		}
+
+		wait_ms = (int)(deadline - now);
+		if (wait_ms > GPIO_READY_RECHECK_MS)
+			wait_ms = GPIO_READY_RECHECK_MS;
+
+		if (-1 == ifd) {
+			usleep(wait_ms * 1000);
+			continue;
+		}
+
+		pfd.fd = ifd;
+		pfd.events = POLLIN;
+		if (poll(&pfd, 1, wait_ms) > 0)
+			while (read(ifd, events, sizeof(events)) > 0)
+				;
+	}
+
+	if (-1 != ifd)
+		close(ifd);
+	free(ready);
+
+	return(pending ? -1 : 0);
+}
+ 
+int
+GPIOExport(int pin)
+{
 	int fd;
+	int ret;
+
+	if (GPIOExported(pin))
+		return(0);
  
 	fd = open("/sys/class/gpio/export", O_WRONLY);
 	if (-1 == fd) {
@@ -81,10 +610,9 @@ GPIOExport(int pin)
 		return(-1);
 	}
  
-	bytes_written = snprintf(buffer, BUFFER_MAX, "%d", pin);
-	write(fd, buffer, bytes_written);
+	ret = GPIOExportFd(fd, pin);
 	close(fd);
-	return(0);
+	return(ret);
 }
  
 int
@@ -94,6 +622,8 @@ GPIOUnexport(int pin)
 	ssize_t bytes_written;
 	int fd;
  
+	GPIOHandleRelease(GPIOPinIndex(pin));
+
 	fd = open("/sys/class/gpio/unexport", O_WRONLY);
 	if (-1 == fd) {
 		fprintf(stderr, "Failed to open unexport for writing!\n");
@@ -106,99 +636,698 @@ GPIOUnexport(int pin)
 	return(0);
 }
  
-int
-GPIODirection(int pin, int dir)
+/* writes gpioN/direction, pin is the Linux GPIO number */
+static int
+GPIOSysfsDirection(int pin, int dir)
 {
 	static const char s_directions_str[]  = "in\0out";
- 
-#define DIRECTION_MAX 35
-	char path[DIRECTION_MAX];
+
+	char path[GPIO_DIRECTION_MAX];
+	char cur[4] = { 0 };
 	int fd;
- 
-	snprintf(path, DIRECTION_MAX, "/sys/class/gpio/gpio%d/direction", pin);
-	fd = open(path, O_WRONLY);
+
+	snprintf(path, GPIO_DIRECTION_MAX, "/sys/class/gpio/gpio%d/direction", pin);
+	fd = open(path, O_RDWR);
 	if (-1 == fd) {
 		fprintf(stderr, "Failed to open gpio direction for writing!\n");
 		return(-1);
 	}
- 
+
+	/* writing "out" drives the pin LOW, leave a pin that is already set alone */
+	if (pread(fd, cur, sizeof(cur) - 1, 0) > 0 &&
+	    0 == strncmp(cur, &s_directions_str[IN == dir ? 0 : 3], IN == dir ? 2 : 3)) {
+		close(fd);
+		return(0);
+	}
+
 	if (-1 == write(fd, &s_directions_str[IN == dir ? 0 : 3], IN == dir ? 2 : 3)) {
 		fprintf(stderr, "Failed to set direction!\n");
+		close(fd);
 		return(-1);
 	}
- 
+
 	close(fd);
 	return(0);
 }
+
+/**
+  * @brief  Sets the direction of a pin.
+  * @param  pin: Linux GPIO number
+  * @param  dir: IN or OUT
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIODirection(int pin, int dir)
+{
+	int ret = 0;
+	int idx;
+
+	/* the handle table is indexed by bank * 32 + gpio, not by GPIO number */
+	idx = GPIOPinIndex(pin);
+
+	/* line_dir[] of a shared request and the handle are read-modify-write */
+	GPIOHandlesLock();
+	if (-1 != idx)
+		GPIOShadowInvalidate(idx / 32, 1U << (idx % 32));
+
+	/* only this line of the request, the other lines keep their direction */
+	if (-1 != idx && NULL != s_handles[idx].lines)
+		ret = GPIOLinesDirection(s_handles[idx].lines, 1ULL << s_handles[idx].line, dir);
+	else
+		ret = GPIOSysfsDirection(pin, dir);
+
+	if (0 == ret && -1 != idx)
+		s_handles[idx].dir = (IN == dir) ? IN : OUT;
+	GPIOHandlesUnlock();
+
+	return(ret);
+}
  
+/**
+  * @brief  Selects which edges of an input make gpioN/value pollable.
+  * @param  pin: Linux GPIO number
+  * @param  edge: GPIO_EDGE_NONE/RISING/FALLING/BOTH
+  * @retval 0 on success, -1 on error
+  */
 int
-GPIORead(int bank,int gpio)
+GPIOEdge(int pin, int edge)
 {
-#define VALUE_MAX 30
-	char path[VALUE_MAX];
-	char value_str[3];
+	static const char *s_edges_str[] = { "none", "rising", "falling", "both" };
+
+	char path[GPIO_DIRECTION_MAX];
+	const char *str;
 	int fd;
-	
-	int pin;
-	pin = bank * 32 + gpio;
- 
-	snprintf(path, VALUE_MAX, "/sys/class/gpio/gpio%d/value", pin);
-	fd = open(path, O_RDONLY);
+
+	if (edge < GPIO_EDGE_NONE || edge > GPIO_EDGE_BOTH)
+		return(-1);
+
+	str = s_edges_str[edge];
+	snprintf(path, GPIO_DIRECTION_MAX, "/sys/class/gpio/gpio%d/edge", pin);
+	fd = open(path, O_WRONLY);
 	if (-1 == fd) {
-		fprintf(stderr, "Failed to open gpio value for reading!\n");
+		fprintf(stderr, "Failed to open gpio edge for writing!\n");
 		return(-1);
 	}
- 
-	if (-1 == read(fd, value_str, 3)) {
-		fprintf(stderr, "Failed to read value!\n");
+
+	if (-1 == write(fd, str, strlen(str))) {
+		fprintf(stderr, "Failed to set edge!\n");
+		close(fd);
 		return(-1);
 	}
- 
+
 	close(fd);
- 
-	return(atoi(value_str));
+	return(0);
 }
- 
+
+/**
+  * @brief  Reads a pin through its cached handle.
+  * @param  handle: handle returned by GPIOOpen()
+  * @retval LOW/HIGH on success, -1 on error
+  */
 int
-GPIOWrite(int bank,int gpio, int value)
+GPIOHandleRead(GPIO_Handle *handle)
+{
+	char value_str[3];
+	uint64_t bits;
+	uint32_t word;
+
+	if (NULL == handle || -1 == handle->fd)
+		return(-1);
+
+	if (GPIO_BACKEND_CHARDEV == handle->backend) {
+		if (GPIOLinesRead(handle->lines, 1ULL << handle->line, &bits))
+			return(-1);
+		return(bits ? HIGH : LOW);
+	}
+
+	if (GPIO_BACKEND_MMAP == handle->backend) {
+		if (GPIOMmapRead(handle->pin / 32, 1U << (handle->pin % 32), &word))
+			return(-1);
+		return(word ? HIGH : LOW);
+	}
+
+	if (pread(handle->fd, value_str, sizeof(value_str), 0) < 1) {
+		fprintf(stderr, "Failed to read value!\n");
+		return(-1);
+	}
+
+	return('0' == value_str[0] ? LOW : HIGH);
+}
+
+static int
+GPIOHandleWriteRaw(GPIO_Handle *handle, int value)
 {
 	static const char s_values_str[] = "01";
- 
-	char path[VALUE_MAX];
-	int fd;
- 
+
+	if (GPIO_BACKEND_CHARDEV == handle->backend)
+		return(GPIOLinesWrite(handle->lines, 1ULL << handle->line,
+				      LOW == value ? 0 : 1ULL << handle->line));
+
+	if (GPIO_BACKEND_MMAP == handle->backend)
+		return(GPIOMmapWrite(handle->pin / 32, 1U << (handle->pin % 32),
+				     LOW == value ? 0 : ~0U));
+
+	if (1 != pwrite(handle->fd, &s_values_str[LOW == value ? 0 : 1], 1, 0)) {
+		fprintf(stderr, "Failed to write value!\n");
+		return(-1);
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Drives a pin through its cached handle, bypassing the shadow.
+  * @param  handle: handle returned by GPIOOpen()
+  * @param  value: LOW or HIGH
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOHandleWriteForce(GPIO_Handle *handle, int value)
+{
+	uint32_t bit;
+	int ret;
+
+	if (NULL == handle || -1 == handle->fd)
+		return(-1);
+
+	ret = GPIOHandleWriteRaw(handle, value);
+
+	bit = 1U << (handle->pin % 32);
+	GPIOShadowUpdate(handle->pin / 32, bit, (LOW == value) ? 0 : bit, 0 == ret);
+	return(ret);
+}
+
+/**
+  * @brief  Drives a pin through its cached handle.
+  * @note   No syscall is made when the pin already holds the level, as
+  *         last written by this driver. Use the Force variant after the
+  *         pin may have been changed from outside.
+  * @param  handle: handle returned by GPIOOpen()
+  * @param  value: LOW or HIGH
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOHandleWrite(GPIO_Handle *handle, int value)
+{
+	uint32_t bit;
+
+	if (NULL == handle || -1 == handle->fd)
+		return(-1);
+
+	/* a register store is cheaper than the shadow bookkeeping */
+	if (GPIO_BACKEND_MMAP == handle->backend)
+		return(GPIOHandleWriteRaw(handle, value));
+
+	bit = 1U << (handle->pin % 32);
+	if (!GPIOShadowPending(handle->pin / 32, bit, (LOW == value) ? 0 : bit))
+		return(0);
+
+	return(GPIOHandleWriteForce(handle, value));
+}
+
+GPIO_Handle *
+GPIOOpen(int bank,int gpio)
+{
+	return(GPIOHandleGet(bank * 32 + gpio));
+}
+
+int
+GPIOClose(int bank,int gpio)
+{
 	int pin;
 	pin = bank * 32 + gpio;
 
-	snprintf(path, VALUE_MAX, "/sys/class/gpio/gpio%d/value", pin);
-	fd = open(path, O_WRONLY);
-	if (-1 == fd) {
-		fprintf(stderr, "Failed to open gpio value for writing!\n");
+	if (pin < 0 || pin >= GPIO_MAX_PINS)
 		return(-1);
-	}
+
+	GPIOHandleRelease(pin);
+	return(0);
+}
+
+void
+GPIOCloseAll(void)
+{
+	int i;
+
+	for (i = 0; i < GPIO_MAX_PINS; i++)
+		GPIOHandleRelease(i);
+}
  
-	if (1 != write(fd, &s_values_str[LOW == value ? 0 : 1], 1)) {
-		fprintf(stderr, "Failed to write value!\n");
+int
+GPIORead(int bank,int gpio)
+{
+	return(GPIOHandleRead(GPIOOpen(bank, gpio)));
+}
+ 
+int
+GPIOWrite(int bank,int gpio, int value)
+{
+	return(GPIOHandleWrite(GPIOOpen(bank, gpio), value));
+}
+
+int
+GPIOWriteForce(int bank,int gpio, int value)
+{
+	return(GPIOHandleWriteForce(GPIOOpen(bank, gpio), value));
+}
+
+/* mask pins of a bank that have no open handle yet */
+static int
+GPIOBankUnopened(int bank, uint32_t mask, int *gpios)
+{
+	int num = 0;
+	int gpio;
+
+	while (mask) {
+		gpio = __builtin_ctz(mask);
+		mask &= mask - 1;
+		if (-1 == __atomic_load_n(&s_handles[bank * 32 + gpio].fd, __ATOMIC_ACQUIRE))
+			gpios[num++] = gpio;
+	}
+
+	return(num);
+}
+
+/**
+  * @brief  Requests the mask pins of a chardev bank without a handle as one group.
+  * @note   The group is owned by the handle cache, GPIOClose() on any of
+  *         its pins releases it and the remaining pins are re-requested.
+  */
+static void
+GPIOBankRequest(int bank, uint32_t mask)
+{
+	int gpios[GPIO_PINS_PER_BANK];
+	GPIO_Lines *lines;
+	int num;
+
+	if (GPIO_BACKEND_CHARDEV != GPIOGetBackend(bank))
+		return;
+
+	/* a single pin is requested lazily by GPIOHandleGet() */
+	GPIOHandlesSetup();
+	if (GPIOBankUnopened(bank, mask, gpios) < 2)
+		return;
+
+	/* re-check under the lock, other threads may have opened pins meanwhile */
+	pthread_mutex_lock(&s_handles_lock);
+	num = GPIOBankUnopened(bank, mask, gpios);
+	if (num > 1) {
+		lines = GPIOLinesRequest(bank, gpios, num, -1);
+		if (NULL != lines)
+			lines->owned = 1;
+	}
+	pthread_mutex_unlock(&s_handles_lock);
+}
+
+/**
+  * @brief  Sorts the mask pins of a bank into line groups and sysfs handles.
+  * @param  groups/gmask: distinct line requests and their line masks
+  * @param  handles: sysfs handles, NULL terminated
+  * @retval Number of groups, -1 if a pin could not be opened
+  */
+static int
+GPIOBankCollect(int bank, uint32_t mask, GPIO_Lines **groups, uint64_t *gmask,
+		GPIO_Handle **handles)
+{
+	GPIO_Handle *h;
+	int ngroups = 0;
+	int nhandles = 0;
+	int gpio;
+	int g;
+
+	GPIOBankRequest(bank, mask);
+
+	while (mask) {
+		gpio = __builtin_ctz(mask);
+		mask &= mask - 1;
+
+		h = GPIOHandleGet(bank * 32 + gpio);
+		if (NULL == h)
+			return(-1);
+
+		if (GPIO_BACKEND_CHARDEV != h->backend) {
+			handles[nhandles++] = h;
+			continue;
+		}
+
+		for (g = 0; g < ngroups && groups[g] != h->lines; g++)
+			;
+		if (g == ngroups) {
+			groups[ngroups] = h->lines;
+			gmask[ngroups++] = 0;
+		}
+		gmask[g] |= 1ULL << h->line;
+	}
+
+	handles[nhandles] = NULL;
+	return(ngroups);
+}
+
+/**
+  * @brief  Reads several pins of one bank.
+  * @param  bank: GPIO bank
+  * @param  mask: pins to read, bit n = GPIOx_n
+  * @param  values: pin levels, bit n = GPIOx_n, pins outside mask read 0
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOReadBank(int bank, uint32_t mask, uint32_t *values)
+{
+	GPIO_Lines *groups[GPIO_PINS_PER_BANK];
+	uint64_t gmask[GPIO_PINS_PER_BANK];
+	GPIO_Handle *handles[GPIO_PINS_PER_BANK + 1];
+	uint32_t result = 0;
+	uint64_t bits;
+	int ngroups;
+	int value;
+	int g;
+	int i;
+
+	if (bank < 0 || bank >= GPIO_MAX_BANKS || NULL == values)
+		return(-1);
+
+	/* one load of the input register */
+	if (GPIO_BACKEND_MMAP == GPIOGetBackend(bank))
+		return(GPIOMmapRead(bank, mask, values));
+
+	ngroups = GPIOBankCollect(bank, mask, groups, gmask, handles);
+	if (ngroups < 0)
 		return(-1);
+
+	/* one GET_VALUES per line request */
+	for (g = 0; g < ngroups; g++) {
+		if (GPIOLinesRead(groups[g], gmask[g], &bits))
+			return(-1);
+		while (bits) {
+			i = __builtin_ctzll(bits);
+			bits &= bits - 1;
+			result |= 1U << groups[g]->gpio[i];
+		}
 	}
- 
-	close(fd);
+
+	/* one pread per sysfs pin */
+	for (i = 0; NULL != handles[i]; i++) {
+		value = GPIOHandleRead(handles[i]);
+		if (value < 0)
+			return(-1);
+		if (HIGH == value)
+			result |= 1U << (handles[i]->pin % 32);
+	}
+
+	*values = result;
+	return(0);
+}
+
+static int
+GPIOWriteBankRaw(int bank, uint32_t mask, uint32_t values)
+{
+	GPIO_Lines *groups[GPIO_PINS_PER_BANK];
+	uint64_t gmask[GPIO_PINS_PER_BANK];
+	GPIO_Handle *handles[GPIO_PINS_PER_BANK + 1];
+	uint64_t bits;
+	uint64_t lmask;
+	int ngroups;
+	int ret = 0;
+	int g;
+	int i;
+
+	/* set/clear register stores, or one locked read-modify-write */
+	if (GPIO_BACKEND_MMAP == GPIOGetBackend(bank))
+		return(GPIOMmapWrite(bank, mask, values));
+
+	ngroups = GPIOBankCollect(bank, mask, groups, gmask, handles);
+	if (ngroups < 0)
+		return(-1);
+
+	/* one SET_VALUES per line request, applied together by the kernel */
+	for (g = 0; g < ngroups; g++) {
+		bits = 0;
+		lmask = gmask[g];
+		while (lmask) {
+			i = __builtin_ctzll(lmask);
+			lmask &= lmask - 1;
+			if (values & (1U << groups[g]->gpio[i]))
+				bits |= 1ULL << i;
+		}
+		if (GPIOLinesWrite(groups[g], gmask[g], bits))
+			ret = -1;
+	}
+
+	for (i = 0; NULL != handles[i]; i++) {
+		if (GPIOHandleWriteRaw(handles[i], (values >> (handles[i]->pin % 32)) & 1))
+			ret = -1;
+	}
+
+	return(ret);
+}
+
+/**
+  * @brief  Drives several pins of one bank, bypassing the shadow.
+  * @param  bank: GPIO bank
+  * @param  mask: pins to drive, bit n = GPIOx_n
+  * @param  values: levels for the mask pins, bit n = GPIOx_n
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOWriteBankForce(int bank, uint32_t mask, uint32_t values)
+{
+	int ret;
+
+	if (bank < 0 || bank >= GPIO_MAX_BANKS)
+		return(-1);
+
+	if (0 == mask)
+		return(0);
+
+	ret = GPIOWriteBankRaw(bank, mask, values);
+	GPIOShadowUpdate(bank, mask, values, 0 == ret);
+	return(ret);
+}
+
+/**
+  * @brief  Drives several pins of one bank, skipping pins already at the level.
+  * @param  bank: GPIO bank
+  * @param  mask: pins to drive, bit n = GPIOx_n
+  * @param  values: levels for the mask pins, bit n = GPIOx_n
+  * @retval 0 on success, -1 on error
+  */
+int
+GPIOWriteBank(int bank, uint32_t mask, uint32_t values)
+{
+	if (bank < 0 || bank >= GPIO_MAX_BANKS)
+		return(-1);
+
+	if (GPIO_BACKEND_MMAP == GPIOGetBackend(bank))
+		return(GPIOMmapWrite(bank, mask, values));
+
+	return(GPIOWriteBankForce(bank, GPIOShadowPending(bank, mask, values), values));
+}
+
+/**
+  * @brief  GPIOInit() of a mapped bank: direction through the register
+  *         block if the SoC maps it, else through sysfs under the Linux
+  *         number of the pin.
+  */
+static int
+GPIOInitMmap(int bank, int gpio, int dir)
+{
+	int pin;
+	int sys;
+
+	pin = bank * 32 + gpio;
+	if (gpio < 0 || (GPIOMmapGet(bank)->layout->pins_per_bank &&
+			 gpio >= GPIOMmapGet(bank)->layout->pins_per_bank)) {
+		fprintf(stderr, "GPIO%d_%d is not a pin of the mapped bank!\n", bank, gpio);
+		return(-1);
+	}
+
+	GPIOShadowInvalidate(bank, 1U << gpio);
+	if (GPIO_REG_NONE != GPIOMmapGet(bank)->layout->dir) {
+		if (GPIOMmapDirection(bank, 1U << gpio, dir))
+			return(-1);
+	} else {
+		sys = GPIOPinNumber(bank, gpio);
+		if (GPIOExport(sys) || GPIOWaitReady(&sys, 1, GPIO_EXPORT_TIMEOUT_MS) ||
+		    GPIOSysfsDirection(sys, dir))
+			return(-1);
+	}
+
+	if (NULL == GPIOHandleGet(pin))
+		return(-1);
+
+	s_handles[pin].dir = (IN == dir) ? IN : OUT;
 	return(0);
 }
 
 int 
 GPIOInit(int bank,int gpio,int dir)
 {
+	int ret;
 	int pin;
+	int sys;
 	pin = bank * 32 + gpio;
 
-	if (GPIOExport(pin))
+	if (GPIO_BACKEND_CHARDEV == GPIOGetBackend(bank)) {
+		/* the pin keeps its current request if the new one fails */
+		GPIOHandlesLock();
+		ret = GPIOChardevInit(bank, gpio, dir);
+		GPIOHandlesUnlock();
+		return(ret);
+	}
+
+	GPIOHandlesLock();
+	if (GPIO_BACKEND_MMAP == GPIOGetBackend(bank) && NULL != GPIOMmapGet(bank)) {
+		ret = GPIOInitMmap(bank, gpio, dir);
+		GPIOHandlesUnlock();
+		return(ret);
+	}
+
+	sys = GPIOPinNumber(bank, gpio);
+	ret = -1;
+	if (0 == GPIOExport(sys) && 0 == GPIOWaitReady(&sys, 1, GPIO_EXPORT_TIMEOUT_MS) &&
+	    0 == GPIODirection(sys,dir) && NULL != GPIOHandleGet(pin))
+		ret = 0;
+	GPIOHandlesUnlock();
+
+	return(ret);
+}
+
+/**
+  * @brief  GPIOInitTable() part for chardev banks: one request per bank and direction.
+  */
+static int
+GPIOInitTableChardev(const GPIO_PinConfig *table, int num, char *done)
+{
+	int gpios[GPIO_PINS_PER_BANK];
+	GPIO_Lines *lines;
+	int ret = 0;
+	int n;
+	int i;
+	int j;
+
+	for (i = 0; i < num; i++) {
+		if (done[i] || GPIO_BACKEND_CHARDEV != GPIOGetBackend(table[i].bank))
+			continue;
+
+		/* pins already requested this way keep their request and level */
+		if (GPIOLinesHeld(table[i].bank, table[i].gpio, table[i].dir)) {
+			done[i] = 1;
+			continue;
+		}
+
+		n = 0;
+		for (j = i; j < num && n < GPIO_PINS_PER_BANK; j++) {
+			if (!done[j] && table[j].bank == table[i].bank && table[j].dir == table[i].dir &&
+			    !GPIOLinesHeld(table[j].bank, table[j].gpio, table[j].dir)) {
+				gpios[n++] = table[j].gpio;
+				done[j] = 1;
+			}
+		}
+
+		lines = GPIOLinesRequest(table[i].bank, gpios, n, table[i].dir);
+		if (NULL == lines)
+			ret = -1;
+		else
+			lines->owned = 1;
+	}
+
+	return(ret);
+}
+
+/**
+  * @brief  Initialises a table of pins in one pass.
+  * @note   Pins that are already exported are reused. All missing pins
+  *         are exported first, then the driver waits for all of them
+  *         together and finally sets every direction. Chardev banks get
+  *         one line request per bank and direction. A pin that already
+  *         has its direction is left as is, so live outputs do not glitch.
+  * @param  table: pins to initialise
+  * @param  num: number of entries
+  * @retval 0 on success, -1 if any pin failed (the others are initialised)
+  */
+int
+GPIOInitTable(const GPIO_PinConfig *table, int num)
+{
+	int *pins;
+	char *done;
+	int npins = 0;
+	int efd = -1;
+	int no_export = 0;
+	int ret = 0;
+	int pin;
+	int i;
+
+	if (NULL == table || num < 1)
 		return(-1);
 
-	if (GPIODirection(pin,dir))
+	pins = calloc(num, sizeof(int));
+	done = calloc(num, 1);
+	if (NULL == pins || NULL == done) {
+		free(pins);
+		free(done);
 		return(-1);
+	}
 
-	return(0);
+	/* one configuration pass, the pins of the table are not seen half set up */
+	GPIOHandlesLock();
+	if (GPIOInitTableChardev(table, num, done))
+		ret = -1;
+
+	for (i = 0; i < num; i++) {
+		if (!done[i] && GPIO_BACKEND_MMAP == GPIOGetBackend(table[i].bank)) {
+			if (GPIOInit(table[i].bank, table[i].gpio, table[i].dir))
+				ret = -1;
+			done[i] = 1;
+		}
+	}
+
+	/*
+	 * export everything missing through one open export file; pins that
+	 * cannot be exported are marked done so that pins[] stays in step
+	 * with the remaining entries
+	 */
+	for (i = 0; i < num; i++) {
+		if (done[i])
+			continue;
+
+		pin = GPIOPinNumber(table[i].bank, table[i].gpio);
+		if (!GPIOExported(pin)) {
+			if (-1 == efd && !no_export) {
+				efd = open("/sys/class/gpio/export", O_WRONLY);
+				if (-1 == efd) {
+					fprintf(stderr, "Failed to open export for writing!\n");
+					no_export = 1;
+				}
+			}
+			if (-1 == efd || GPIOExportFd(efd, pin)) {
+				ret = -1;
+				done[i] = 1;
+				continue;
+			}
+		}
+		pins[npins++] = pin;
+	}
+	if (-1 != efd)
+		close(efd);
+
+	if (GPIOWaitReady(pins, npins, GPIO_EXPORT_TIMEOUT_MS))
+		ret = -1;
+
+	npins = 0;
+	for (i = 0; i < num; i++) {
+		if (done[i])
+			continue;
+
+		pin = pins[npins++];
+		if (GPIODirection(pin, table[i].dir) ||
+		    NULL == GPIOHandleGet(table[i].bank * 32 + table[i].gpio))
+			ret = -1;
+	}
+	GPIOHandlesUnlock();
+
+	free(pins);
+	free(done);
+	return(ret);
 }
 
 /************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
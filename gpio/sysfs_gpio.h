@@ -12,21 +12,109 @@
   *          - Digital input reading
   *          - Digital output control
   *          - Bank-based GPIO addressing
+  *          - Persistent per-pin value handles
+  *          - Selectable sysfs or character-device backend per bank
   ******************************************************************************
   * @defgroup GPIO_Macros GPIO Direction and State Macros
   * @brief Constants for GPIO direction and output state
   * @{
   */
- 
+
+#ifndef __SYSFS_GPIO_H
+#define __SYSFS_GPIO_H
+
+#include <stdint.h>
+
 #define IN  0
 #define OUT 1
- 
+#define OUT_OPEN_DRAIN	2	/* HIGH releases the line, chardev backend only */
+
 #define LOW  0
 #define HIGH 1
 
+#define GPIO_EDGE_NONE		0
+#define GPIO_EDGE_RISING	1
+#define GPIO_EDGE_FALLING	2
+#define GPIO_EDGE_BOTH		(GPIO_EDGE_RISING | GPIO_EDGE_FALLING)
+
+/** @} */
+
+/**
+  * @defgroup GPIO_Handles GPIO Handle Cache
+  * @brief Per-pin cache of open sysfs value files
+  * @{
+  */
+
+#define GPIO_PINS_PER_BANK	32
+
+/*
+ * Number of banks covered by the handle cache, override with -DGPIO_MAX_BANKS=n.
+ * 64 covers the 49 ports of RZ/G2L, which the register backend maps as banks.
+ */
+#ifndef GPIO_MAX_BANKS
+#define GPIO_MAX_BANKS		64
+#endif
+
+#define GPIO_MAX_PINS		(GPIO_MAX_BANKS * GPIO_PINS_PER_BANK)
+
+#define GPIO_BACKEND_SYSFS	0	/* /sys/class/gpio (default) */
+#define GPIO_BACKEND_CHARDEV	1	/* /dev/gpiochipN line requests */
+#define GPIO_BACKEND_MMAP	2	/* memory mapped bank registers */
+
+#define GPIO_DIRECTION_MAX	35	/* "/sys/class/gpio/gpioNNNN/direction" incl. NUL */
+
+struct GPIO_Lines;
+
+typedef struct {
+	int pin;	/* handle index, bank * 32 + gpio */
+	int fd;		/* gpioN/value file or line request fd, -1 when closed */
+	int dir;	/* IN / OUT as last configured, -1 if unknown */
+	int backend;	/* GPIO_BACKEND_* the fd belongs to */
+	int line;	/* bit index inside the line request (chardev only) */
+	struct GPIO_Lines *lines;	/* owning line request (chardev only) */
+} GPIO_Handle;
+
+typedef struct {
+	int bank;
+	int gpio;
+	int dir;	/* IN / OUT */
+} GPIO_PinConfig;
+
+/* Time allowed for udev to fix up the permissions of an exported pin */
+#ifndef GPIO_EXPORT_TIMEOUT_MS
+#define GPIO_EXPORT_TIMEOUT_MS	1000
+#endif
+
+/** @} */
+
+extern int GPIOExport(int pin);
+extern int GPIOUnexport(int pin);
+extern int GPIODirection(int pin, int dir);
+extern int GPIOEdge(int pin, int edge);
+extern int GPIOPinNumber(int bank, int gpio);
+
 extern int GPIOInit(int bank,int gpio,int dir);
+extern int GPIOInitTable(const GPIO_PinConfig *table, int num);
 extern int GPIORead(int bank,int gpio);
 extern int GPIOWrite(int bank,int gpio, int value);
+extern int GPIOReadBank(int bank, uint32_t mask, uint32_t *values);
+extern int GPIOWriteBank(int bank, uint32_t mask, uint32_t values);
+extern int GPIOWriteForce(int bank,int gpio, int value);
+extern int GPIOWriteBankForce(int bank, uint32_t mask, uint32_t values);
+extern void GPIOShadowInvalidate(int bank, uint32_t mask);
+
+extern GPIO_Handle *GPIOOpen(int bank,int gpio);
+extern int GPIOHandleRead(GPIO_Handle *handle);
+extern int GPIOHandleWrite(GPIO_Handle *handle, int value);
+extern int GPIOHandleWriteForce(GPIO_Handle *handle, int value);
+extern int GPIOClose(int bank,int gpio);
+extern void GPIOCloseAll(void);
+
+extern int GPIOSetBackend(int bank, int backend);
+extern int GPIOGetBackend(int bank);
+extern int GPIOHandleBind(int pin, struct GPIO_Lines *lines, int line);
+extern struct GPIO_Lines *GPIOHandleLines(int pin);
+extern void GPIOHandleUnbind(int pin, struct GPIO_Lines *lines);
 
 
 #endif /*__SYSFS_GPIO_H */
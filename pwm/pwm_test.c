@@ -0,0 +1,90 @@
+/**
+  ******************************************************************************
+  * @file    pwm_test.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file demonstrates hardware PWM output through sysfs:
+  *           - Channel export and configuration
+  *           - Duty cycle ramp through a cached handle
+  *           - Frequency change with ordered period/duty writes
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the PWM Example
+  *          ===================================================================
+  *
+  *          - pwmchip0/pwm0 is set to 1 kHz and enabled
+  *          - The duty cycle ramps 0 -> 100 % -> 0 in 1 % steps every 20 ms,
+  *            each step a single write of duty_cycle
+  *          - Every ramp alternates the frequency between 1 kHz and 2 kHz,
+  *            keeping the duty cycle in percent
+  *          - The PWM block generates the waveform, the program only
+  *            sleeps between updates
+  *
+  *          ===================================================================
+  *                              How to use this example
+  *          ===================================================================
+  *            - Enable the PWM controller and its pinmux in the device tree
+  *            - Compile with: gcc sysfs_pwm.c pwm_test.c -o pwm_test
+  *            - Run with: sudo ./pwm_test [chip] [channel]
+  *            - Run against a fake tree with: ./pwm_test 0 0 /tmp/pwm
+  *              (needs /tmp/pwm/pwmchip0/{export,unexport} and
+  *              /tmp/pwm/pwmchip0/pwm0/{period,duty_cycle,enable,polarity})
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "sysfs_pwm.h"
+
+#define PERIOD_1KHZ	1000000ULL
+#define PERIOD_2KHZ	500000ULL
+
+int main(int argc, char *argv[])
+{
+	PWM_Handle *pwm;
+	uint64_t period = PERIOD_1KHZ;
+	int chip = 0;
+	int channel = 0;
+	int step;
+	int i;
+
+	if (argc > 1)
+		chip = atoi(argv[1]);
+	if (argc > 2)
+		channel = atoi(argv[2]);
+	if (argc > 3 && PWMSetRoot(argv[3]))
+		return 1;
+
+	if (PWMInit(chip, channel, period, 0) || PWMEnable(chip, channel, 1))
+		return 1;
+
+	pwm = PWMOpen(chip, channel);
+	while (1) {
+		for (i = 0; i <= 200; i++) {
+			step = (i <= 100) ? i : 200 - i;
+			PWMHandleSetDuty(pwm, period * step / 100);
+			usleep(20000);
+		}
+
+		period = (PERIOD_1KHZ == period) ? PERIOD_2KHZ : PERIOD_1KHZ;
+		PWMHandleConfig(pwm, period, 0);
+		printf("\r\n pwmchip%d/pwm%d now %llu Hz", chip, channel,
+		       1000000000ULL / (unsigned long long)period);
+	}
+
+	PWMEnable(chip, channel, 0);
+	PWMCloseAll();
+	return 0;
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
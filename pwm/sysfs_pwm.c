@@ -0,0 +1,550 @@
+/**
+  ******************************************************************************
+  * @file    sysfs_pwm.c
+  * @author  Name , Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides functions to manage hardware PWM outputs through sysfs:
+  *           - PWM channel export/unexport management
+  *           - Period and duty cycle configuration
+  *           - Enable and polarity control
+  *           - Cached attribute fds for run-time updates
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of Sysfs PWM Interface
+  *          ===================================================================
+  *
+  *          PWM Chip Architecture
+  *          =====================
+  *          - Every PWM controller of the SoC is a pwmchipN with one or
+  *            more channels (eHRPWM/eCAP on AM335x, PWMx on i.MX, GPT/MTU3
+  *            on RZ/G2L); the numbering follows the device tree
+  *          - Writing the channel number to pwmchipN/export creates
+  *            pwmchipN/pwmM with period, duty_cycle, enable and polarity
+  *          - The waveform is generated by the PWM block, no CPU time is
+  *            spent once the channel is configured
+  *
+  *          Handle Cache
+  *          =======================
+  *          - period, duty_cycle and enable of every initialised channel
+  *            are opened once and kept in a table indexed by chip/channel
+  *          - Updates are one pwrite() at offset 0 per changed attribute;
+  *            values equal to the last written ones are not written again
+  *
+  *          Period/Duty Updates
+  *          =======================
+  *          - The kernel rejects any state with duty_cycle > period, so
+  *            PWMConfig() orders the two writes: period first when it
+  *            grows past the current duty, duty first when the period
+  *            shrinks below it. Every intermediate state is valid and no
+  *            write fails half-way through an update
+  *          - Most PWM blocks latch new values at the end of the running
+  *            period, so the output does not glitch
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "sysfs_pwm.h" in your application
+  *            - Initialize a channel with PWMInit(chip, channel, period, duty),
+  *              or many channels at once with PWMInitTable(table, count)
+  *            - Switch the output on with PWMEnable(chip, channel, 1)
+  *            - Change the duty cycle with PWMSetDuty(), period and duty
+  *              together with PWMConfig()
+  *            - For tight loops fetch the handle once with PWMOpen() and use
+  *              PWMHandleSetDuty()/PWMHandleConfig()
+  *            - Release cached fds with PWMCloseAll() before exiting
+  *            - Point the driver at a fake sysfs tree with PWMSetRoot()
+  *            - Compile with: gcc sysfs_pwm.c your_app.c -o pwm_app
+  *            - Run with root privileges: sudo ./pwm_app
+  *
+  *          Example Usage:
+  *            // 1 kHz, 25 % duty on pwmchip0/pwm0
+  *            PWMInit(0, 0, 1000000, 250000);
+  *            PWMEnable(0, 0, 1);
+  *
+  *            // Brightness ramp through the cached handle
+  *            PWM_Handle *led = PWMOpen(0, 0);
+  *            for (duty = 0; duty <= 1000000; duty += 10000)
+  *                PWMHandleSetDuty(led, duty);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sysfs_pwm.h"
+
+#define BUFFER_MAX		24
+#define PWM_READY_RECHECK_MS	5
+
+static char s_root[PWM_ROOT_MAX] = PWM_ROOT_DEFAULT;
+static PWM_Handle s_handles[PWM_MAX_CHIPS][PWM_MAX_CHANNELS];
+static int s_handles_ready;
+
+static void
+PWMHandlesSetup(void)
+{
+	int i;
+	int j;
+
+	if (s_handles_ready)
+		return;
+
+	for (i = 0; i < PWM_MAX_CHIPS; i++) {
+		for (j = 0; j < PWM_MAX_CHANNELS; j++) {
+			s_handles[i][j].chip = i;
+			s_handles[i][j].channel = j;
+			s_handles[i][j].period_fd = -1;
+			s_handles[i][j].duty_fd = -1;
+			s_handles[i][j].enable_fd = -1;
+			s_handles[i][j].enabled = -1;
+		}
+	}
+	s_handles_ready = 1;
+}
+
+static int
+PWMValid(int chip, int channel)
+{
+	return(chip >= 0 && chip < PWM_MAX_CHIPS && channel >= 0 && channel < PWM_MAX_CHANNELS);
+}
+
+/* attr NULL gives the pwmM directory itself */
+static void
+PWMPath(char *path, int chip, int channel, const char *attr)
+{
+	if (NULL == attr)
+		snprintf(path, PWM_PATH_MAX, "%s/pwmchip%d/pwm%d", s_root, chip, channel);
+	else
+		snprintf(path, PWM_PATH_MAX, "%s/pwmchip%d/pwm%d/%s", s_root, chip, channel, attr);
+}
+
+static int
+PWMWriteValue(int fd, uint64_t value)
+{
+	char buffer[BUFFER_MAX];
+	char *p = buffer + BUFFER_MAX;
+
+	/*
+	 * decimal, built from the end of the buffer; the newline ends the
+	 * value for readers of a fake tree where a shorter write leaves the
+	 * tail of the previous one in place
+	 */
+	*--p = '\n';
+	do {
+		*--p = '0' + value % 10;
+		value /= 10;
+	} while (value);
+
+	if (-1 == pwrite(fd, p, buffer + BUFFER_MAX - p, 0))
+		return(-1);
+
+	return(0);
+}
+
+static int
+PWMReadValue(int fd, uint64_t *value)
+{
+	char buffer[BUFFER_MAX];
+	uint64_t v = 0;
+	ssize_t len;
+	ssize_t i;
+
+	len = pread(fd, buffer, sizeof(buffer), 0);
+	if (len < 1)
+		return(-1);
+
+	for (i = 0; i < len && buffer[i] >= '0' && buffer[i] <= '9'; i++)
+		v = v * 10 + (buffer[i] - '0');
+
+	*value = v;
+	return(0);
+}
+
+/* reloads the cached values after a failed write left them unknown */
+static void
+PWMHandleSync(PWM_Handle *h)
+{
+	uint64_t value;
+
+	h->period_ns = (0 == PWMReadValue(h->period_fd, &value)) ? value : 0;
+	h->duty_ns = (0 == PWMReadValue(h->duty_fd, &value)) ? value : 0;
+	h->enabled = (0 == PWMReadValue(h->enable_fd, &value)) ? (int)value : -1;
+}
+
+static void
+PWMHandleRelease(PWM_Handle *h)
+{
+	if (-1 != h->period_fd)
+		close(h->period_fd);
+	if (-1 != h->duty_fd)
+		close(h->duty_fd);
+	if (-1 != h->enable_fd)
+		close(h->enable_fd);
+
+	h->period_fd = -1;
+	h->duty_fd = -1;
+	h->enable_fd = -1;
+	h->period_ns = 0;
+	h->duty_ns = 0;
+	h->enabled = -1;
+}
+
+/**
+  * @brief  Selects the directory holding the pwmchipN entries.
+  * @param  path: e.g. "/sys/class/pwm" (default) or a fake tree for tests
+  * @retval 0 on success, -1 on error
+  */
+int
+PWMSetRoot(const char *path)
+{
+	if (NULL == path || strlen(path) >= PWM_ROOT_MAX)
+		return(-1);
+
+	PWMCloseAll();
+	snprintf(s_root, PWM_ROOT_MAX, "%s", path);
+	return(0);
+}
+
+static int
+PWMExported(int chip, int channel)
+{
+	char path[PWM_PATH_MAX];
+
+	PWMPath(path, chip, channel, NULL);
+	return(0 == access(path, F_OK));
+}
+
+static int
+PWMWriteChipFile(int chip, const char *name, int channel)
+{
+	char path[PWM_PATH_MAX];
+	char buffer[BUFFER_MAX];
+	ssize_t bytes_written;
+	int fd;
+
+	snprintf(path, PWM_PATH_MAX, "%s/pwmchip%d/%s", s_root, chip, name);
+	fd = open(path, O_WRONLY | O_CLOEXEC);
+	if (-1 == fd) {
+		fprintf(stderr, "Failed to open %s for writing!\n", path);
+		return(-1);
+	}
+
+	bytes_written = snprintf(buffer, BUFFER_MAX, "%d", channel);
+	if (-1 == write(fd, buffer, bytes_written) && EBUSY != errno) {
+		fprintf(stderr, "Failed to write pwm %s!\n", name);
+		close(fd);
+		return(-1);
+	}
+
+	close(fd);
+	return(0);
+}
+
+int
+PWMExport(int chip, int channel)
+{
+	if (PWMExported(chip, channel))
+		return(0);
+
+	/* EBUSY: exported meanwhile, nothing left to do */
+	return(PWMWriteChipFile(chip, "export", channel));
+}
+
+int
+PWMUnexport(int chip, int channel)
+{
+	PWMClose(chip, channel);
+	return(PWMWriteChipFile(chip, "unexport", channel));
+}
+
+/**
+  * @brief  Waits until pwmN/period of a freshly exported channel is writable.
+  * @retval 0 when ready, -1 on timeout
+  */
+static int
+PWMWaitReady(int chip, int channel, int timeout_ms)
+{
+	char path[PWM_PATH_MAX];
+	int waited = 0;
+
+	PWMPath(path, chip, channel, "period");
+	while (0 != access(path, W_OK)) {
+		if (waited >= timeout_ms) {
+			fprintf(stderr, "Timeout waiting for pwmchip%d/pwm%d!\n", chip, channel);
+			return(-1);
+		}
+		usleep(PWM_READY_RECHECK_MS * 1000);
+		waited += PWM_READY_RECHECK_MS;
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Opens period/duty_cycle/enable of an exported channel once and caches the fds.
+  * @param  chip: pwmchip number
+  * @param  channel: channel of the chip
+  * @retval Pointer to the cached handle, NULL on error
+  */
+PWM_Handle *
+PWMOpen(int chip, int channel)
+{
+	char path[PWM_PATH_MAX];
+	PWM_Handle *h;
+
+	if (!PWMValid(chip, channel)) {
+		fprintf(stderr, "PWM %d/%d outside handle cache!\n", chip, channel);
+		return(NULL);
+	}
+
+	PWMHandlesSetup();
+	h = &s_handles[chip][channel];
+	if (-1 != h->period_fd)
+		return(h);
+
+	PWMPath(path, chip, channel, "period");
+	h->period_fd = open(path, O_RDWR | O_CLOEXEC);
+	PWMPath(path, chip, channel, "duty_cycle");
+	h->duty_fd = open(path, O_RDWR | O_CLOEXEC);
+	PWMPath(path, chip, channel, "enable");
+	h->enable_fd = open(path, O_RDWR | O_CLOEXEC);
+	if (-1 == h->period_fd || -1 == h->duty_fd || -1 == h->enable_fd) {
+		fprintf(stderr, "Failed to open pwmchip%d/pwm%d attributes!\n", chip, channel);
+		PWMHandleRelease(h);
+		return(NULL);
+	}
+
+	/* the write order of PWMHandleConfig() depends on the current values */
+	PWMHandleSync(h);
+	return(h);
+}
+
+/**
+  * @brief  Sets period and duty cycle, writing them in an order the kernel accepts.
+  * @param  handle: handle returned by PWMOpen()
+  * @param  period_ns: new period
+  * @param  duty_ns: new active time, at most period_ns
+  * @retval 0 on success, -1 on error
+  */
+int
+PWMHandleConfig(PWM_Handle *handle, uint64_t period_ns, uint64_t duty_ns)
+{
+	int ret = 0;
+
+	if (NULL == handle || -1 == handle->period_fd || duty_ns > period_ns || 0 == period_ns)
+		return(-1);
+
+	if (period_ns == handle->period_ns)
+		return(PWMHandleSetDuty(handle, duty_ns));
+
+	if (period_ns >= handle->duty_ns) {
+		/* the current duty still fits into the new period */
+		if (PWMWriteValue(handle->period_fd, period_ns))
+			ret = -1;
+		else if (duty_ns != handle->duty_ns && PWMWriteValue(handle->duty_fd, duty_ns))
+			ret = -1;
+	} else {
+		/* shrink the duty below the new period first */
+		if (PWMWriteValue(handle->duty_fd, duty_ns))
+			ret = -1;
+		else if (PWMWriteValue(handle->period_fd, period_ns))
+			ret = -1;
+	}
+
+	if (ret) {
+		fprintf(stderr, "Failed to configure pwmchip%d/pwm%d!\n", handle->chip, handle->channel);
+		PWMHandleSync(handle);
+		return(-1);
+	}
+
+	handle->period_ns = period_ns;
+	handle->duty_ns = duty_ns;
+	return(0);
+}
+
+int
+PWMHandleSetDuty(PWM_Handle *handle, uint64_t duty_ns)
+{
+	if (NULL == handle || -1 == handle->duty_fd || duty_ns > handle->period_ns)
+		return(-1);
+
+	if (duty_ns == handle->duty_ns)
+		return(0);
+
+	if (PWMWriteValue(handle->duty_fd, duty_ns)) {
+		fprintf(stderr, "Failed to set pwm duty cycle!\n");
+		PWMHandleSync(handle);
+		return(-1);
+	}
+
+	handle->duty_ns = duty_ns;
+	return(0);
+}
+
+int
+PWMHandleEnable(PWM_Handle *handle, int enable)
+{
+	if (NULL == handle || -1 == handle->enable_fd)
+		return(-1);
+
+	enable = enable ? 1 : 0;
+	if (enable == handle->enabled)
+		return(0);
+
+	if (PWMWriteValue(handle->enable_fd, enable)) {
+		fprintf(stderr, "Failed to %s pwm!\n", enable ? "enable" : "disable");
+		PWMHandleSync(handle);
+		return(-1);
+	}
+
+	handle->enabled = enable;
+	return(0);
+}
+
+int
+PWMConfig(int chip, int channel, uint64_t period_ns, uint64_t duty_ns)
+{
+	return(PWMHandleConfig(PWMOpen(chip, channel), period_ns, duty_ns));
+}
+
+int
+PWMSetDuty(int chip, int channel, uint64_t duty_ns)
+{
+	return(PWMHandleSetDuty(PWMOpen(chip, channel), duty_ns));
+}
+
+int
+PWMEnable(int chip, int channel, int enable)
+{
+	return(PWMHandleEnable(PWMOpen(chip, channel), enable));
+}
+
+/**
+  * @brief  Selects the output polarity, the channel must be disabled.
+  * @param  polarity: PWM_POLARITY_NORMAL or PWM_POLARITY_INVERSED
+  * @retval 0 on success, -1 on error
+  */
+int
+PWMPolarity(int chip, int channel, int polarity)
+{
+	static const char *s_polarity_str[] = { "normal", "inversed" };
+
+	char path[PWM_PATH_MAX];
+	const char *str;
+	int fd;
+
+	if (PWM_POLARITY_NORMAL != polarity && PWM_POLARITY_INVERSED != polarity)
+		return(-1);
+
+	str = s_polarity_str[polarity];
+	PWMPath(path, chip, channel, "polarity");
+	fd = open(path, O_WRONLY | O_CLOEXEC);
+	if (-1 == fd) {
+		fprintf(stderr, "Failed to open pwm polarity for writing!\n");
+		return(-1);
+	}
+
+	if (-1 == write(fd, str, strlen(str))) {
+		fprintf(stderr, "Failed to set polarity!\n");
+		close(fd);
+		return(-1);
+	}
+
+	close(fd);
+	return(0);
+}
+
+int
+PWMInit(int chip, int channel, uint64_t period_ns, uint64_t duty_ns)
+{
+	if (!PWMValid(chip, channel))
+		return(-1);
+
+	if (PWMExport(chip, channel))
+		return(-1);
+
+	if (PWMWaitReady(chip, channel, PWM_EXPORT_TIMEOUT_MS))
+		return(-1);
+
+	return(PWMConfig(chip, channel, period_ns, duty_ns));
+}
+
+/**
+  * @brief  Initialises a table of channels in one pass.
+  * @note   All channels are exported first, then the driver waits for
+  *         them and finally configures and enables each one, so the
+  *         export latency is paid once for the whole table.
+  * @param  table: channels to initialise
+  * @param  num: number of entries
+  * @retval 0 on success, -1 if any channel failed (the others are initialised)
+  */
+int
+PWMInitTable(const PWM_Config *table, int num)
+{
+	int ret = 0;
+	int i;
+
+	if (NULL == table || num < 1)
+		return(-1);
+
+	for (i = 0; i < num; i++) {
+		if (!PWMValid(table[i].chip, table[i].channel) ||
+		    PWMExport(table[i].chip, table[i].channel))
+			ret = -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (!PWMValid(table[i].chip, table[i].channel))
+			continue;
+
+		if (PWMWaitReady(table[i].chip, table[i].channel, PWM_EXPORT_TIMEOUT_MS) ||
+		    PWMConfig(table[i].chip, table[i].channel, table[i].period_ns, table[i].duty_ns) ||
+		    PWMEnable(table[i].chip, table[i].channel, table[i].enable))
+			ret = -1;
+	}
+
+	return(ret);
+}
+
+int
+PWMClose(int chip, int channel)
+{
+	if (!PWMValid(chip, channel))
+		return(-1);
+
+	if (s_handles_ready)
+		PWMHandleRelease(&s_handles[chip][channel]);
+	return(0);
+}
+
+void
+PWMCloseAll(void)
+{
+	int i;
+	int j;
+
+	if (!s_handles_ready)
+		return;
+
+	for (i = 0; i < PWM_MAX_CHIPS; i++) {
+		for (j = 0; j < PWM_MAX_CHANNELS; j++)
+			PWMHandleRelease(&s_handles[i][j]);
+	}
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    sysfs_pwm.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the hardware
+  *          PWM driver using the Linux pwmchip sysfs class.
+  *
+  * @details Provides the following functionality:
+  *          - PWM channel export and initialization
+  *          - Period / duty cycle updates in a valid order
+  *          - Enable and polarity control
+  *          - Persistent per-channel attribute handles
+  *          - Table based setup of many channels
+  ******************************************************************************
+  * @defgroup PWM_Handles PWM Handle Cache
+  * @brief Per-channel cache of open sysfs attribute files
+  * @{
+  */
+
+#ifndef __SYSFS_PWM_H
+#define __SYSFS_PWM_H
+
+#include <stdint.h>
+
+/* Channels covered by the handle cache, override with -DPWM_MAX_CHIPS=n */
+#ifndef PWM_MAX_CHIPS
+#define PWM_MAX_CHIPS		8
+#endif
+#define PWM_MAX_CHANNELS	16	/* per pwmchip */
+
+#define PWM_ROOT_DEFAULT	"/sys/class/pwm"
+#define PWM_ROOT_MAX		48	/* PWMSetRoot() path length incl. NUL */
+#define PWM_PATH_MAX		96
+
+/* Time allowed for udev to fix up the permissions of an exported channel */
+#ifndef PWM_EXPORT_TIMEOUT_MS
+#define PWM_EXPORT_TIMEOUT_MS	1000
+#endif
+
+#define PWM_POLARITY_NORMAL	0
+#define PWM_POLARITY_INVERSED	1
+
+typedef struct {
+	int chip;
+	int channel;
+	int period_fd;		/* pwmN/period, -1 when closed */
+	int duty_fd;		/* pwmN/duty_cycle */
+	int enable_fd;		/* pwmN/enable */
+	uint64_t period_ns;	/* last value written, 0 if unknown */
+	uint64_t duty_ns;
+	int enabled;		/* -1 if unknown */
+} PWM_Handle;
+
+typedef struct {
+	int chip;
+	int channel;
+	uint64_t period_ns;
+	uint64_t duty_ns;
+	int enable;
+} PWM_Config;
+
+/** @} */
+
+extern int PWMSetRoot(const char *path);
+extern int PWMExport(int chip, int channel);
+extern int PWMUnexport(int chip, int channel);
+extern PWM_Handle *PWMOpen(int chip, int channel);
+extern int PWMInit(int chip, int channel, uint64_t period_ns, uint64_t duty_ns);
+extern int PWMInitTable(const PWM_Config *table, int num);
+extern int PWMConfig(int chip, int channel, uint64_t period_ns, uint64_t duty_ns);
+extern int PWMSetDuty(int chip, int channel, uint64_t duty_ns);
+extern int PWMEnable(int chip, int channel, int enable);
+extern int PWMPolarity(int chip, int channel, int polarity);
+extern int PWMHandleConfig(PWM_Handle *handle, uint64_t period_ns, uint64_t duty_ns);
+extern int PWMHandleSetDuty(PWM_Handle *handle, uint64_t duty_ns);
+extern int PWMHandleEnable(PWM_Handle *handle, int enable);
+extern int PWMClose(int chip, int channel);
+extern void PWMCloseAll(void);
+
+
+#endif /*__SYSFS_PWM_H */
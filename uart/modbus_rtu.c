@@ -0,0 +1,944 @@
+/**
+  ******************************************************************************
+  * @file    modbus_rtu.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides a Modbus RTU master on the UART engine:
+  *           - RTU framing with CRC-16 and t1.5 / t3.5 timing on timerfd
+  *           - Points of many slaves polled at per-slave intervals
+  *           - Adjacent points joined into one read request
+  *           - Timeouts, retries and offline slaves
+  *           - Queued writes of registers and coils
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Modbus Master
+  *          ===================================================================
+  *
+  *          Frame Timing
+  *          =====================
+  *          - A character is 1 + 8 + parity + stop bits; up to 19200 baud
+  *            t1.5 and t3.5 are 1.5 and 3.5 character times, above that
+  *            the fixed 750 us and 1750 us of the specification
+  *          - Before each request the bus must have been silent for t3.5:
+  *            after the last received byte, or after a timeout
+  *          - A response is complete as soon as its length (known from
+  *            the function code, 5 bytes for an exception) has arrived, it
+  *            does not wait for the t3.5 silence; a shorter response ends
+  *            after t3.5 of silence and is a frame error
+  *          - The response timeout runs from the end of the request on the
+  *            wire (queued bytes * character time), not from write()
+  *          - The driver hands bytes over in FIFO sized chunks, late by up
+  *            to a few character times; margin_ns (4 characters + 1 ms by
+  *            default) is allowed on top of the silences measured here
+  *          - In strict mode a response with a gap over t1.5 + margin
+  *            between two chunks is dropped, as the standard requires
+  *          - All deadlines are held in one timerfd, armed for the nearest;
+  *            the master sleeps in epoll between events
+  *
+  *          Request Coalescing
+  *          =======================
+  *          - Points of the same slave and table are sorted by address at
+  *            ModbusStart(); a point whose address is at most max_gap
+  *            registers (max_gap * 16 bits) after the current block joins
+  *            it, up to 125 registers or 2000 bits per request
+  *          - At 19200 baud a request/response pair costs about 13 bytes
+  *            plus two t3.5 silences and the slave's reply time, against 2
+  *            bytes per extra register, so reading a few unused registers
+  *            beats a second request
+  *          - A slave answering a joined block with exception 02 (illegal
+  *            data address, unmapped registers in the gap) gets the block
+  *            split back into one request per point
+  *
+  *          Scheduling
+  *          =======================
+  *          - Each block is due every interval_ms of its slave; the bus is
+  *            given to the queued writes first, then to the block that
+  *            has been due the longest
+  *          - A block that could not be polled in time is not polled
+  *            twice to catch up
+  *          - Timeouts, CRC and frame errors are retried retries times;
+  *            after MODBUS_OFFLINE_AFTER failed polls a slave is offline
+  *            and polled once every MODBUS_OFFLINE_MS without retries, so a
+  *            dead slave does not take the line from the others
+  *          - The callback reports every polled point and every write
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "modbus_rtu.h" in your application
+  *            - Open the port with UARTOpen() and set the format, usually
+  *              UARTSetFormat(port, 8, 'E', 1)
+  *            - Create the master, add slaves, then points, then start
+  *            - Call ModbusPoll() in the event loop
+  *            - Compile with: gcc -O2 uart.c uart_framing.c modbus_rtu.c your_app.c
+  *
+  *          Example Usage:
+  *            static void update(const Modbus_Event *ev, void *arg)
+  *            {
+  *                Modbus_Master *m = arg;
+  *                if (MODBUS_EVENT_POINT == ev->type && MODBUS_OK == ev->status)
+  *                    printf("%d\n", ModbusPoint(m, ev->point)->value[0]);
+  *            }
+  *
+  *            UART_Port *port = UARTOpen("/dev/ttySC3", 19200, 0, 0);
+  *            UARTSetFormat(port, 8, 'E', 1);
+  *            m = ModbusCreate(port, update, NULL);
+  *            m->arg = m;
+  *            ModbusAddSlave(m, 1, 500, 100, 1);          // every 500 ms
+  *            ModbusAddPoint(m, 1, MODBUS_HOLDING, 0, 2);
+  *            ModbusAddPoint(m, 1, MODBUS_HOLDING, 4, 1);  // same request
+  *            ModbusStart(m);
+  *            while (ModbusPoll(m, -1) >= 0)
+  *                ;
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include "modbus_rtu.h"
+#include "uart_framing.h"
+
+#define MODBUS_IDLE		0	/* nothing on the bus */
+#define MODBUS_WAIT		1	/* request sent, response pending */
+#define MODBUS_SILENCE		2	/* waiting for t3.5 before the next request */
+
+#define MODBUS_WRITE_TIMEOUT_MS	1000	/* writes to slaves that are not polled */
+
+static int64_t
+ModbusNow(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+static int
+ModbusIsBits(int table)
+{
+	return(MODBUS_COILS == table || MODBUS_DISCRETE == table);
+}
+
+static int
+ModbusSlaveIndex(const Modbus_Master *m, int id)
+{
+	int i;
+
+	for (i = 0; i < m->num_slaves; i++) {
+		if (m->slaves[i].id == id)
+			return(i);
+	}
+
+	return(-1);
+}
+
+/* builds the ADU: unit id, function, body, CRC low byte first */
+static void
+ModbusRequest(Modbus_Master *m, int id, int function, const uint8_t *body, int len)
+{
+	uint16_t crc;
+
+	m->req[0] = (uint8_t)id;
+	m->req[1] = (uint8_t)function;
+	memcpy(m->req + 2, body, len);
+	crc = UARTCrc16(UART_CRC16_INIT, m->req, 2 + len);
+	m->req[2 + len] = crc & 0xFF;
+	m->req[3 + len] = crc >> 8;
+	m->req_len = 4 + len;
+}
+
+static void
+ModbusRequestBlock(Modbus_Master *m, const Modbus_Block *b)
+{
+	uint8_t body[4];
+
+	body[0] = b->address >> 8;
+	body[1] = b->address & 0xFF;
+	body[2] = b->count >> 8;
+	body[3] = b->count & 0xFF;
+	ModbusRequest(m, m->slaves[b->slave].id, b->table, body, 4);
+}
+
+static void
+ModbusRequestWrite(Modbus_Master *m, const Modbus_Write *w)
+{
+	uint8_t body[5 + 2 * MODBUS_WRITE_REGS_MAX];
+	int len = 4;
+	int i;
+
+	body[0] = w->address >> 8;
+	body[1] = w->address & 0xFF;
+	if (16 == w->function) {
+		body[2] = w->count >> 8;
+		body[3] = w->count & 0xFF;
+		body[4] = 2 * w->count;
+		for (i = 0; i < w->count; i++) {
+			body[5 + 2 * i] = w->value[i] >> 8;
+			body[6 + 2 * i] = w->value[i] & 0xFF;
+		}
+		len = 5 + 2 * w->count;
+	} else {
+		body[2] = w->value[0] >> 8;
+		body[3] = w->value[0] & 0xFF;
+	}
+
+	ModbusRequest(m, w->slave, w->function, body, len);
+}
+
+/* length of the response to the request in req[] */
+static int
+ModbusExpected(const Modbus_Master *m)
+{
+	int count = (m->req[4] << 8) | m->req[5];
+
+	if (m->rsp_len >= 2 && (m->rsp[1] & 0x80))
+		return(5);
+
+	switch (m->req[1]) {
+	case 1:
+	case 2:
+		return(5 + (count + 7) / 8);
+	case 3:
+	case 4:
+		return(5 + 2 * count);
+	default:
+		return(8);
+	}
+}
+
+/* checks the response against the request */
+static int
+ModbusParse(const Modbus_Master *m)
+{
+	if (m->broken || m->rsp_len < 5)
+		return(MODBUS_ERR_FRAME);
+
+	if (0 != UARTCrc16(UART_CRC16_INIT, m->rsp, m->rsp_len))
+		return(MODBUS_ERR_CRC);
+
+	if (m->rsp[0] != m->req[0])
+		return(MODBUS_ERR_FRAME);
+
+	if (m->rsp[1] == (m->req[1] | 0x80))
+		return(m->rsp[2] ? m->rsp[2] : MODBUS_ERR_FRAME);
+
+	if (m->rsp[1] != m->req[1] || m->rsp_len != ModbusExpected(m))
+		return(MODBUS_ERR_FRAME);
+
+	/* reads carry a byte count, writes echo address and count / value */
+	if (m->req[1] <= 4) {
+		if (m->rsp[2] != m->rsp_len - 5)
+			return(MODBUS_ERR_FRAME);
+	} else if (memcmp(m->rsp + 2, m->req + 2, 4)) {
+		return(MODBUS_ERR_FRAME);
+	}
+
+	return(MODBUS_OK);
+}
+
+/* one request per point of a block the slave refused as a whole */
+static void
+ModbusSplit(Modbus_Master *m, int block)
+{
+	Modbus_Block *b = &m->blocks[block];
+	Modbus_Block *n;
+	Modbus_Point *p;
+	int i;
+
+	for (i = b->num_points - 1; i >= 0; i--) {
+		p = &m->points[m->order[b->first + i]];
+		n = (0 == i) ? b : &m->blocks[m->num_blocks++];
+		*n = *b;
+		n->address = p->address;
+		n->count = p->count;
+		n->first = b->first + i;
+		n->num_points = 1;
+	}
+}
+
+static void
+ModbusReport(Modbus_Master *m, int type, int point, int id, int address, int status)
+{
+	Modbus_Event ev;
+
+	if (NULL == m->callback)
+		return;
+
+	ev.type = type;
+	ev.point = point;
+	ev.slave = id;
+	ev.address = address;
+	ev.status = status;
+	m->callback(&ev, m->arg);
+}
+
+static void
+ModbusCompleteBlock(Modbus_Master *m, int status, int64_t now)
+{
+	Modbus_Block *b = &m->blocks[m->block];
+	Modbus_Slave *s = &m->slaves[b->slave];
+	const uint8_t *data = m->rsp + 3;
+	Modbus_Point *p;
+	int offset;
+	int i;
+	int k;
+
+	if (MODBUS_OK == status || status > 0) {
+		s->failures = 0;
+		s->online = 1;
+	} else if (++s->failures >= MODBUS_OFFLINE_AFTER) {
+		s->online = 0;
+	}
+
+	for (i = 0; i < b->num_points; i++) {
+		p = &m->points[m->order[b->first + i]];
+		p->status = status;
+		if (MODBUS_OK == status) {
+			offset = p->address - b->address;
+			for (k = 0; k < p->count; k++) {
+				if (ModbusIsBits(b->table))
+					p->value[k] = (data[(offset + k) / 8] >> ((offset + k) % 8)) & 1;
+				else
+					p->value[k] = (data[2 * (offset + k)] << 8) | data[2 * (offset + k) + 1];
+			}
+			p->updated_ns = now;
+		}
+		ModbusReport(m, MODBUS_EVENT_POINT, m->order[b->first + i], s->id, p->address, status);
+	}
+
+	if (2 == status && b->num_points > 1)
+		ModbusSplit(m, m->block);
+
+	if (!s->online) {
+		b->due_ns = now + MODBUS_OFFLINE_MS * 1000000LL;
+	} else {
+		/* keep the period, but never queue up polls to catch up */
+		b->due_ns += s->interval_ms * 1000000LL;
+		if (b->due_ns < now)
+			b->due_ns = now;
+	}
+}
+
+/* the current transaction ended with status: retry or report it */
+static void
+ModbusFinish(Modbus_Master *m, int status, int64_t now)
+{
+	Modbus_Write *w;
+	Modbus_Slave *s = NULL;
+	int retries = 0;
+	int idx;
+
+	idx = (m->block >= 0) ? m->blocks[m->block].slave : ModbusSlaveIndex(m, m->req[0]);
+	if (idx >= 0) {
+		s = &m->slaves[idx];
+		retries = s->online ? s->retries : 0;
+		if (MODBUS_OK == status)
+			s->stats.responses++;
+		else if (MODBUS_ERR_TIMEOUT == status)
+			s->stats.timeouts++;
+		else if (MODBUS_ERR_CRC == status)
+			s->stats.crc_errors++;
+		else if (MODBUS_ERR_FRAME == status)
+			s->stats.frame_errors++;
+		else
+			s->stats.exceptions++;
+	}
+
+	/* the bus is free t3.5 after the last byte seen on it */
+	m->state = MODBUS_SILENCE;
+	m->idle_ns = ((m->rsp_len > 0) ? m->last_rx_ns : now) + m->t35_ns;
+
+	if (status < 0 && m->attempt < retries) {
+		m->attempt++;
+		return;
+	}
+
+	if (m->block >= 0) {
+		ModbusCompleteBlock(m, status, now);
+	} else {
+		w = &m->writes[m->write_tail % MODBUS_WRITES_MAX];
+		ModbusReport(m, MODBUS_EVENT_WRITE, -1, w->slave, w->address, status);
+		m->write_tail++;
+	}
+
+	m->req_len = 0;
+}
+
+static void
+ModbusSend(Modbus_Master *m, int64_t now)
+{
+	int64_t tx_end;
+	int timeout_ms = MODBUS_WRITE_TIMEOUT_MS;
+	int idx;
+
+	if (UARTWrite(m->port, m->req, m->req_len) != m->req_len) {
+		fprintf(stderr, "Failed to queue Modbus request!\n");
+		ModbusFinish(m, MODBUS_ERR_FRAME, now);
+		return;
+	}
+
+	tx_end = now + (int64_t)UARTOutQueue(m->port) * m->char_ns;
+	m->rsp_len = 0;
+	m->broken = 0;
+
+	/* nobody answers a broadcast, give the slaves time to carry it out */
+	if (0 == m->req[0]) {
+		m->state = MODBUS_SILENCE;
+		m->idle_ns = tx_end + MODBUS_TURNAROUND_MS * 1000000LL;
+		ModbusReport(m, MODBUS_EVENT_WRITE, -1, 0, m->writes[m->write_tail % MODBUS_WRITES_MAX].address,
+			     MODBUS_OK);
+		m->write_tail++;
+		m->req_len = 0;
+		return;
+	}
+
+	idx = ModbusSlaveIndex(m, m->req[0]);
+	if (idx >= 0) {
+		m->slaves[idx].stats.requests++;
+		timeout_ms = m->slaves[idx].timeout_ms;
+	}
+
+	m->state = MODBUS_WAIT;
+	m->deadline_ns = tx_end + timeout_ms * 1000000LL;
+}
+
+/* starts the next transaction: a retry, a queued write or the most overdue block */
+static int
+ModbusNext(Modbus_Master *m, int64_t now)
+{
+	int best = -1;
+	int i;
+
+	if (m->req_len > 0) {
+		ModbusSend(m, now);
+		return(1);
+	}
+
+	if (m->write_head != m->write_tail) {
+		m->block = -1;
+		m->attempt = 0;
+		ModbusRequestWrite(m, &m->writes[m->write_tail % MODBUS_WRITES_MAX]);
+		ModbusSend(m, now);
+		return(1);
+	}
+
+	for (i = 0; i < m->num_blocks; i++) {
+		if (m->blocks[i].due_ns <= now && (-1 == best || m->blocks[i].due_ns < m->blocks[best].due_ns))
+			best = i;
+	}
+	if (-1 == best)
+		return(0);
+
+	m->block = best;
+	m->attempt = 0;
+	ModbusRequestBlock(m, &m->blocks[best]);
+	ModbusSend(m, now);
+	return(1);
+}
+
+/* reads response bytes, never past the end of the expected frame */
+static int
+ModbusReceive(Modbus_Master *m, int64_t now)
+{
+	ssize_t n;
+	int need;
+
+	while (1) {
+		need = (m->rsp_len < 2) ? 2 : ModbusExpected(m);
+		if (m->rsp_len >= need)
+			break;
+
+		n = UARTRead(m->port, m->rsp + m->rsp_len, need - m->rsp_len);
+		if (n <= 0)
+			break;
+
+		if (m->strict && m->rsp_len > 0 && now - m->last_rx_ns > m->t15_ns + m->margin_ns)
+			m->broken = 1;
+		m->rsp_len += n;
+		m->last_rx_ns = now;
+	}
+
+	if (m->rsp_len >= 2 && m->rsp_len >= ModbusExpected(m)) {
+		ModbusFinish(m, ModbusParse(m), now);
+		return(1);
+	}
+
+	if (m->rsp_len > 0 && now >= m->last_rx_ns + m->t35_ns + m->margin_ns) {
+		ModbusFinish(m, ModbusParse(m), now);
+		return(1);
+	}
+
+	if (0 == m->rsp_len && now >= m->deadline_ns) {
+		ModbusFinish(m, MODBUS_ERR_TIMEOUT, now);
+		return(1);
+	}
+
+	return(0);
+}
+
+/* drops bytes received while no response is expected, 1 if there were any */
+static int
+ModbusDiscard(Modbus_Master *m)
+{
+	uint8_t junk[64];
+	ssize_t n;
+	int got = 0;
+
+	while ((n = UARTRead(m->port, junk, sizeof(junk))) > 0) {
+		m->noise += n;
+		got = 1;
+	}
+
+	return(got);
+}
+
+static void
+ModbusArm(Modbus_Master *m)
+{
+	struct itimerspec its;
+	int64_t next = 0;
+	int i;
+
+	if (MODBUS_WAIT == m->state) {
+		next = m->rsp_len ? m->last_rx_ns + m->t35_ns + m->margin_ns : m->deadline_ns;
+	} else if (MODBUS_SILENCE == m->state) {
+		next = m->idle_ns;
+	} else {
+		for (i = 0; i < m->num_blocks; i++) {
+			if (0 == next || m->blocks[i].due_ns < next)
+				next = m->blocks[i].due_ns;
+		}
+	}
+
+	/* 0 disarms; an expired absolute time fires at once */
+	memset(&its, 0, sizeof(its));
+	if (next > 0) {
+		its.it_value.tv_sec = next / 1000000000LL;
+		its.it_value.tv_nsec = next % 1000000000LL;
+	}
+	timerfd_settime(m->tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+/* runs the state machine as far as it goes now, returns completed transactions */
+static int
+ModbusRun(Modbus_Master *m)
+{
+	int done = 0;
+	int64_t now;
+	int progress = 1;
+
+	while (progress) {
+		progress = 0;
+		now = ModbusNow();
+
+		switch (m->state) {
+		case MODBUS_WAIT:
+			if (ModbusReceive(m, now)) {
+				done++;
+				progress = 1;
+			}
+			break;
+		case MODBUS_SILENCE:
+			if (ModbusDiscard(m))
+				m->idle_ns = now + m->t35_ns;
+			if (now >= m->idle_ns) {
+				m->state = MODBUS_IDLE;
+				progress = 1;
+			}
+			break;
+		default:
+			ModbusDiscard(m);
+			progress = ModbusNext(m, now);
+			break;
+		}
+	}
+
+	ModbusArm(m);
+	return(done);
+}
+
+/**
+  * @brief  Creates a master on an open, configured port.
+  * @param  port: serial port, used by the master only
+  * @param  callback: called for every polled point and finished write, may be NULL
+  * @param  arg: passed to the callback
+  * @retval Master, NULL on error
+  */
+Modbus_Master *
+ModbusCreate(UART_Port *port, Modbus_Callback callback, void *arg)
+{
+	struct epoll_event ev;
+	struct termios tio;
+	Modbus_Master *m;
+	int bits;
+
+	if (NULL == port || tcgetattr(port->fd, &tio)) {
+		fprintf(stderr, "Invalid Modbus port!\n");
+		return(NULL);
+	}
+
+	m = calloc(1, sizeof(*m));
+	if (NULL == m)
+		return(NULL);
+
+	m->port = port;
+	m->callback = callback;
+	m->arg = arg;
+	m->max_gap = MODBUS_GAP_DEFAULT;
+	m->block = -1;
+
+	/* start + 8 data + parity + stop bits, RTU has no 7 bit mode */
+	bits = 1 + 8 + ((tio.c_cflag & PARENB) ? 1 : 0) + ((tio.c_cflag & CSTOPB) ? 2 : 1);
+	m->char_ns = (int64_t)bits * 1000000000LL / port->baud;
+	if (port->baud <= 19200) {
+		m->t15_ns = m->char_ns * 3 / 2;
+		m->t35_ns = m->char_ns * 7 / 2;
+	} else {
+		m->t15_ns = 750000;
+		m->t35_ns = 1750000;
+	}
+	m->margin_ns = 4 * m->char_ns + 1000000;
+
+	m->epfd = epoll_create1(EPOLL_CLOEXEC);
+	m->tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (-1 == m->epfd || -1 == m->tfd) {
+		fprintf(stderr, "Failed to create Modbus timer!\n");
+		ModbusDestroy(m);
+		return(NULL);
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = m->tfd;
+	epoll_ctl(m->epfd, EPOLL_CTL_ADD, m->tfd, &ev);
+	ev.data.fd = UARTFd(port);
+	epoll_ctl(m->epfd, EPOLL_CTL_ADD, UARTFd(port), &ev);
+
+	/* whatever is on the line now, wait for t3.5 of silence first */
+	m->state = MODBUS_SILENCE;
+	m->idle_ns = ModbusNow() + m->t35_ns;
+	return(m);
+}
+
+/**
+  * @brief  Adjusts the frame timing.
+  * @param  m: master
+  * @param  margin_us: delivery latency allowed on top of t1.5 / t3.5, -1 keeps it
+  * @param  strict: 1 drops responses with a gap over t1.5 + margin
+  */
+int
+ModbusSetTiming(Modbus_Master *m, int margin_us, int strict)
+{
+	if (NULL == m)
+		return(-1);
+
+	if (margin_us >= 0)
+		m->margin_ns = margin_us * 1000LL;
+	m->strict = strict;
+	return(0);
+}
+
+/**
+  * @brief  Sets how many unused registers may be read to join two points.
+  * @param  max_gap: 0 joins only adjacent points, -1 never joins
+  */
+int
+ModbusSetGap(Modbus_Master *m, int max_gap)
+{
+	if (NULL == m || m->num_blocks > 0)
+		return(-1);
+
+	m->max_gap = max_gap;
+	return(0);
+}
+
+/**
+  * @brief  Adds a slave to poll, or updates it.
+  * @param  m: master
+  * @param  id: unit id 1-247
+  * @param  interval_ms: poll period of its points
+  * @param  timeout_ms: response timeout
+  * @param  retries: extra attempts on timeout or a bad response
+  * @retval 0 on success, -1 on error
+  */
+int
+ModbusAddSlave(Modbus_Master *m, int id, int interval_ms, int timeout_ms, int retries)
+{
+	Modbus_Slave *s;
+	int idx;
+
+	if (NULL == m || id < 1 || id > 247 || interval_ms < 1 || timeout_ms < 1 || retries < 0) {
+		fprintf(stderr, "Invalid Modbus slave!\n");
+		return(-1);
+	}
+
+	idx = ModbusSlaveIndex(m, id);
+	if (-1 == idx) {
+		if (MODBUS_SLAVES_MAX == m->num_slaves) {
+			fprintf(stderr, "Too many Modbus slaves!\n");
+			return(-1);
+		}
+		idx = m->num_slaves++;
+		m->slaves[idx].online = 1;
+	}
+
+	s = &m->slaves[idx];
+	s->id = id;
+	s->interval_ms = interval_ms;
+	s->timeout_ms = timeout_ms;
+	s->retries = retries;
+	return(0);
+}
+
+/**
+  * @brief  Adds registers or bits of a slave to poll.
+  * @param  m: master, not started yet
+  * @param  id: unit id, added with ModbusAddSlave()
+  * @param  table: MODBUS_COILS, MODBUS_DISCRETE, MODBUS_HOLDING or MODBUS_INPUT
+  * @param  address: first register or bit, 0 based
+  * @param  count: number of registers or bits
+  * @retval Point index, -1 on error
+  */
+int
+ModbusAddPoint(Modbus_Master *m, int id, int table, int address, int count)
+{
+	Modbus_Point *p;
+	int limit;
+	int idx;
+
+	if (NULL == m || m->num_blocks > 0) {
+		fprintf(stderr, "Modbus points must be added before ModbusStart()!\n");
+		return(-1);
+	}
+
+	idx = ModbusSlaveIndex(m, id);
+	limit = ModbusIsBits(table) ? MODBUS_BITS_MAX : MODBUS_REGS_MAX;
+	if (-1 == idx || table < MODBUS_COILS || table > MODBUS_INPUT || address < 0 ||
+	    count < 1 || count > limit || address + count > 65536) {
+		fprintf(stderr, "Invalid Modbus point!\n");
+		return(-1);
+	}
+
+	if (MODBUS_POINTS_MAX == m->num_points || m->num_values + count > MODBUS_VALUES_MAX) {
+		fprintf(stderr, "Too many Modbus points!\n");
+		return(-1);
+	}
+
+	p = &m->points[m->num_points];
+	p->slave = idx;
+	p->table = table;
+	p->address = address;
+	p->count = count;
+	p->value = m->values + m->num_values;
+	p->status = MODBUS_ERR_TIMEOUT;
+	m->num_values += count;
+
+	return(m->num_points++);
+}
+
+static int
+ModbusPointBefore(const Modbus_Point *a, const Modbus_Point *b)
+{
+	if (a->slave != b->slave)
+		return(a->slave < b->slave);
+	if (a->table != b->table)
+		return(a->table < b->table);
+	return(a->address < b->address);
+}
+
+/**
+  * @brief  Joins the points into poll blocks and starts polling.
+  * @retval Number of requests per round, -1 on error
+  */
+int
+ModbusStart(Modbus_Master *m)
+{
+	const Modbus_Point *p;
+	Modbus_Block *b = NULL;
+	int64_t now = ModbusNow();
+	int limit;
+	int gap;
+	int end;
+	int i;
+	int k;
+
+	if (NULL == m || 0 == m->num_points || m->num_blocks > 0)
+		return(-1);
+
+	for (i = 0; i < m->num_points; i++) {
+		for (k = i; k > 0 && ModbusPointBefore(&m->points[i], &m->points[m->order[k - 1]]); k--)
+			m->order[k] = m->order[k - 1];
+		m->order[k] = i;
+	}
+
+	for (i = 0; i < m->num_points; i++) {
+		p = &m->points[m->order[i]];
+		limit = ModbusIsBits(p->table) ? MODBUS_BITS_MAX : MODBUS_REGS_MAX;
+		gap = ModbusIsBits(p->table) ? m->max_gap * 16 : m->max_gap;
+
+		if (NULL != b && b->slave == p->slave && b->table == p->table && m->max_gap >= 0) {
+			end = p->address + p->count;
+			if (end < b->address + b->count)
+				end = b->address + b->count;
+			if (p->address - (b->address + b->count) <= gap && end - b->address <= limit) {
+				b->count = end - b->address;
+				b->num_points++;
+				continue;
+			}
+		}
+
+		b = &m->blocks[m->num_blocks++];
+		b->slave = p->slave;
+		b->table = p->table;
+		b->address = p->address;
+		b->count = p->count;
+		b->first = i;
+		b->num_points = 1;
+		b->due_ns = now;
+	}
+
+	ModbusRun(m);
+	return(m->num_blocks);
+}
+
+/**
+  * @brief  Waits for the line or the next deadline and advances the master.
+  * @param  m: master
+  * @param  timeout_ms: -1 waits for the next event, 0 only does pending work
+  * @retval Transactions finished in this call, -1 on error
+  */
+int
+ModbusPoll(Modbus_Master *m, int timeout_ms)
+{
+	struct epoll_event ev[2];
+	uint64_t expirations;
+	int n;
+	int i;
+
+	if (NULL == m)
+		return(-1);
+
+	n = epoll_wait(m->epfd, ev, 2, timeout_ms);
+	if (-1 == n && EINTR != errno) {
+		fprintf(stderr, "Failed to wait for Modbus events!\n");
+		return(-1);
+	}
+
+	for (i = 0; i < n; i++) {
+		if (ev[i].data.fd == m->tfd) {
+			if (read(m->tfd, &expirations, sizeof(expirations)) < 0 && EAGAIN != errno)
+				return(-1);
+		} else if (UARTPoll(m->port, 0) < 0) {
+			return(-1);
+		}
+	}
+
+	return(ModbusRun(m));
+}
+
+static int
+ModbusQueueWrite(Modbus_Master *m, int id, int function, int address, int count,
+		 const uint16_t *values)
+{
+	Modbus_Write *w;
+
+	if (m->write_head - m->write_tail == MODBUS_WRITES_MAX) {
+		fprintf(stderr, "Modbus write queue full!\n");
+		return(-1);
+	}
+
+	w = &m->writes[m->write_head % MODBUS_WRITES_MAX];
+	w->slave = id;
+	w->function = function;
+	w->address = address;
+	w->count = count;
+	memcpy(w->value, values, count * sizeof(*values));
+	m->write_head++;
+
+	/* an idle bus takes it right away, the entry is complete by now */
+	if (MODBUS_IDLE == m->state)
+		ModbusRun(m);
+	return(0);
+}
+
+/**
+  * @brief  Queues a register write: function 06 for one register, 16 for more.
+  * @param  m: master
+  * @param  id: unit id, 0 to broadcast
+  * @param  address: first register
+  * @param  count: 1 to 123 registers
+  * @param  values: register values
+  * @retval 0 if queued, -1 if the queue is full or on invalid arguments
+  */
+int
+ModbusWrite(Modbus_Master *m, int id, int address, int count, const uint16_t *values)
+{
+	if (NULL == m || NULL == values || id < 0 || id > 247 || address < 0 ||
+	    count < 1 || count > MODBUS_WRITE_REGS_MAX || address + count > 65536)
+		return(-1);
+
+	return(ModbusQueueWrite(m, id, (1 == count) ? 6 : 16, address, count, values));
+}
+
+/**
+  * @brief  Queues a single coil write (function 05).
+  */
+int
+ModbusWriteCoil(Modbus_Master *m, int id, int address, int on)
+{
+	uint16_t value = on ? 0xFF00 : 0x0000;
+
+	if (NULL == m || id < 0 || id > 247 || address < 0 || address > 65535)
+		return(-1);
+
+	return(ModbusQueueWrite(m, id, 5, address, 1, &value));
+}
+
+const Modbus_Point *
+ModbusPoint(const Modbus_Master *m, int point)
+{
+	if (NULL == m || point < 0 || point >= m->num_points)
+		return(NULL);
+
+	return(&m->points[point]);
+}
+
+/**
+  * @brief  epoll fd of the master, readable when ModbusPoll() has work.
+  */
+int
+ModbusFd(const Modbus_Master *m)
+{
+	return(NULL != m ? m->epfd : -1);
+}
+
+void
+ModbusDestroy(Modbus_Master *m)
+{
+	if (NULL == m)
+		return;
+
+	if (m->epfd >= 0)
+		close(m->epfd);
+	if (m->tfd >= 0)
+		close(m->tfd);
+	free(m);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
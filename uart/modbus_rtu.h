@@ -0,0 +1,169 @@
+/**
+  ******************************************************************************
+  * @file    modbus_rtu.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the Modbus
+  *          RTU master.
+  *
+  * @details Provides the following functionality:
+  *          - t1.5 / t3.5 frame timing with timerfd
+  *          - CRC-16 checked requests and responses
+  *          - Adjacent points read with a single request
+  *          - Per-slave poll intervals, timeouts and retries
+  *          - Queued register and coil writes
+  ******************************************************************************
+  * @defgroup Modbus_RTU Modbus RTU Master
+  * @brief Slaves, points, poll blocks and master state
+  * @{
+  */
+
+#ifndef __MODBUS_RTU_H
+#define __MODBUS_RTU_H
+
+#include <stdint.h>
+#include "uart.h"
+
+#define MODBUS_COILS		1	/* read with function 01 */
+#define MODBUS_DISCRETE		2	/* 02 */
+#define MODBUS_HOLDING		3	/* 03 */
+#define MODBUS_INPUT		4	/* 04 */
+
+#define MODBUS_SLAVES_MAX	32
+#define MODBUS_POINTS_MAX	256
+#define MODBUS_VALUES_MAX	4096	/* registers / bits over all points */
+#define MODBUS_WRITES_MAX	16	/* queued writes */
+#define MODBUS_ADU_MAX		256
+#define MODBUS_REGS_MAX		125	/* registers per read */
+#define MODBUS_BITS_MAX		2000	/* coils / inputs per read */
+#define MODBUS_WRITE_REGS_MAX	123	/* registers per write */
+#define MODBUS_GAP_DEFAULT	8	/* unused registers read to join two points */
+#define MODBUS_OFFLINE_AFTER	3	/* failed polls before a slave is offline */
+#define MODBUS_OFFLINE_MS	5000	/* poll interval of an offline slave */
+#define MODBUS_TURNAROUND_MS	100	/* delay after a broadcast */
+
+/* status of a transaction: 0, a negative error or a Modbus exception code */
+#define MODBUS_OK		0
+#define MODBUS_ERR_TIMEOUT	-1
+#define MODBUS_ERR_CRC		-2
+#define MODBUS_ERR_FRAME	-3	/* short, gapped or mismatching response */
+
+#define MODBUS_EVENT_POINT	0	/* a point was polled */
+#define MODBUS_EVENT_WRITE	1	/* a queued write completed */
+
+typedef struct {
+	int type;		/* MODBUS_EVENT_* */
+	int point;		/* index from ModbusAddPoint(), -1 for writes */
+	int slave;		/* unit id */
+	int address;
+	int status;		/* MODBUS_OK, MODBUS_ERR_* or exception code */
+} Modbus_Event;
+
+typedef void (*Modbus_Callback)(const Modbus_Event *ev, void *arg);
+
+typedef struct {
+	uint64_t requests;
+	uint64_t responses;
+	uint64_t timeouts;
+	uint64_t crc_errors;
+	uint64_t frame_errors;
+	uint64_t exceptions;
+} Modbus_SlaveStats;
+
+typedef struct {
+	int id;			/* unit id 1-247 */
+	int interval_ms;	/* poll period of its points */
+	int timeout_ms;		/* response timeout after the request is sent */
+	int retries;		/* extra attempts per poll */
+	int failures;		/* consecutive failed polls */
+	int online;
+	Modbus_SlaveStats stats;
+} Modbus_Slave;
+
+typedef struct {
+	int slave;		/* index in slaves[] */
+	int table;		/* MODBUS_COILS ... MODBUS_INPUT */
+	int address;		/* first register or bit, 0 based */
+	int count;
+	uint16_t *value;	/* count values, bits as 0 / 1 */
+	int status;		/* of the last poll */
+	int64_t updated_ns;	/* CLOCK_MONOTONIC of the last good poll */
+} Modbus_Point;
+
+typedef struct {
+	int slave;		/* index in slaves[] */
+	int table;
+	int address;
+	int count;		/* registers or bits read, gaps included */
+	int first;		/* first entry of order[] */
+	int num_points;
+	int64_t due_ns;
+} Modbus_Block;
+
+typedef struct {
+	int slave;		/* unit id, 0 for broadcast */
+	int function;		/* 05, 06 or 16 */
+	int address;
+	int count;
+	uint16_t value[MODBUS_WRITE_REGS_MAX];
+} Modbus_Write;
+
+typedef struct {
+	UART_Port *port;
+	int epfd;		/* port and timer */
+	int tfd;		/* timerfd, armed for the next deadline */
+	int64_t char_ns;	/* one character on the line */
+	int64_t t15_ns;
+	int64_t t35_ns;
+	int64_t margin_ns;	/* driver delivery latency allowed on top of the gaps */
+	int max_gap;
+	int strict;		/* drop responses with a gap over t1.5 */
+
+	int state;
+	int64_t idle_ns;	/* bus free from (turnaround) */
+	int64_t deadline_ns;	/* response timeout */
+	int64_t last_rx_ns;
+	int block;		/* polled block, -1 for a write */
+	int attempt;
+	int broken;		/* t1.5 exceeded inside the response */
+	uint8_t req[MODBUS_ADU_MAX];
+	int req_len;
+	uint8_t rsp[MODBUS_ADU_MAX];
+	int rsp_len;
+	uint64_t noise;		/* bytes received outside a response */
+
+	int num_slaves;
+	Modbus_Slave slaves[MODBUS_SLAVES_MAX];
+	int num_points;
+	Modbus_Point points[MODBUS_POINTS_MAX];
+	int num_values;
+	uint16_t values[MODBUS_VALUES_MAX];
+	int num_blocks;
+	Modbus_Block blocks[MODBUS_POINTS_MAX];
+	int order[MODBUS_POINTS_MAX];	/* points sorted by slave, table, address */
+	uint32_t write_head;
+	uint32_t write_tail;
+	Modbus_Write writes[MODBUS_WRITES_MAX];
+
+	Modbus_Callback callback;
+	void *arg;
+} Modbus_Master;
+
+/** @} */
+
+extern Modbus_Master *ModbusCreate(UART_Port *port, Modbus_Callback callback, void *arg);
+extern int ModbusSetTiming(Modbus_Master *m, int margin_us, int strict);
+extern int ModbusSetGap(Modbus_Master *m, int max_gap);
+extern int ModbusAddSlave(Modbus_Master *m, int id, int interval_ms, int timeout_ms, int retries);
+extern int ModbusAddPoint(Modbus_Master *m, int id, int table, int address, int count);
+extern int ModbusStart(Modbus_Master *m);
+extern int ModbusPoll(Modbus_Master *m, int timeout_ms);
+extern int ModbusWrite(Modbus_Master *m, int id, int address, int count, const uint16_t *values);
+extern int ModbusWriteCoil(Modbus_Master *m, int id, int address, int on);
+extern const Modbus_Point *ModbusPoint(const Modbus_Master *m, int point);
+extern int ModbusFd(const Modbus_Master *m);
+extern void ModbusDestroy(Modbus_Master *m);
+
+
+#endif /*__MODBUS_RTU_H */
@@ -0,0 +1,711 @@
+/**
+  ******************************************************************************
+  * @file    uart.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides an event driven, non-blocking UART engine:
+  *           - Raw serial port setup with device and baud rate chosen at
+  *             run time
+  *           - epoll driven reception into an RX ring buffer
+  *           - TX queueing, sent with writev() as the port accepts it
+  *           - Zero-copy access to the received bytes
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the UART Engine
+  *          ===================================================================
+  *
+  *          Port Setup
+  *          =====================
+  *          - The port is opened O_NONBLOCK | O_NOCTTY and set to raw 8N1,
+  *            no flow control, no echo, no line processing
+  *          - Baud rate and frame format can be changed at run time with
+  *            UARTSetBaud() / UARTSetFormat(); the original settings are
+  *            restored on close
+  *          - Stale input is discarded once at open; nothing is ever flushed
+  *            on the data path, queued bytes are always sent
+  *
+  *          Reception
+  *          =======================
+  *          - UARTPoll() waits in epoll_wait() and, when the port is
+  *            readable, moves everything the driver holds into the RX ring
+  *            with readv() on the (at most two) free segments of the ring
+  *          - A short read means the driver is empty, so a burst costs one
+  *            syscall and no EAGAIN round trip
+  *          - If the RX ring fills up, the port is taken out of the epoll
+  *            set until the application reads; the driver's own buffer then
+  *            holds the line for a while (counted in rx_full)
+  *          - UARTRead() copies out, UARTRxPeek()/UARTRxConsume() give
+  *            direct access to the ring for parsers
+  *
+  *          Transmission
+  *          =======================
+  *          - UARTWrite() writes straight to the port while nothing is
+  *            queued; what the driver does not take is queued in the TX
+  *            ring and EPOLLOUT is armed
+  *          - On EPOLLOUT the queued bytes go out with one writev() of the
+  *            ring segments; EPOLLOUT is disarmed once the ring is empty
+  *          - UARTWrite() never blocks and never drops part of a queued
+  *            message: it returns how many bytes it accepted
+  *
+  *          Event Loop
+  *          =======================
+  *          - Each port has its own epoll fd; UARTFd() returns it so the
+  *            port can sit in the application's epoll or poll() set, then
+  *            UARTPoll(port, 0) does the I/O when it is readable
+  *          - Reception and transmission are handled in the same call, the
+  *            port runs full duplex from a single thread
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "uart.h" in your application
+  *            - Open the port with the device and baud rate
+  *            - Call UARTPoll() in the event loop, read with UARTRead(),
+  *              send with UARTWrite()
+  *            - Compile with: gcc -O2 uart.c your_app.c -o uart_app
+  *
+  *          Example Usage:
+  *            UART_Port *port = UARTOpen("/dev/ttySC3", 921600, 0, 0);
+  *            uint8_t buf[256];
+  *            ssize_t n;
+  *
+  *            while (UARTPoll(port, -1) >= 0) {
+  *                while ((n = UARTRead(port, buf, sizeof(buf))) > 0)
+  *                    UARTWrite(port, buf, n);   // echo
+  *            }
+  *            UARTClose(port);
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/serial.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include "uart.h"
+
+static const struct {
+	int baud;
+	speed_t speed;
+} s_bauds[] = {
+	{ 1200, B1200 }, { 2400, B2400 }, { 4800, B4800 }, { 9600, B9600 },
+	{ 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 }, { 115200, B115200 },
+	{ 230400, B230400 }, { 460800, B460800 }, { 500000, B500000 },
+	{ 576000, B576000 }, { 921600, B921600 }, { 1000000, B1000000 },
+	{ 1152000, B1152000 }, { 1500000, B1500000 }, { 2000000, B2000000 },
+	{ 2500000, B2500000 }, { 3000000, B3000000 }, { 3500000, B3500000 },
+	{ 4000000, B4000000 },
+};
+
+static speed_t
+UARTSpeed(int baud)
+{
+	size_t i;
+
+	for (i = 0; i < sizeof(s_bauds) / sizeof(s_bauds[0]); i++) {
+		if (s_bauds[i].baud == baud)
+			return(s_bauds[i].speed);
+	}
+
+	return(B0);
+}
+
+static int
+UARTRingInit(UART_Ring *ring, size_t size)
+{
+	uint32_t len = 2;
+
+	if (0 == size)
+		size = UART_RING_DEFAULT;
+	while (len < size && len < 0x80000000U)
+		len <<= 1;
+
+	ring->data = malloc(len);
+	if (NULL == ring->data)
+		return(-1);
+
+	ring->size = len;
+	ring->mask = len - 1;
+	ring->head = 0;
+	ring->tail = 0;
+	return(0);
+}
+
+/* fills iov with the contiguous pieces of [from, from + len) of the ring */
+static int
+UARTRingSegments(const UART_Ring *ring, uint32_t from, uint32_t len, struct iovec *iov)
+{
+	uint32_t pos = from & ring->mask;
+	uint32_t first = ring->size - pos;
+
+	if (0 == len)
+		return(0);
+
+	iov[0].iov_base = ring->data + pos;
+	if (len <= first) {
+		iov[0].iov_len = len;
+		return(1);
+	}
+
+	iov[0].iov_len = first;
+	iov[1].iov_base = ring->data;
+	iov[1].iov_len = len - first;
+	return(2);
+}
+
+/* registers the events the port can act on right now */
+static int
+UARTUpdateEvents(UART_Port *port)
+{
+	struct epoll_event ev;
+	uint32_t want = 0;
+
+	if (port->rx.head - port->rx.tail < port->rx.size)
+		want |= EPOLLIN;
+	if (port->tx.head != port->tx.tail)
+		want |= EPOLLOUT;
+
+	if (want == port->events)
+		return(0);
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = want;
+	ev.data.fd = port->fd;
+	if (epoll_ctl(port->epfd, EPOLL_CTL_MOD, port->fd, &ev)) {
+		fprintf(stderr, "Failed to update %s events!\n", port->device);
+		return(-1);
+	}
+
+	port->events = want;
+	return(0);
+}
+
+/* moves everything the driver holds into the RX ring */
+static ssize_t
+UARTReceive(UART_Port *port)
+{
+	UART_Ring *rx = &port->rx;
+	struct iovec iov[2];
+	ssize_t total = 0;
+	uint32_t room;
+	uint32_t used;
+	ssize_t n;
+	int cnt;
+
+	while (1) {
+		room = rx->size - (rx->head - rx->tail);
+		if (0 == room) {
+			port->stats.rx_full++;
+			break;
+		}
+
+		cnt = UARTRingSegments(rx, rx->head, room, iov);
+		n = readv(port->fd, iov, cnt);
+		if (n > 0) {
+			rx->head += n;
+			total += n;
+			if ((uint32_t)n < room)
+				break;
+			continue;
+		}
+
+		if (-1 == n && EINTR == errno)
+			continue;
+		if (-1 == n && (EAGAIN == errno || EWOULDBLOCK == errno))
+			break;
+
+		fprintf(stderr, "Failed to read %s, port closed!\n", port->device);
+		return(-1);
+	}
+
+	port->stats.rx_bytes += total;
+	used = rx->head - rx->tail;
+	if (used > port->stats.rx_high_water)
+		port->stats.rx_high_water = used;
+
+	return(total);
+}
+
+/* hands the TX ring to the driver as far as it takes it */
+static int
+UARTTransmit(UART_Port *port)
+{
+	UART_Ring *tx = &port->tx;
+	struct iovec iov[2];
+	uint32_t used;
+	ssize_t n;
+	int cnt;
+
+	while (tx->head != tx->tail) {
+		used = tx->head - tx->tail;
+		cnt = UARTRingSegments(tx, tx->tail, used, iov);
+		n = writev(port->fd, iov, cnt);
+		if (n > 0) {
+			tx->tail += n;
+			port->stats.tx_bytes += n;
+			if ((uint32_t)n < used)
+				break;
+			continue;
+		}
+
+		if (-1 == n && EINTR == errno)
+			continue;
+		if (-1 == n && (EAGAIN == errno || EWOULDBLOCK == errno))
+			break;
+
+		fprintf(stderr, "Failed to write %s!\n", port->device);
+		return(-1);
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Opens a serial port in raw, non-blocking mode.
+  * @param  device: e.g. "/dev/ttySC3"
+  * @param  baud: bits per second, e.g. 115200 or 921600
+  * @param  rx_size: RX ring size in bytes, 0 for UART_RING_DEFAULT
+  * @param  tx_size: TX ring size in bytes, 0 for UART_RING_DEFAULT
+  * @retval Port, NULL on error
+  */
+UART_Port *
+UARTOpen(const char *device, int baud, size_t rx_size, size_t tx_size)
+{
+	struct epoll_event ev;
+	struct termios tio;
+	UART_Port *port;
+
+	if (NULL == device || strlen(device) >= UART_DEVICE_MAX || B0 == UARTSpeed(baud)) {
+		fprintf(stderr, "Invalid serial device or baud rate!\n");
+		return(NULL);
+	}
+
+	port = calloc(1, sizeof(*port));
+	if (NULL == port)
+		return(NULL);
+
+	port->epfd = -1;
+	strcpy(port->device, device);
+	port->fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	if (-1 == port->fd) {
+		fprintf(stderr, "Failed to open %s!\n", device);
+		free(port);
+		return(NULL);
+	}
+
+	if (tcgetattr(port->fd, &port->saved)) {
+		fprintf(stderr, "%s is not a serial port!\n", device);
+		goto fail;
+	}
+
+	/* raw 8N1: no flow control, no echo, no line processing */
+	memset(&tio, 0, sizeof(tio));
+	tio.c_cflag = CS8 | CLOCAL | CREAD;
+	tio.c_cc[VMIN] = 1;
+	tio.c_cc[VTIME] = 0;
+	cfsetispeed(&tio, UARTSpeed(baud));
+	cfsetospeed(&tio, UARTSpeed(baud));
+
+	/* drop what arrived before the port was ours, the only flush */
+	tcflush(port->fd, TCIFLUSH);
+	if (tcsetattr(port->fd, TCSANOW, &tio)) {
+		fprintf(stderr, "Failed to configure %s!\n", device);
+		goto fail;
+	}
+	port->baud = baud;
+
+	if (UARTRingInit(&port->rx, rx_size) || UARTRingInit(&port->tx, tx_size))
+		goto fail;
+
+	port->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (-1 == port->epfd)
+		goto fail;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = port->fd;
+	if (epoll_ctl(port->epfd, EPOLL_CTL_ADD, port->fd, &ev))
+		goto fail;
+	port->events = EPOLLIN;
+
+	return(port);
+
+fail:
+	fprintf(stderr, "Failed to set up %s!\n", device);
+	UARTClose(port);
+	return(NULL);
+}
+
+/**
+  * @brief  Changes the baud rate, takes effect immediately.
+  * @retval 0 on success, -1 on error
+  */
+int
+UARTSetBaud(UART_Port *port, int baud)
+{
+	struct termios tio;
+	speed_t speed = UARTSpeed(baud);
+
+	if (NULL == port || B0 == speed || tcgetattr(port->fd, &tio))
+		return(-1);
+
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	if (tcsetattr(port->fd, TCSANOW, &tio)) {
+		fprintf(stderr, "Failed to set %s to %d baud!\n", port->device, baud);
+		return(-1);
+	}
+
+	port->baud = baud;
+	return(0);
+}
+
+/**
+  * @brief  Sets the character format, e.g. 8, 'E', 1 for Modbus RTU.
+  * @param  port: serial port
+  * @param  data_bits: 5 to 8
+  * @param  parity: 'N', 'E' or 'O'
+  * @param  stop_bits: 1 or 2
+  * @retval 0 on success, -1 on error
+  */
+int
+UARTSetFormat(UART_Port *port, int data_bits, char parity, int stop_bits)
+{
+	static const tcflag_t sizes[] = { CS5, CS6, CS7, CS8 };
+	struct termios tio;
+
+	if (NULL == port || data_bits < 5 || data_bits > 8 || stop_bits < 1 || stop_bits > 2 ||
+	    ('N' != parity && 'E' != parity && 'O' != parity) || tcgetattr(port->fd, &tio))
+		return(-1);
+
+	tio.c_cflag &= ~(CSIZE | PARENB | PARODD | CSTOPB);
+	tio.c_cflag |= sizes[data_bits - 5];
+	tio.c_iflag &= ~INPCK;
+	if ('N' != parity) {
+		tio.c_cflag |= PARENB;
+		tio.c_iflag |= INPCK;
+	}
+	if ('O' == parity)
+		tio.c_cflag |= PARODD;
+	if (2 == stop_bits)
+		tio.c_cflag |= CSTOPB;
+
+	if (tcsetattr(port->fd, TCSANOW, &tio)) {
+		fprintf(stderr, "Failed to set %s format!\n", port->device);
+		return(-1);
+	}
+
+	return(0);
+}
+
+/**
+  * @brief  Waits for the port and moves data between it and the rings.
+  * @param  port: serial port
+  * @param  timeout_ms: -1 waits forever, 0 only does pending I/O
+  * @retval Bytes received, 0 on timeout, -1 on error
+  */
+int
+UARTPoll(UART_Port *port, int timeout_ms)
+{
+	struct epoll_event ev;
+	ssize_t received = 0;
+	int n;
+
+	if (NULL == port)
+		return(-1);
+
+	n = epoll_wait(port->epfd, &ev, 1, timeout_ms);
+	if (-1 == n) {
+		if (EINTR == errno)
+			return(0);
+		fprintf(stderr, "Failed to wait for %s!\n", port->device);
+		return(-1);
+	}
+	if (0 == n)
+		return(0);
+
+	if (ev.events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+		received = UARTReceive(port);
+		if (-1 == received)
+			return(-1);
+
+		/* a hang-up stays signalled, it cannot wait for a full ring to drain */
+		if (0 == received && (ev.events & (EPOLLERR | EPOLLHUP))) {
+			fprintf(stderr, "%s hung up!\n", port->device);
+			return(-1);
+		}
+	}
+
+	if (ev.events & EPOLLOUT) {
+		if (UARTTransmit(port))
+			return(-1);
+	}
+
+	if (UARTUpdateEvents(port))
+		return(-1);
+
+	return((int)received);
+}
+
+/**
+  * @brief  Sends data, queueing what the port cannot take yet.
+  * @param  port: serial port
+  * @param  data: bytes to send
+  * @param  len: number of bytes
+  * @retval Bytes accepted (less than len if the TX ring is full), -1 on error
+  */
+ssize_t
+UARTWrite(UART_Port *port, const void *data, size_t len)
+{
+	const uint8_t *src = data;
+	UART_Ring *tx;
+	struct iovec iov[2];
+	size_t done = 0;
+	size_t room;
+	ssize_t n;
+	int cnt;
+	int i;
+
+	if (NULL == port || (NULL == data && len > 0))
+		return(-1);
+
+	tx = &port->tx;
+
+	/* nothing queued: straight to the driver, order is kept */
+	if (tx->head == tx->tail && len > 0) {
+		do {
+			n = write(port->fd, src, len);
+		} while (-1 == n && EINTR == errno);
+
+		if (n > 0) {
+			done = n;
+			port->stats.tx_bytes += n;
+		} else if (-1 == n && EAGAIN != errno && EWOULDBLOCK != errno) {
+			fprintf(stderr, "Failed to write %s!\n", port->device);
+			return(-1);
+		}
+	}
+
+	room = tx->size - (tx->head - tx->tail);
+	if (len - done > room) {
+		port->stats.tx_full += len - done - room;
+		len = done + room;
+	}
+
+	cnt = UARTRingSegments(tx, tx->head, (uint32_t)(len - done), iov);
+	for (i = 0; i < cnt; i++) {
+		memcpy(iov[i].iov_base, src + done, iov[i].iov_len);
+		done += iov[i].iov_len;
+		tx->head += iov[i].iov_len;
+	}
+
+	if (cnt > 0 && UARTUpdateEvents(port))
+		return(-1);
+
+	return((ssize_t)done);
+}
+
+/**
+  * @brief  Copies received bytes out of the RX ring.
+  * @retval Bytes copied, 0 if none are buffered, -1 on error
+  */
+ssize_t
+UARTRead(UART_Port *port, void *data, size_t len)
+{
+	uint8_t *dst = data;
+	struct iovec iov[2];
+	size_t avail;
+	size_t done = 0;
+	int cnt;
+	int i;
+
+	if (NULL == port || NULL == data)
+		return(-1);
+
+	avail = port->rx.head - port->rx.tail;
+	if (len > avail)
+		len = avail;
+
+	cnt = UARTRingSegments(&port->rx, port->rx.tail, (uint32_t)len, iov);
+	for (i = 0; i < cnt; i++) {
+		memcpy(dst + done, iov[i].iov_base, iov[i].iov_len);
+		done += iov[i].iov_len;
+	}
+
+	UARTRxConsume(port, done);
+	return((ssize_t)done);
+}
+
+/**
+  * @brief  Gives direct access to the received bytes, oldest first.
+  * @param  port: serial port
+  * @param  seg1, len1: first contiguous piece
+  * @param  seg2, len2: second piece where the ring wraps, len2 0 if none
+  * @retval Bytes available (len1 + len2), valid until UARTRxConsume() or UARTPoll()
+  */
+size_t
+UARTRxPeek(UART_Port *port, const uint8_t **seg1, size_t *len1,
+	   const uint8_t **seg2, size_t *len2)
+{
+	struct iovec iov[2];
+	uint32_t avail;
+	int cnt;
+
+	avail = port->rx.head - port->rx.tail;
+	cnt = UARTRingSegments(&port->rx, port->rx.tail, avail, iov);
+
+	*seg1 = (cnt > 0) ? iov[0].iov_base : port->rx.data;
+	*len1 = (cnt > 0) ? iov[0].iov_len : 0;
+	*seg2 = port->rx.data;
+	*len2 = (cnt > 1) ? iov[1].iov_len : 0;
+	return(avail);
+}
+
+/**
+  * @brief  Releases bytes seen through UARTRxPeek().
+  */
+void
+UARTRxConsume(UART_Port *port, size_t len)
+{
+	size_t avail = port->rx.head - port->rx.tail;
+
+	if (len > avail)
+		len = avail;
+	port->rx.tail += len;
+
+	/* reception was paused on a full ring */
+	if (len > 0 && !(port->events & EPOLLIN))
+		UARTUpdateEvents(port);
+}
+
+size_t
+UARTRxAvailable(const UART_Port *port)
+{
+	return(port->rx.head - port->rx.tail);
+}
+
+size_t
+UARTTxPending(const UART_Port *port)
+{
+	return(port->tx.head - port->tx.tail);
+}
+
+/**
+  * @brief  Bytes not on the wire yet: TX ring plus the driver's queue.
+  * @retval Byte count, -1 on error
+  */
+int
+UARTOutQueue(UART_Port *port)
+{
+	int queued = 0;
+
+	if (NULL == port)
+		return(-1);
+
+	if (ioctl(port->fd, TIOCOUTQ, &queued))
+		queued = 0;
+
+	return(queued + (int)UARTTxPending(port));
+}
+
+/**
+  * @brief  Runs the port until the TX ring is handed to the driver.
+  * @param  port: serial port
+  * @param  timeout_ms: -1 waits as long as it takes
+  * @retval Bytes still queued (0 when done), -1 on error
+  */
+int
+UARTDrain(UART_Port *port, int timeout_ms)
+{
+	struct timespec now;
+	int64_t deadline = 0;
+	int64_t left;
+	int wait = timeout_ms;
+
+	if (NULL == port)
+		return(-1);
+
+	if (timeout_ms >= 0) {
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		deadline = (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000 + timeout_ms;
+	}
+
+	while (UARTTxPending(port) > 0) {
+		if (UARTPoll(port, wait) < 0)
+			return(-1);
+
+		if (timeout_ms >= 0) {
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			left = deadline - ((int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000);
+			if (left <= 0)
+				break;
+			wait = (int)left;
+		}
+	}
+
+	return((int)UARTTxPending(port));
+}
+
+/**
+  * @brief  epoll fd of the port, readable when UARTPoll() has work.
+  */
+int
+UARTFd(const UART_Port *port)
+{
+	return(NULL != port ? port->epfd : -1);
+}
+
+/**
+  * @brief  Copies the counters, with the driver's line error counts if it has them.
+  */
+void
+UARTGetStats(UART_Port *port, UART_Stats *stats)
+{
+	struct serial_icounter_struct icount;
+
+	if (NULL == port || NULL == stats)
+		return;
+
+	memset(&icount, 0, sizeof(icount));
+	if (0 == ioctl(port->fd, TIOCGICOUNT, &icount)) {
+		port->stats.overruns = icount.overrun + icount.buf_overrun;
+		port->stats.frame_errors = icount.frame;
+		port->stats.parity_errors = icount.parity;
+	}
+
+	*stats = port->stats;
+}
+
+void
+UARTClose(UART_Port *port)
+{
+	if (NULL == port)
+		return;
+
+	if (-1 != port->fd) {
+		tcsetattr(port->fd, TCSANOW, &port->saved);
+		close(port->fd);
+	}
+	if (-1 != port->epfd)
+		close(port->epfd);
+	free(port->rx.data);
+	free(port->tx.data);
+	free(port);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    uart.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the
+  *          event driven UART engine.
+  *
+  * @details Provides the following functionality:
+  *          - Non-blocking raw serial ports opened at run time
+  *          - epoll driven reception into an RX ring
+  *          - TX queueing with writev() batching
+  *          - Zero-copy access to received bytes
+  *          - Line error and ring full statistics
+  ******************************************************************************
+  * @defgroup UART UART Engine
+  * @brief Port, ring buffers and statistics
+  * @{
+  */
+
+#ifndef __UART_H
+#define __UART_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <termios.h>
+
+#define UART_DEVICE_MAX		64
+#define UART_RING_DEFAULT	65536	/* bytes, rounded up to a power of two */
+
+typedef struct {
+	uint8_t *data;
+	uint32_t size;		/* power of two */
+	uint32_t mask;
+	uint32_t head;		/* next byte written, free running */
+	uint32_t tail;		/* next byte read, free running */
+} UART_Ring;
+
+typedef struct {
+	uint64_t rx_bytes;
+	uint64_t tx_bytes;
+	uint64_t rx_full;	/* times reception paused on a full RX ring */
+	uint64_t tx_full;	/* bytes refused by UARTWrite() on a full TX ring */
+	uint32_t rx_high_water;	/* highest RX ring fill level seen */
+	uint32_t overruns;	/* lost in the driver, if it counts them (TIOCGICOUNT) */
+	uint32_t frame_errors;
+	uint32_t parity_errors;
+} UART_Stats;
+
+typedef struct {
+	int fd;
+	int epfd;		/* polls fd alone, pollable itself */
+	uint32_t events;	/* EPOLL* bits registered for fd */
+	char device[UART_DEVICE_MAX];
+	int baud;
+	UART_Ring rx;
+	UART_Ring tx;
+	UART_Stats stats;
+	struct termios saved;	/* restored on close */
+} UART_Port;
+
+/** @} */
+
+extern UART_Port *UARTOpen(const char *device, int baud, size_t rx_size, size_t tx_size);
+extern int UARTSetBaud(UART_Port *port, int baud);
+extern int UARTSetFormat(UART_Port *port, int data_bits, char parity, int stop_bits);
+extern int UARTPoll(UART_Port *port, int timeout_ms);
+extern ssize_t UARTWrite(UART_Port *port, const void *data, size_t len);
+extern ssize_t UARTRead(UART_Port *port, void *data, size_t len);
+extern size_t UARTRxPeek(UART_Port *port, const uint8_t **seg1, size_t *len1,
+			 const uint8_t **seg2, size_t *len2);
+extern void UARTRxConsume(UART_Port *port, size_t len);
+extern size_t UARTRxAvailable(const UART_Port *port);
+extern size_t UARTTxPending(const UART_Port *port);
+extern int UARTOutQueue(UART_Port *port);
+extern int UARTDrain(UART_Port *port, int timeout_ms);
+extern int UARTFd(const UART_Port *port);
+extern void UARTGetStats(UART_Port *port, UART_Stats *stats);
+extern void UARTClose(UART_Port *port);
+
+
+#endif /*__UART_H */
@@ -0,0 +1,553 @@
+/**
+  ******************************************************************************
+  * @file    uart_framing.c
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file provides binary framing on top of the UART engine:
+  *           - COBS or SLIP encoding of outgoing frames
+  *           - Incremental decoding of received bytes, in place in the RX
+  *             ring
+  *           - CRC-16 or CRC-32 frame check computed while decoding
+  *           - Frames handed out as views into the RX ring
+  *
+  *  @verbatim
+  *
+  *          ===================================================================
+  *                             Working of the Framing Layer
+  *          ===================================================================
+  *
+  *          Frame Format
+  *          =====================
+  *          - payload | CRC (little endian) encoded with COBS, then a 0x00
+  *            delimiter; or with SLIP between 0xC0 delimiters
+  *          - CRC-16 is the Modbus / IBM CRC (0x8005 reflected, init
+  *            0xFFFF), CRC-32 the IEEE 802.3 / zlib CRC
+  *          - Empty frames only exist with a CRC; back-to-back delimiters
+  *            are skipped
+  *
+  *          Decoding
+  *          =======================
+  *          - UARTFrameNext() walks only the bytes received since the last
+  *            call; a frame split over many reads is never rescanned
+  *          - Decoded bytes are written back into the RX ring behind the
+  *            read position (a decoded frame is never longer than its
+  *            encoding), so the payload ends up contiguous in the ring
+  *            and is handed out as a view of one or two segments (two
+  *            when it wraps around the end of the ring)
+  *          - The CRC runs over each byte as it is decoded; over payload
+  *            and CRC together it ends at a fixed residue, so the end of
+  *            the payload does not need to be known in advance
+  *          - Frames with a bad CRC, bad escape, or longer than max_frame
+  *            are dropped and counted; the decoder picks up again at the
+  *            next delimiter
+  *          - The view stays valid until the next UARTFrameNext() call,
+  *            which releases the frame's bytes to the RX ring
+  *
+  *          CRC
+  *          =======================
+  *          - Byte-wise table lookups while decoding, slicing-by-4 tables
+  *            for whole buffers when encoding
+  *          - On ARMv8 with the CRC extension (-march=armv8-a+crc) CRC-32
+  *            uses the crc32b/crc32w instructions instead
+  *          - Tables are built once, on the first framer
+  *
+  *          ===================================================================
+  *                              How to use this driver
+  *          ===================================================================
+  *            - Include "uart_framing.h" in your application
+  *            - Open the port with UARTOpen(), then create the framer
+  *            - Call UARTPoll(), then UARTFrameNext() until it returns 0
+  *            - Send with UARTFrameSend()
+  *            - Compile with: gcc -O2 uart.c uart_framing.c your_app.c
+  *
+  *          Example Usage:
+  *            UART_Port *port = UARTOpen("/dev/ttySC3", 921600, 0, 0);
+  *            UART_Framer *fr = UARTFramerCreate(port, UART_FRAME_COBS, UART_CRC16, 0);
+  *            UART_FrameView v;
+  *
+  *            while (UARTPoll(port, -1) >= 0) {
+  *                while (UARTFrameNext(fr, &v) > 0)
+  *                    handle(v.seg1, v.len1, v.seg2, v.len2);
+  *            }
+  *
+  *  @endverbatim
+  *
+  ******************************************************************************
+  *
+  * <h2><center>&copy; COPYRIGHT 2025 Calixto Systems Pvt Ltd</center></h2>
+  ******************************************************************************
+  */
+
+#include <endian.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "uart_framing.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#define SLIP_END		0xC0
+#define SLIP_ESC		0xDB
+#define SLIP_ESC_END		0xDC
+#define SLIP_ESC_ESC		0xDD
+
+#define CRC32_RESIDUE		0xDEBB20E3	/* register after payload and its CRC-32 */
+
+static uint16_t s_crc16[256];
+static uint32_t s_crc32[4][256];
+static int s_crc_init;
+
+static void
+UARTCrcInit(void)
+{
+	uint32_t c;
+	int i;
+	int k;
+
+	if (s_crc_init)
+		return;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+		for (k = 0; k < 8; k++)
+			c = (c & 1) ? (c >> 1) ^ 0xA001 : c >> 1;
+		s_crc16[i] = (uint16_t)c;
+
+		c = i;
+		for (k = 0; k < 8; k++)
+			c = (c & 1) ? (c >> 1) ^ 0xEDB88320 : c >> 1;
+		s_crc32[0][i] = c;
+	}
+
+	/* slicing-by-4: entry [k][i] is byte i followed by k zero bytes */
+	for (i = 0; i < 256; i++) {
+		for (k = 1; k < 4; k++)
+			s_crc32[k][i] = (s_crc32[k - 1][i] >> 8) ^ s_crc32[0][s_crc32[k - 1][i] & 0xFF];
+	}
+
+	s_crc_init = 1;
+}
+
+static inline uint32_t
+UARTCrc32Byte(uint32_t reg, uint8_t b)
+{
+#if defined(__ARM_FEATURE_CRC32)
+	return(__crc32b(reg, b));
+#else
+	return((reg >> 8) ^ s_crc32[0][(reg ^ b) & 0xFF]);
+#endif
+}
+
+/**
+  * @brief  CRC-16/MODBUS of a buffer.
+  * @param  crc: UART_CRC16_INIT, or the result for the preceding bytes
+  * @retval CRC, sent low byte first
+  */
+uint16_t
+UARTCrc16(uint16_t crc, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+
+	UARTCrcInit();
+	while (len--)
+		crc = (crc >> 8) ^ s_crc16[(crc ^ *p++) & 0xFF];
+
+	return(crc);
+}
+
+/**
+  * @brief  CRC-32 of a buffer, zlib convention.
+  * @param  crc: 0, or the result for the preceding bytes
+  * @retval CRC, sent low byte first
+  */
+uint32_t
+UARTCrc32(uint32_t crc, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	uint32_t reg = ~crc;
+	uint32_t word;
+
+	UARTCrcInit();
+
+	for (; len >= 4; len -= 4, p += 4) {
+		memcpy(&word, p, sizeof(word));
+#if defined(__ARM_FEATURE_CRC32)
+		reg = __crc32w(reg, le32toh(word));
+#else
+		reg ^= le32toh(word);
+		reg = s_crc32[3][reg & 0xFF] ^ s_crc32[2][(reg >> 8) & 0xFF] ^
+		      s_crc32[1][(reg >> 16) & 0xFF] ^ s_crc32[0][reg >> 24];
+#endif
+	}
+
+	while (len--)
+		reg = UARTCrc32Byte(reg, *p++);
+
+	return(~reg);
+}
+
+/**
+  * @brief  Name of the CRC-32 implementation: "armv8-crc" or "table".
+  */
+const char *
+UARTCrcKernel(void)
+{
+#if defined(__ARM_FEATURE_CRC32)
+	return("armv8-crc");
+#else
+	return("table");
+#endif
+}
+
+/* worst case encoded size of len bytes (payload and CRC), delimiters included */
+static size_t
+UARTFrameEncodedMax(int mode, size_t len)
+{
+	if (UART_FRAME_COBS == mode)
+		return(len + len / 254 + 2);
+
+	return(2 * len + 2);
+}
+
+static void
+UARTFrameReset(UART_Framer *fr)
+{
+	fr->len = 0;
+	fr->left = 0;
+	fr->zero = 0;
+	fr->escape = 0;
+	fr->bad = 0;
+	fr->check = (UART_CRC32 == fr->crc) ? 0xFFFFFFFF : UART_CRC16_INIT;
+}
+
+/* no decoded byte to keep: give the RX ring everything walked so far */
+static void
+UARTFrameSkip(UART_Framer *fr)
+{
+	UARTRxConsume(fr->port, fr->in - fr->port->rx.tail);
+	fr->out = fr->in;
+}
+
+/**
+  * @brief  Creates a framer on an open port.
+  * @param  port: serial port, its RX ring is read by the framer only
+  * @param  mode: UART_FRAME_COBS or UART_FRAME_SLIP
+  * @param  crc: UART_CRC_NONE, UART_CRC16 or UART_CRC32
+  * @param  max_frame: payload limit in bytes, 0 for UART_FRAME_MAX
+  * @retval Framer, NULL on error
+  */
+UART_Framer *
+UARTFramerCreate(UART_Port *port, int mode, int crc, size_t max_frame)
+{
+	UART_Framer *fr;
+	size_t enc;
+
+	if (NULL == port || (UART_FRAME_COBS != mode && UART_FRAME_SLIP != mode) ||
+	    (UART_CRC_NONE != crc && UART_CRC16 != crc && UART_CRC32 != crc)) {
+		fprintf(stderr, "Invalid framing setup!\n");
+		return(NULL);
+	}
+
+	if (0 == max_frame)
+		max_frame = UART_FRAME_MAX;
+	enc = UARTFrameEncodedMax(mode, max_frame + crc);
+	if (enc > port->rx.size || enc > port->tx.size) {
+		fprintf(stderr, "UART rings too small for %zu byte frames!\n", max_frame);
+		return(NULL);
+	}
+
+	fr = calloc(1, sizeof(*fr));
+	if (NULL == fr)
+		return(NULL);
+
+	fr->tx = malloc(enc);
+	if (NULL == fr->tx) {
+		free(fr);
+		return(NULL);
+	}
+
+	UARTCrcInit();
+	fr->port = port;
+	fr->mode = mode;
+	fr->crc = crc;
+	fr->max_frame = max_frame;
+	fr->tx_size = enc;
+	fr->in = port->rx.tail;
+	fr->out = port->rx.tail;
+	UARTFrameReset(fr);
+
+	return(fr);
+}
+
+/**
+  * @brief  Encodes a payload with its CRC and queues it on the port.
+  * @param  fr: framer
+  * @param  payload: frame contents
+  * @param  len: payload bytes, at most max_frame
+  * @retval 0 on success, -1 with errno EAGAIN if the TX ring has no room
+  *         for the whole frame, -1 on error
+  */
+int
+UARTFrameSend(UART_Framer *fr, const void *payload, size_t len)
+{
+	const uint8_t *span[2];
+	size_t span_len[2];
+	uint8_t check[4];
+	uint8_t *o;
+	uint8_t *code_pos;
+	uint8_t code = 1;
+	uint32_t crc = 0;
+	size_t i;
+	int s;
+
+	if (NULL == fr || (NULL == payload && len > 0) || len > fr->max_frame)
+		return(-1);
+
+	/* without a CRC an empty frame is just two delimiters, which the decoder skips */
+	if (0 == len && UART_CRC_NONE == fr->crc)
+		return(-1);
+
+	if (UART_CRC16 == fr->crc)
+		crc = UARTCrc16(UART_CRC16_INIT, payload, len);
+	else if (UART_CRC32 == fr->crc)
+		crc = UARTCrc32(0, payload, len);
+	check[0] = crc & 0xFF;
+	check[1] = (crc >> 8) & 0xFF;
+	check[2] = (crc >> 16) & 0xFF;
+	check[3] = (crc >> 24) & 0xFF;
+
+	span[0] = payload;
+	span_len[0] = len;
+	span[1] = check;
+	span_len[1] = fr->crc;
+
+	o = fr->tx;
+	if (UART_FRAME_COBS == fr->mode) {
+		code_pos = o++;
+		for (s = 0; s < 2; s++) {
+			for (i = 0; i < span_len[s]; i++) {
+				if (0 == span[s][i]) {
+					*code_pos = code;
+					code_pos = o++;
+					code = 1;
+					continue;
+				}
+				*o++ = span[s][i];
+				if (0xFF == ++code) {
+					*code_pos = code;
+					code_pos = o++;
+					code = 1;
+				}
+			}
+		}
+		*code_pos = code;
+		*o++ = 0x00;
+	} else {
+		/* the leading END ends any line noise received before the frame */
+		*o++ = SLIP_END;
+		for (s = 0; s < 2; s++) {
+			for (i = 0; i < span_len[s]; i++) {
+				if (SLIP_END == span[s][i]) {
+					*o++ = SLIP_ESC;
+					*o++ = SLIP_ESC_END;
+				} else if (SLIP_ESC == span[s][i]) {
+					*o++ = SLIP_ESC;
+					*o++ = SLIP_ESC_ESC;
+				} else {
+					*o++ = span[s][i];
+				}
+			}
+		}
+		*o++ = SLIP_END;
+	}
+
+	/* a frame is queued whole or not at all */
+	if ((size_t)(o - fr->tx) > fr->port->tx.size - UARTTxPending(fr->port)) {
+		errno = EAGAIN;
+		return(-1);
+	}
+
+	return((UARTWrite(fr->port, fr->tx, o - fr->tx) == o - fr->tx) ? 0 : -1);
+}
+
+static inline void
+UARTFrameEmit(UART_Framer *fr, uint8_t *ring, uint32_t mask, uint8_t b)
+{
+	if (fr->bad)
+		return;
+
+	if (fr->len == fr->max_frame + fr->crc) {
+		fr->stats.oversize++;
+		fr->bad = 1;
+		return;
+	}
+
+	ring[fr->out & mask] = b;
+	fr->out++;
+	fr->len++;
+
+	if (UART_CRC16 == fr->crc)
+		fr->check = (fr->check >> 8) ^ s_crc16[(fr->check ^ b) & 0xFF];
+	else if (UART_CRC32 == fr->crc)
+		fr->check = UARTCrc32Byte(fr->check, b);
+}
+
+/* frame ended at a delimiter: 1 if it is handed out */
+static int
+UARTFrameEnd(UART_Framer *fr, UART_FrameView *view)
+{
+	UART_Ring *rx = &fr->port->rx;
+	uint32_t start;
+	uint32_t pos;
+	size_t len;
+	int good;
+
+	if (fr->bad || 0 == fr->len) {
+		UARTFrameReset(fr);
+		UARTFrameSkip(fr);
+		return(0);
+	}
+
+	if (fr->left > 0 || fr->escape || fr->len < (uint32_t)fr->crc) {
+		fr->stats.framing_errors++;
+		good = 0;
+	} else if (UART_CRC16 == fr->crc) {
+		good = (0 == fr->check);
+	} else if (UART_CRC32 == fr->crc) {
+		good = (CRC32_RESIDUE == fr->check);
+	} else {
+		good = 1;
+	}
+
+	if (!good) {
+		if (0 == fr->left && !fr->escape && fr->len >= (uint32_t)fr->crc)
+			fr->stats.crc_errors++;
+		UARTFrameReset(fr);
+		UARTFrameSkip(fr);
+		return(0);
+	}
+
+	start = fr->out - fr->len;
+	len = fr->len - fr->crc;
+	pos = start & rx->mask;
+
+	view->len = len;
+	view->seg1 = rx->data + pos;
+	view->len1 = (len <= rx->size - pos) ? len : rx->size - pos;
+	view->seg2 = rx->data;
+	view->len2 = len - view->len1;
+
+	/* the bytes up to the delimiter go back to the ring on the next call */
+	fr->release = fr->in - rx->tail;
+	fr->out = fr->in;
+	fr->stats.frames++;
+	UARTFrameReset(fr);
+	return(1);
+}
+
+/**
+  * @brief  Decodes the bytes received so far and returns the next good frame.
+  * @param  fr: framer
+  * @param  view: payload of the frame, valid until the next call
+  * @retval 1 for a frame, 0 if no complete frame is buffered, -1 on error
+  */
+int
+UARTFrameNext(UART_Framer *fr, UART_FrameView *view)
+{
+	UART_Ring *rx;
+	uint8_t *ring;
+	uint32_t mask;
+	uint32_t head;
+	uint8_t b;
+
+	if (NULL == fr || NULL == view)
+		return(-1);
+
+	rx = &fr->port->rx;
+	ring = rx->data;
+	mask = rx->mask;
+
+	if (fr->release) {
+		UARTRxConsume(fr->port, fr->release);
+		fr->release = 0;
+	}
+
+	head = rx->head;
+	while (fr->in != head) {
+		b = ring[fr->in & mask];
+		fr->in++;
+
+		if (UART_FRAME_COBS == fr->mode) {
+			if (0x00 == b) {
+				if (UARTFrameEnd(fr, view))
+					return(1);
+			} else if (0 == fr->left) {
+				/* code byte: the previous block's implied zero, then b - 1 data bytes */
+				if (fr->zero)
+					UARTFrameEmit(fr, ring, mask, 0x00);
+				fr->left = b - 1;
+				fr->zero = (0xFF != b);
+			} else {
+				UARTFrameEmit(fr, ring, mask, b);
+				fr->left--;
+			}
+			continue;
+		}
+
+		if (SLIP_END == b) {
+			if (UARTFrameEnd(fr, view))
+				return(1);
+		} else if (fr->escape) {
+			fr->escape = 0;
+			if (SLIP_ESC_END == b) {
+				UARTFrameEmit(fr, ring, mask, SLIP_END);
+			} else if (SLIP_ESC_ESC == b) {
+				UARTFrameEmit(fr, ring, mask, SLIP_ESC);
+			} else if (!fr->bad) {
+				fr->stats.framing_errors++;
+				fr->bad = 1;
+			}
+		} else if (SLIP_ESC == b) {
+			fr->escape = 1;
+		} else {
+			UARTFrameEmit(fr, ring, mask, b);
+		}
+	}
+
+	/* nothing decoded worth keeping: do not hold the ring */
+	if (fr->bad || 0 == fr->len)
+		UARTFrameSkip(fr);
+
+	return(0);
+}
+
+/**
+  * @brief  Copies the payload of a view into a contiguous buffer.
+  * @retval Bytes copied
+  */
+size_t
+UARTFrameCopy(const UART_FrameView *view, void *buf, size_t size)
+{
+	size_t n1 = (view->len1 < size) ? view->len1 : size;
+	size_t n2 = (view->len2 < size - n1) ? view->len2 : size - n1;
+
+	memcpy(buf, view->seg1, n1);
+	memcpy((uint8_t *)buf + n1, view->seg2, n2);
+	return(n1 + n2);
+}
+
+void
+UARTFramerDestroy(UART_Framer *fr)
+{
+	if (NULL == fr)
+		return;
+
+	free(fr->tx);
+	free(fr);
+}
+
+/************** (C) COPYRIGHT 2025 Calixto Systems Pvt Ltd *****END OF FILE****/
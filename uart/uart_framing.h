@@ -0,0 +1,85 @@
+/**
+  ******************************************************************************
+  * @file    uart_framing.h
+  * @author  Name, Calixto Firmware Team
+  * @version V1.0.0
+  * @date    4-June-2025
+  * @brief   This file contains all the functions prototypes for the UART
+  *          binary framing layer.
+  *
+  * @details Provides the following functionality:
+  *          - COBS and SLIP frame encoding and decoding
+  *          - CRC-16 and CRC-32 frame check, computed as bytes arrive
+  *          - Received frames as views into the RX ring, no copy
+  *          - Table driven CRC, ARMv8 CRC32 instructions where present
+  ******************************************************************************
+  * @defgroup UART_Framing UART Framing
+  * @brief Framer state and frame views
+  * @{
+  */
+
+#ifndef __UART_FRAMING_H
+#define __UART_FRAMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "uart.h"
+
+#define UART_FRAME_COBS		0	/* 0x00 delimited, Consistent Overhead Byte Stuffing */
+#define UART_FRAME_SLIP		1	/* RFC 1055, 0xC0 delimited */
+
+#define UART_CRC_NONE		0
+#define UART_CRC16		2	/* CRC-16/MODBUS: poly 0x8005 reflected, init 0xFFFF */
+#define UART_CRC32		4	/* CRC-32 (IEEE 802.3, zlib) */
+
+#define UART_CRC16_INIT		0xFFFF
+#define UART_FRAME_MAX		4096	/* default payload limit */
+
+typedef struct {
+	const uint8_t *seg1;	/* payload, CRC removed */
+	size_t len1;
+	const uint8_t *seg2;	/* rest of the payload where the ring wraps */
+	size_t len2;
+	size_t len;		/* len1 + len2 */
+} UART_FrameView;
+
+typedef struct {
+	uint64_t frames;	/* good frames handed out */
+	uint64_t crc_errors;
+	uint64_t framing_errors;	/* bad escapes, truncated COBS blocks, runt frames */
+	uint64_t oversize;	/* frames longer than max_frame, dropped */
+} UART_FrameStats;
+
+typedef struct {
+	UART_Port *port;
+	int mode;		/* UART_FRAME_COBS or UART_FRAME_SLIP */
+	int crc;		/* UART_CRC_NONE, UART_CRC16 or UART_CRC32 */
+	size_t max_frame;	/* payload bytes */
+	/* decoder, positions in the RX ring (free running) */
+	uint32_t in;		/* next encoded byte */
+	uint32_t out;		/* next decoded byte, written in place behind in */
+	uint32_t len;		/* decoded bytes of the current frame */
+	int left;		/* COBS: bytes left in the block, 0 = code byte next */
+	int zero;		/* COBS: the block ends with an implied zero */
+	int escape;		/* SLIP: last byte was ESC */
+	int bad;		/* current frame is dropped up to the delimiter */
+	uint32_t check;		/* running CRC of the decoded bytes */
+	uint32_t release;	/* RX bytes to consume on the next call */
+	uint8_t *tx;		/* encode buffer */
+	size_t tx_size;
+	UART_FrameStats stats;
+} UART_Framer;
+
+/** @} */
+
+extern UART_Framer *UARTFramerCreate(UART_Port *port, int mode, int crc, size_t max_frame);
+extern int UARTFrameSend(UART_Framer *fr, const void *payload, size_t len);
+extern int UARTFrameNext(UART_Framer *fr, UART_FrameView *view);
+extern size_t UARTFrameCopy(const UART_FrameView *view, void *buf, size_t size);
+extern void UARTFramerDestroy(UART_Framer *fr);
+extern uint16_t UARTCrc16(uint16_t crc, const void *data, size_t len);
+extern uint32_t UARTCrc32(uint32_t crc, const void *data, size_t len);
+extern const char *UARTCrcKernel(void);
+
+
+#endif /*__UART_FRAMING_H */